@@ -0,0 +1,15 @@
+#include "unity.h"
+void test_InitializeDCL2Pthreads(void);
+void test_ConnectNoLink(void);
+void test_ConnectFlawlessLink(void);
+void test_ConnectDropInRequest(void);
+void test_ConnectDropInResponse(void);
+int main(void) {
+  unity_cur_file = "test/dcl2-integration/test_InitAndConnect.c";
+  unity_run(test_InitializeDCL2Pthreads, "test_InitializeDCL2Pthreads", 21);
+  unity_run(test_ConnectNoLink, "test_ConnectNoLink", 36);
+  unity_run(test_ConnectFlawlessLink, "test_ConnectFlawlessLink", 52);
+  unity_run(test_ConnectDropInRequest, "test_ConnectDropInRequest", 69);
+  unity_run(test_ConnectDropInResponse, "test_ConnectDropInResponse", 90);
+  return unity_end();
+}
@@ -0,0 +1,39 @@
+#include "unity.h"
+void test_SendMessageDropInMsg(void);
+void test_SendMessageDropInAck(void);
+void test_Send1000MessagesOverDroppyTx(void);
+void test_Send1000HugeMessagesOverDroppyRx(void);
+void test_Send1000MessagesOverNoisyCorruptingDroppyTx(void);
+void test_Send1000HugeMessagesOverNoisyCorruptingDroppyRx(void);
+void test_Send1000MessagesWindowedOverNoisyCorruptingDroppyLink(void);
+void test_Send1000MessagesVectoredOverDroppyLink(void);
+void test_Send1000MessagesWaitingForThemOverDroppyLink(void);
+void test_Send1000MessagesThroughRxRingOverDroppyLink(void);
+void test_Send1000MessagesThroughTxQueueOverDroppyLink(void);
+void test_Send1000MessagesWithEarlyAckOverDroppyLink(void);
+void test_Send1000MessagesWithEarlyAckSelectiveOverDroppyLink(void);
+void test_SendJumboMessagesWithCrc32OverCorruptingTx(void);
+void test_Send1000MessagesSelectiveRejectOverNoisyCorruptingDroppyLink(void);
+void test_Send1000MessagesToCallbackOverNoisyCorruptingDroppyLink(void);
+void test_Send1000MessagesAsyncOverNoisyCorruptingDroppyLink(void);
+int main(void) {
+  unity_cur_file = "test/dcl2-integration/test_TransceiveFaultyLink.c";
+  unity_run(test_SendMessageDropInMsg, "test_SendMessageDropInMsg", 12);
+  unity_run(test_SendMessageDropInAck, "test_SendMessageDropInAck", 24);
+  unity_run(test_Send1000MessagesOverDroppyTx, "test_Send1000MessagesOverDroppyTx", 36);
+  unity_run(test_Send1000HugeMessagesOverDroppyRx, "test_Send1000HugeMessagesOverDroppyRx", 46);
+  unity_run(test_Send1000MessagesOverNoisyCorruptingDroppyTx, "test_Send1000MessagesOverNoisyCorruptingDroppyTx", 56);
+  unity_run(test_Send1000HugeMessagesOverNoisyCorruptingDroppyRx, "test_Send1000HugeMessagesOverNoisyCorruptingDroppyRx", 68);
+  unity_run(test_Send1000MessagesWindowedOverNoisyCorruptingDroppyLink, "test_Send1000MessagesWindowedOverNoisyCorruptingDroppyLink", 80);
+  unity_run(test_Send1000MessagesVectoredOverDroppyLink, "test_Send1000MessagesVectoredOverDroppyLink", 95);
+  unity_run(test_Send1000MessagesWaitingForThemOverDroppyLink, "test_Send1000MessagesWaitingForThemOverDroppyLink", 106);
+  unity_run(test_Send1000MessagesThroughRxRingOverDroppyLink, "test_Send1000MessagesThroughRxRingOverDroppyLink", 119);
+  unity_run(test_Send1000MessagesThroughTxQueueOverDroppyLink, "test_Send1000MessagesThroughTxQueueOverDroppyLink", 133);
+  unity_run(test_Send1000MessagesWithEarlyAckOverDroppyLink, "test_Send1000MessagesWithEarlyAckOverDroppyLink", 144);
+  unity_run(test_Send1000MessagesWithEarlyAckSelectiveOverDroppyLink, "test_Send1000MessagesWithEarlyAckSelectiveOverDroppyLink", 157);
+  unity_run(test_SendJumboMessagesWithCrc32OverCorruptingTx, "test_SendJumboMessagesWithCrc32OverCorruptingTx", 168);
+  unity_run(test_Send1000MessagesSelectiveRejectOverNoisyCorruptingDroppyLink, "test_Send1000MessagesSelectiveRejectOverNoisyCorruptingDroppyLink", 181);
+  unity_run(test_Send1000MessagesToCallbackOverNoisyCorruptingDroppyLink, "test_Send1000MessagesToCallbackOverNoisyCorruptingDroppyLink", 196);
+  unity_run(test_Send1000MessagesAsyncOverNoisyCorruptingDroppyLink, "test_Send1000MessagesAsyncOverNoisyCorruptingDroppyLink", 210);
+  return unity_end();
+}
@@ -0,0 +1,43 @@
+#include "unity.h"
+void test_SendMessage(void);
+void test_Send1000HugeMessagesUnidirectional(void);
+void test_Send1000HugeMessagesWindowed(void);
+void test_Send1000HugeMessagesWindowedExtended(void);
+void test_Send1000HugeMessagesVectored(void);
+void test_Send1000HugeMessagesThroughRxRing(void);
+void test_Send1000HugeMessagesThroughTxQueue(void);
+void test_SlowConsumerDoesNotResetLink(void);
+void test_SlowConsumerWithEarlyAckDoesNotResetLink(void);
+void test_Send1000HugeMessagesWithEarlyAck(void);
+void test_Send1000HugeMessagesWaitingForThem(void);
+void test_SendJumboMessagesWithCrc32(void);
+void test_WritevFdWritesAllSegments(void);
+void test_EventFdSignalsLinkEvents(void);
+void test_EpollRuntimeServesLinks(void);
+void test_Send1000HugeMessagesToCallback(void);
+void test_RequestResponse(void);
+void test_RequestResponsePiggybackedAcks(void);
+void test_Send1000MessagesAsync(void);
+int main(void) {
+  unity_cur_file = "test/dcl2-integration/test_TransceiveFlawlessLink.c";
+  unity_run(test_SendMessage, "test_SendMessage", 15);
+  unity_run(test_Send1000HugeMessagesUnidirectional, "test_Send1000HugeMessagesUnidirectional", 23);
+  unity_run(test_Send1000HugeMessagesWindowed, "test_Send1000HugeMessagesWindowed", 31);
+  unity_run(test_Send1000HugeMessagesWindowedExtended, "test_Send1000HugeMessagesWindowedExtended", 38);
+  unity_run(test_Send1000HugeMessagesVectored, "test_Send1000HugeMessagesVectored", 47);
+  unity_run(test_Send1000HugeMessagesThroughRxRing, "test_Send1000HugeMessagesThroughRxRing", 55);
+  unity_run(test_Send1000HugeMessagesThroughTxQueue, "test_Send1000HugeMessagesThroughTxQueue", 63);
+  unity_run(test_SlowConsumerDoesNotResetLink, "test_SlowConsumerDoesNotResetLink", 71);
+  unity_run(test_SlowConsumerWithEarlyAckDoesNotResetLink, "test_SlowConsumerWithEarlyAckDoesNotResetLink", 80);
+  unity_run(test_Send1000HugeMessagesWithEarlyAck, "test_Send1000HugeMessagesWithEarlyAck", 88);
+  unity_run(test_Send1000HugeMessagesWaitingForThem, "test_Send1000HugeMessagesWaitingForThem", 96);
+  unity_run(test_SendJumboMessagesWithCrc32, "test_SendJumboMessagesWithCrc32", 104);
+  unity_run(test_WritevFdWritesAllSegments, "test_WritevFdWritesAllSegments", 112);
+  unity_run(test_EventFdSignalsLinkEvents, "test_EventFdSignalsLinkEvents", 156);
+  unity_run(test_EpollRuntimeServesLinks, "test_EpollRuntimeServesLinks", 211);
+  unity_run(test_Send1000HugeMessagesToCallback, "test_Send1000HugeMessagesToCallback", 271);
+  unity_run(test_RequestResponse, "test_RequestResponse", 278);
+  unity_run(test_RequestResponsePiggybackedAcks, "test_RequestResponsePiggybackedAcks", 285);
+  unity_run(test_Send1000MessagesAsync, "test_Send1000MessagesAsync", 292);
+  return unity_end();
+}
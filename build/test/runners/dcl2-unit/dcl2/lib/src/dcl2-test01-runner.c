@@ -0,0 +1,101 @@
+#include "unity.h"
+void test_ValidInit(void);
+void test_InvalidInit(void);
+void test_InitInvalidConfig(void);
+void test_InitCustomConfig(void);
+void test_InitCrc32Config(void);
+void test_InvalidConnectionParams(void);
+void test_ValidConnection(void);
+void test_ConnectionNoResponse(void);
+void test_ConnectionNoOpWhenConnected(void);
+void test_ConnectionFailWhenAlreadyConnecting(void);
+void test_disconnectWhenDisconnected(void);
+void test_disconnectWhenConnecting(void);
+void test_disconnectWhenConnected(void);
+void test_SendMessageInvalidParams(void);
+void test_SendMessageInvalidState(void);
+void test_SendMessageWithAcknowledgment(void);
+void test_SendMessageWhenNacked(void);
+void test_SendMessageScatterGather(void);
+void test_SendMessageWhenTimeout(void);
+void test_SendMessageFailTooManyNacks(void);
+void test_SendMessageFailTooManyTimeouts(void);
+void test_SendMessageOtherStationDropsLink(void);
+void test_SetWindowSizeInvalidParams(void);
+void test_SendMessageWindowed(void);
+void test_SendMessageFragmented(void);
+void test_FlushRetransmitsWholeWindowOnTimeout(void);
+void test_FlushWhenNotConnected(void);
+void test_SelectiveRejectLimitsWindow(void);
+void test_GetMessageDisconnectedLink(void);
+void test_GetMessageNoMessagePending(void);
+void test_GetMessageInvalidParams(void);
+void test_GetMessage(void);
+void test_GetMessageDelayedAck(void);
+void test_SendMessagePiggybacksPendingAck(void);
+void test_WaitMessageInvalidParams(void);
+void test_WaitMessagePendingMessage(void);
+void test_WaitMessageWokenUpByMessage(void);
+void test_WaitMessageTimeout(void);
+void test_WaitMessageLinkReset(void);
+void test_SendMessageAsyncInvalidParams(void);
+void test_SendMessageAsyncCompletesOnAck(void);
+void test_TickRetransmitsAndResetsLink(void);
+void test_TickTransmitsPendingAck(void);
+void test_DisconnectCompletesAsyncMessages(void);
+void test_RttEstimateInvalidParams(void);
+void test_RttMeasuredFromSendToAck(void);
+void test_RttNotMeasuredForRetransmittedFrames(void);
+void test_SendMessageBacksOffRetransmitTimeout(void);
+int main(void) {
+  unity_cur_file = "test/dcl2-unit/dcl2/lib/src/dcl2-test01.c";
+  unity_run(test_ValidInit, "test_ValidInit", 30);
+  unity_run(test_InvalidInit, "test_InvalidInit", 48);
+  unity_run(test_InitInvalidConfig, "test_InitInvalidConfig", 54);
+  unity_run(test_InitCustomConfig, "test_InitCustomConfig", 89);
+  unity_run(test_InitCrc32Config, "test_InitCrc32Config", 138);
+  unity_run(test_InvalidConnectionParams, "test_InvalidConnectionParams", 170);
+  unity_run(test_ValidConnection, "test_ValidConnection", 176);
+  unity_run(test_ConnectionNoResponse, "test_ConnectionNoResponse", 231);
+  unity_run(test_ConnectionNoOpWhenConnected, "test_ConnectionNoOpWhenConnected", 265);
+  unity_run(test_ConnectionFailWhenAlreadyConnecting, "test_ConnectionFailWhenAlreadyConnecting", 291);
+  unity_run(test_disconnectWhenDisconnected, "test_disconnectWhenDisconnected", 316);
+  unity_run(test_disconnectWhenConnecting, "test_disconnectWhenConnecting", 336);
+  unity_run(test_disconnectWhenConnected, "test_disconnectWhenConnected", 359);
+  unity_run(test_SendMessageInvalidParams, "test_SendMessageInvalidParams", 385);
+  unity_run(test_SendMessageInvalidState, "test_SendMessageInvalidState", 424);
+  unity_run(test_SendMessageWithAcknowledgment, "test_SendMessageWithAcknowledgment", 466);
+  unity_run(test_SendMessageWhenNacked, "test_SendMessageWhenNacked", 537);
+  unity_run(test_SendMessageScatterGather, "test_SendMessageScatterGather", 608);
+  unity_run(test_SendMessageWhenTimeout, "test_SendMessageWhenTimeout", 657);
+  unity_run(test_SendMessageFailTooManyNacks, "test_SendMessageFailTooManyNacks", 729);
+  unity_run(test_SendMessageFailTooManyTimeouts, "test_SendMessageFailTooManyTimeouts", 782);
+  unity_run(test_SendMessageOtherStationDropsLink, "test_SendMessageOtherStationDropsLink", 836);
+  unity_run(test_SetWindowSizeInvalidParams, "test_SetWindowSizeInvalidParams", 883);
+  unity_run(test_SendMessageWindowed, "test_SendMessageWindowed", 898);
+  unity_run(test_SendMessageFragmented, "test_SendMessageFragmented", 952);
+  unity_run(test_FlushRetransmitsWholeWindowOnTimeout, "test_FlushRetransmitsWholeWindowOnTimeout", 993);
+  unity_run(test_FlushWhenNotConnected, "test_FlushWhenNotConnected", 1038);
+  unity_run(test_SelectiveRejectLimitsWindow, "test_SelectiveRejectLimitsWindow", 1051);
+  unity_run(test_GetMessageDisconnectedLink, "test_GetMessageDisconnectedLink", 1079);
+  unity_run(test_GetMessageNoMessagePending, "test_GetMessageNoMessagePending", 1095);
+  unity_run(test_GetMessageInvalidParams, "test_GetMessageInvalidParams", 1113);
+  unity_run(test_GetMessage, "test_GetMessage", 1131);
+  unity_run(test_GetMessageDelayedAck, "test_GetMessageDelayedAck", 1181);
+  unity_run(test_SendMessagePiggybacksPendingAck, "test_SendMessagePiggybacksPendingAck", 1223);
+  unity_run(test_WaitMessageInvalidParams, "test_WaitMessageInvalidParams", 1262);
+  unity_run(test_WaitMessagePendingMessage, "test_WaitMessagePendingMessage", 1289);
+  unity_run(test_WaitMessageWokenUpByMessage, "test_WaitMessageWokenUpByMessage", 1325);
+  unity_run(test_WaitMessageTimeout, "test_WaitMessageTimeout", 1368);
+  unity_run(test_WaitMessageLinkReset, "test_WaitMessageLinkReset", 1397);
+  unity_run(test_SendMessageAsyncInvalidParams, "test_SendMessageAsyncInvalidParams", 1442);
+  unity_run(test_SendMessageAsyncCompletesOnAck, "test_SendMessageAsyncCompletesOnAck", 1462);
+  unity_run(test_TickRetransmitsAndResetsLink, "test_TickRetransmitsAndResetsLink", 1518);
+  unity_run(test_TickTransmitsPendingAck, "test_TickTransmitsPendingAck", 1566);
+  unity_run(test_DisconnectCompletesAsyncMessages, "test_DisconnectCompletesAsyncMessages", 1594);
+  unity_run(test_RttEstimateInvalidParams, "test_RttEstimateInvalidParams", 1619);
+  unity_run(test_RttMeasuredFromSendToAck, "test_RttMeasuredFromSendToAck", 1645);
+  unity_run(test_RttNotMeasuredForRetransmittedFrames, "test_RttNotMeasuredForRetransmittedFrames", 1711);
+  unity_run(test_SendMessageBacksOffRetransmitTimeout, "test_SendMessageBacksOffRetransmitTimeout", 1764);
+  return unity_end();
+}
@@ -0,0 +1,129 @@
+#include "unity.h"
+void test_PDInvalidParams(void);
+void test_PDFailsOnYahdlcFailure(void);
+void test_PDProcessesWholeBuffer(void);
+void test_PDProcessDataWhenDisconnected(void);
+void test_PDProcessAckWhenDisconnected(void);
+void test_PDProcessNackWhenDisconnected(void);
+void test_PDProcessConnWhenDisconnected(void);
+void test_PDConnAckTransmittedFromLookupTable(void);
+void test_PDProcessConnAckWhenDisconnected(void);
+void test_PDProcessDataWhenConnecting(void);
+void test_PDProcessAckWhenConnecting(void);
+void test_PDProcessNackWhenConnecting(void);
+void test_PDProcessConnWhenConnecting(void);
+void test_PDProcessConnAckWhenConnecting(void);
+void test_PDProcessAckWhenConnected(void);
+void test_PDProcessNackWhenConnected(void);
+void test_PDProcessConnWhenConnected(void);
+void test_PDProcessConnAckWhenConnected(void);
+void test_PDProcessAckWhenTransmitting(void);
+void test_PDProcessNackWhenTransmitting(void);
+void test_PDProcessConnWhenTransmitting(void);
+void test_PDProcessConnAckWhenTransmitting(void);
+void test_PDDataCorrectSeq(void);
+void test_PDDataAlreadySeenNotAcked(void);
+void test_PDDataAlreadySeenAndAcked(void);
+void test_PDDataReceiveWithoutAck(void);
+void test_PDDataIncorrectSeq(void);
+void test_PDDataRejectedAgainWhenGoneBack(void);
+void test_PDCorruptedFrameRejected(void);
+void test_PDCorruptedFrameIgnoredWhenDisconnected(void);
+void test_PDProcessCumulativeAck(void);
+void test_PDProcessNackWhenConnectedRetransmits(void);
+void test_PDDataDiscardedFrameIsRejected(void);
+void test_PDProcessExtendedConnWhenDisconnected(void);
+void test_PDProcessConnAckSetsRequestedMode(void);
+void test_PDProcessCumulativeAckExtended(void);
+void test_PDDataExtendedSeq(void);
+void test_PDDataPiggybackedAck(void);
+void test_PDDataPiggybackedAckNothingNew(void);
+void test_PDDataAlreadyAckedWhileMessageQueued(void);
+void test_PDDataSignalsReceiveCondvar(void);
+void test_PDDataDeliveredToCallback(void);
+void test_PDDataCallbackKeepsOrderOfQueuedMessages(void);
+void test_PDDataFragmentsReassembled(void);
+void test_PDDataFragmentedMessageTooLong(void);
+void test_PDDataSelectiveReject(void);
+void test_PDDataSelectiveRejectAgainWhenGoneBack(void);
+void test_PDDataSelectiveRejectFallsBackToReject(void);
+void test_PDProcessSrejRetransmitsFrame(void);
+void test_PDProcessRnrPausesRetransmissions(void);
+void test_PDProcessNackAfterRnrIsNoFailure(void);
+void test_PDDataAckedRightAwayAfterRnr(void);
+void test_PDDataEarlyAck(void);
+void test_PDDataEarlyAckRejectsRightAway(void);
+void test_PDDataEarlyAckFullQueueIsNotReady(void);
+void test_PDEventsNotified(void);
+void test_RxRingInvalidParams(void);
+void test_RxRingDrainedInPlace(void);
+void test_RxRingDiscardsBytesWhenFull(void);
+void test_TxQueueInvalidParams(void);
+void test_TxQueueAckTransmittedBeforeData(void);
+void test_TxQueueRetransmissions(void);
+int main(void) {
+  unity_cur_file = "test/dcl2-unit/dcl2/lib/src/dcl2-test02.c";
+  unity_run(test_PDInvalidParams, "test_PDInvalidParams", 89);
+  unity_run(test_PDFailsOnYahdlcFailure, "test_PDFailsOnYahdlcFailure", 103);
+  unity_run(test_PDProcessesWholeBuffer, "test_PDProcessesWholeBuffer", 128);
+  unity_run(test_PDProcessDataWhenDisconnected, "test_PDProcessDataWhenDisconnected", 158);
+  unity_run(test_PDProcessAckWhenDisconnected, "test_PDProcessAckWhenDisconnected", 175);
+  unity_run(test_PDProcessNackWhenDisconnected, "test_PDProcessNackWhenDisconnected", 192);
+  unity_run(test_PDProcessConnWhenDisconnected, "test_PDProcessConnWhenDisconnected", 209);
+  unity_run(test_PDConnAckTransmittedFromLookupTable, "test_PDConnAckTransmittedFromLookupTable", 235);
+  unity_run(test_PDProcessConnAckWhenDisconnected, "test_PDProcessConnAckWhenDisconnected", 264);
+  unity_run(test_PDProcessDataWhenConnecting, "test_PDProcessDataWhenConnecting", 283);
+  unity_run(test_PDProcessAckWhenConnecting, "test_PDProcessAckWhenConnecting", 305);
+  unity_run(test_PDProcessNackWhenConnecting, "test_PDProcessNackWhenConnecting", 327);
+  unity_run(test_PDProcessConnWhenConnecting, "test_PDProcessConnWhenConnecting", 349);
+  unity_run(test_PDProcessConnAckWhenConnecting, "test_PDProcessConnAckWhenConnecting", 380);
+  unity_run(test_PDProcessAckWhenConnected, "test_PDProcessAckWhenConnected", 403);
+  unity_run(test_PDProcessNackWhenConnected, "test_PDProcessNackWhenConnected", 425);
+  unity_run(test_PDProcessConnWhenConnected, "test_PDProcessConnWhenConnected", 447);
+  unity_run(test_PDProcessConnAckWhenConnected, "test_PDProcessConnAckWhenConnected", 479);
+  unity_run(test_PDProcessAckWhenTransmitting, "test_PDProcessAckWhenTransmitting", 500);
+  unity_run(test_PDProcessNackWhenTransmitting, "test_PDProcessNackWhenTransmitting", 523);
+  unity_run(test_PDProcessConnWhenTransmitting, "test_PDProcessConnWhenTransmitting", 544);
+  unity_run(test_PDProcessConnAckWhenTransmitting, "test_PDProcessConnAckWhenTransmitting", 577);
+  unity_run(test_PDDataCorrectSeq, "test_PDDataCorrectSeq", 599);
+  unity_run(test_PDDataAlreadySeenNotAcked, "test_PDDataAlreadySeenNotAcked", 636);
+  unity_run(test_PDDataAlreadySeenAndAcked, "test_PDDataAlreadySeenAndAcked", 680);
+  unity_run(test_PDDataReceiveWithoutAck, "test_PDDataReceiveWithoutAck", 729);
+  unity_run(test_PDDataIncorrectSeq, "test_PDDataIncorrectSeq", 819);
+  unity_run(test_PDDataRejectedAgainWhenGoneBack, "test_PDDataRejectedAgainWhenGoneBack", 872);
+  unity_run(test_PDCorruptedFrameRejected, "test_PDCorruptedFrameRejected", 921);
+  unity_run(test_PDCorruptedFrameIgnoredWhenDisconnected, "test_PDCorruptedFrameIgnoredWhenDisconnected", 996);
+  unity_run(test_PDProcessCumulativeAck, "test_PDProcessCumulativeAck", 1022);
+  unity_run(test_PDProcessNackWhenConnectedRetransmits, "test_PDProcessNackWhenConnectedRetransmits", 1060);
+  unity_run(test_PDDataDiscardedFrameIsRejected, "test_PDDataDiscardedFrameIsRejected", 1087);
+  unity_run(test_PDProcessExtendedConnWhenDisconnected, "test_PDProcessExtendedConnWhenDisconnected", 1169);
+  unity_run(test_PDProcessConnAckSetsRequestedMode, "test_PDProcessConnAckSetsRequestedMode", 1193);
+  unity_run(test_PDProcessCumulativeAckExtended, "test_PDProcessCumulativeAckExtended", 1212);
+  unity_run(test_PDDataExtendedSeq, "test_PDDataExtendedSeq", 1233);
+  unity_run(test_PDDataPiggybackedAck, "test_PDDataPiggybackedAck", 1282);
+  unity_run(test_PDDataPiggybackedAckNothingNew, "test_PDDataPiggybackedAckNothingNew", 1320);
+  unity_run(test_PDDataAlreadyAckedWhileMessageQueued, "test_PDDataAlreadyAckedWhileMessageQueued", 1355);
+  unity_run(test_PDDataSignalsReceiveCondvar, "test_PDDataSignalsReceiveCondvar", 1398);
+  unity_run(test_PDDataDeliveredToCallback, "test_PDDataDeliveredToCallback", 1437);
+  unity_run(test_PDDataCallbackKeepsOrderOfQueuedMessages, "test_PDDataCallbackKeepsOrderOfQueuedMessages", 1496);
+  unity_run(test_PDDataFragmentsReassembled, "test_PDDataFragmentsReassembled", 1542);
+  unity_run(test_PDDataFragmentedMessageTooLong, "test_PDDataFragmentedMessageTooLong", 1617);
+  unity_run(test_PDDataSelectiveReject, "test_PDDataSelectiveReject", 1663);
+  unity_run(test_PDDataSelectiveRejectAgainWhenGoneBack, "test_PDDataSelectiveRejectAgainWhenGoneBack", 1739);
+  unity_run(test_PDDataSelectiveRejectFallsBackToReject, "test_PDDataSelectiveRejectFallsBackToReject", 1788);
+  unity_run(test_PDProcessSrejRetransmitsFrame, "test_PDProcessSrejRetransmitsFrame", 1821);
+  unity_run(test_PDProcessRnrPausesRetransmissions, "test_PDProcessRnrPausesRetransmissions", 1869);
+  unity_run(test_PDProcessNackAfterRnrIsNoFailure, "test_PDProcessNackAfterRnrIsNoFailure", 1933);
+  unity_run(test_PDDataAckedRightAwayAfterRnr, "test_PDDataAckedRightAwayAfterRnr", 1987);
+  unity_run(test_PDDataEarlyAck, "test_PDDataEarlyAck", 2017);
+  unity_run(test_PDDataEarlyAckRejectsRightAway, "test_PDDataEarlyAckRejectsRightAway", 2052);
+  unity_run(test_PDDataEarlyAckFullQueueIsNotReady, "test_PDDataEarlyAckFullQueueIsNotReady", 2096);
+  unity_run(test_PDEventsNotified, "test_PDEventsNotified", 2150);
+  unity_run(test_RxRingInvalidParams, "test_RxRingInvalidParams", 2212);
+  unity_run(test_RxRingDrainedInPlace, "test_RxRingDrainedInPlace", 2244);
+  unity_run(test_RxRingDiscardsBytesWhenFull, "test_RxRingDiscardsBytesWhenFull", 2298);
+  unity_run(test_TxQueueInvalidParams, "test_TxQueueInvalidParams", 2338);
+  unity_run(test_TxQueueAckTransmittedBeforeData, "test_TxQueueAckTransmittedBeforeData", 2359);
+  unity_run(test_TxQueueRetransmissions, "test_TxQueueRetransmissions", 2414);
+  return unity_end();
+}
@@ -0,0 +1,57 @@
+#include "unity.h"
+void test_FrameDataInvalidInputs(void);
+void test_GetDataInvalidInputs(void);
+void test_DataFrameControlField(void);
+void test_AckFrameControlField(void);
+void test_NackFrameControlField(void);
+void test_SrejFrameControlField(void);
+void test_RnrFrameControlField(void);
+void test_ExtendedDataFrameControlField(void);
+void test_DataFrameMoreFragments(void);
+void test_ExtendedSupervisoryFrameControlField(void);
+void test_ConnFrameModes(void);
+void test_0To512BytesData(void);
+void test_5BytesFrame(void);
+void test_EndFlagSequenceInNewBuffer(void);
+void test_FlagSequenceAndControlEscapeInData(void);
+void test_getDataFromMultipleBuffers(void);
+void test_MultipleFramesWithSingleFlagSequence(void);
+void test_MultipleFramesWithDoubleFlagSequence(void);
+void test_FramesWithBitErrors(void);
+void test_ControlBytesAroundBlockBoundaries(void);
+void test_FcsBufSameAsFcs(void);
+void test_Fcs32(void);
+void test_Fcs32Frames(void);
+void test_FrameLookupSameAsFrameData(void);
+void test_FrameDataVecInvalidInputs(void);
+void test_FrameDataVecSameAsFrameData(void);
+int main(void) {
+  unity_cur_file = "test/dcl2-unit/dcl2/lib/src/yahdlc-test01.c";
+  unity_run(test_FrameDataInvalidInputs, "test_FrameDataInvalidInputs", 11);
+  unity_run(test_GetDataInvalidInputs, "test_GetDataInvalidInputs", 39);
+  unity_run(test_DataFrameControlField, "test_DataFrameControlField", 51);
+  unity_run(test_AckFrameControlField, "test_AckFrameControlField", 89);
+  unity_run(test_NackFrameControlField, "test_NackFrameControlField", 122);
+  unity_run(test_SrejFrameControlField, "test_SrejFrameControlField", 156);
+  unity_run(test_RnrFrameControlField, "test_RnrFrameControlField", 182);
+  unity_run(test_ExtendedDataFrameControlField, "test_ExtendedDataFrameControlField", 208);
+  unity_run(test_DataFrameMoreFragments, "test_DataFrameMoreFragments", 248);
+  unity_run(test_ExtendedSupervisoryFrameControlField, "test_ExtendedSupervisoryFrameControlField", 286);
+  unity_run(test_ConnFrameModes, "test_ConnFrameModes", 317);
+  unity_run(test_0To512BytesData, "test_0To512BytesData", 364);
+  unity_run(test_5BytesFrame, "test_5BytesFrame", 412);
+  unity_run(test_EndFlagSequenceInNewBuffer, "test_EndFlagSequenceInNewBuffer", 434);
+  unity_run(test_FlagSequenceAndControlEscapeInData, "test_FlagSequenceAndControlEscapeInData", 474);
+  unity_run(test_getDataFromMultipleBuffers, "test_getDataFromMultipleBuffers", 504);
+  unity_run(test_MultipleFramesWithSingleFlagSequence, "test_MultipleFramesWithSingleFlagSequence", 550);
+  unity_run(test_MultipleFramesWithDoubleFlagSequence, "test_MultipleFramesWithDoubleFlagSequence", 603);
+  unity_run(test_FramesWithBitErrors, "test_FramesWithBitErrors", 654);
+  unity_run(test_ControlBytesAroundBlockBoundaries, "test_ControlBytesAroundBlockBoundaries", 692);
+  unity_run(test_FcsBufSameAsFcs, "test_FcsBufSameAsFcs", 739);
+  unity_run(test_Fcs32, "test_Fcs32", 758);
+  unity_run(test_Fcs32Frames, "test_Fcs32Frames", 770);
+  unity_run(test_FrameLookupSameAsFrameData, "test_FrameLookupSameAsFrameData", 824);
+  unity_run(test_FrameDataVecInvalidInputs, "test_FrameDataVecInvalidInputs", 887);
+  unity_run(test_FrameDataVecSameAsFrameData, "test_FrameDataVecSameAsFrameData", 903);
+  return unity_end();
+}
@@ -0,0 +1,13 @@
+#include "unity.h"
+void test_ConnFrameControlField(void);
+void test_ConnAckFrameControlField(void);
+void test_GetDataOfTooBigFrame(void);
+void test_GetDataOfTooBigFrameMultipleBuffers(void);
+int main(void) {
+  unity_cur_file = "test/dcl2-unit/dcl2/lib/src/yahdlc-test02.c";
+  unity_run(test_ConnFrameControlField, "test_ConnFrameControlField", 11);
+  unity_run(test_ConnAckFrameControlField, "test_ConnAckFrameControlField", 39);
+  unity_run(test_GetDataOfTooBigFrame, "test_GetDataOfTooBigFrame", 67);
+  unity_run(test_GetDataOfTooBigFrameMultipleBuffers, "test_GetDataOfTooBigFrameMultipleBuffers", 103);
+  return unity_end();
+}
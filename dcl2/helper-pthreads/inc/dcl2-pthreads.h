@@ -22,10 +22,18 @@ extern DeadcomL2ThreadingMethods pthreadsDeadcom;
  * takes both condvar and mutex. This structure is used in place of mutex type to carry both.
  */
 
+typedef struct dcl2_pthread_tx_worker dcl2_pthread_tx_worker_t;
+
 typedef struct {
     pthread_cond_t  *cond;
     pthread_mutex_t *mutx;
     volatile bool wakeup_is_spurious;
+    // Storage of the link allocated by dcPthreadsInitConfig, if any
+    void *storage;
+    // Transmit thread started by dcPthreadsStartTxWorker, if any
+    dcl2_pthread_tx_worker_t *tx_worker;
+    // Descriptor created by dcPthreadsEventFd, -1 if none
+    int event_fd;
 } dcl2_pthread_cond_t;
 
 
@@ -34,19 +42,89 @@ typedef struct {
  *
  * This function is a wrapper around `dcInit`. It passes through all arguments to dcInit.
  * Additionally, it dynamically allocates objects representing a mutex and condvar suitable for
- * use with `pthreadsDeadcom` (threading VMT) defined by this library.
+ * use with `pthreadsDeadcom` (threading VMT) defined by this library, and a receive condvar so that
+ * dcWaitMessage can be used (see dcSetReceiveCondvar).
  *
- * All present params and return values are the same as `dcInit`
+ * All present params and return values are the same as `dcInit`. The link uses the default
+ * configuration (see dcDefaultConfig), its storage is allocated dynamically as well.
  */
 DeadcomL2Result dcPthreadsInit(DeadcomL2 *deadcom,
                                bool (*transmitBytes)(const uint8_t*, size_t, void*),
                                void *transmissionContext);
 
 
+/**
+ * Initialize an object representing a DeadCom link suitable for use with pthreads, with custom
+ * configuration.
+ *
+ * Same as `dcPthreadsInit`, but the link uses configuration `config` (NULL means the default
+ * configuration). If the configuration does not supply any storage, it is allocated dynamically
+ * according to the other parameters.
+ */
+DeadcomL2Result dcPthreadsInitConfig(DeadcomL2 *deadcom, const DeadcomL2Config *config,
+                                     bool (*transmitBytes)(const uint8_t*, size_t, void*),
+                                     void *transmissionContext);
+
+
+/**
+ * transmitBytes function writing to a file descriptor (such as a serial port), pointed to by the
+ * transmission context (`int*`). Retries interrupted and partial writes.
+ */
+bool dcPthreadsWriteFd(const uint8_t *bytes, size_t len, void *fd_p);
+
+
+/**
+ * Function for dcSetTransmitVec writing segments to a file descriptor with `writev`, pointed to by
+ * the transmission context (`int*`), so it can be used together with dcPthreadsWriteFd. Retries
+ * interrupted and partial writes.
+ */
+bool dcPthreadsWritevFd(const yahdlc_iovec_t *iov, size_t iov_count, void *fd_p);
+
+
+/**
+ * Transmit frames of a DeadCom link from a dedicated thread.
+ *
+ * Switches the link (initialized by dcPthreadsInit or dcPthreadsInitConfig) to queued
+ * transmission (see dcSetTransmitQueue) and starts a thread which calls dcTransmitPending whenever
+ * frames are waiting, so that dcProcessData and the other calls never block on transmitBytes. Call
+ * this before connecting. The thread is stopped by dcPthreadsFree.
+ *
+ * @retval DC_OK  The thread was started
+ * @retval DC_FAILURE  The thread is already running, or it could not be started
+ */
+DeadcomL2Result dcPthreadsStartTxWorker(DeadcomL2 *deadcom);
+
+
+/**
+ * Get a file descriptor which becomes readable when the link needs attention.
+ *
+ * The descriptor (an `eventfd`) is created on the first call and signalled on every event of the
+ * link (see dcSetEventCallback): a message was received, a message was acknowledged, or the link
+ * was connected or disconnected. So a single thread can `poll` or `epoll_wait` on many links (and
+ * any other descriptors) at once. Once the descriptor is readable, clear it by
+ * dcPthreadsClearEventFd first and then serve the link, e.g. pick up all pending messages with
+ * dcGetReceivedMsg and check the link state, so that no event is missed. The descriptor is
+ * readable right after it is created. It is closed by dcPthreadsFree.
+ *
+ * @return The descriptor, or -1 if it could not be created
+ */
+int dcPthreadsEventFd(DeadcomL2 *deadcom);
+
+
+/**
+ * Clear the descriptor returned by dcPthreadsEventFd, so that it is not readable until the next
+ * event of the link.
+ *
+ * @return false if the descriptor could not be read
+ */
+bool dcPthreadsClearEventFd(DeadcomL2 *deadcom);
+
+
 /**
  * Free pthread objects in DeadCom link.
  *
- * This function deallocates all memory allocated by dcPthreadsInit on the given deadcom link.
+ * This function stops the transmit thread, if any, and deallocates all memory allocated by
+ * dcPthreadsInit (or dcPthreadsInitConfig) on the given deadcom link.
  */
 void dcPthreadsFree(DeadcomL2 *deadcom);
 
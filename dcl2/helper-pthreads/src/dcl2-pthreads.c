@@ -1,5 +1,9 @@
+#include <sys/eventfd.h>
 #include <sys/time.h>
+#include <sys/uio.h>
+#include <errno.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "dcl2-pthreads.h"
 
 
@@ -67,34 +71,257 @@ bool dcl_pthreads_condvarSignal(void *condvar_p) {
 }
 
 
+uint32_t dcl_pthreads_getTimeMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+
 DeadcomL2ThreadingMethods pthreadsDeadcom = {
     .mutexInit     = &dcl_pthreads_mutexInit,
     .mutexLock     = &dcl_pthreads_mutexLock,
     .mutexUnlock   = &dcl_pthreads_mutexUnlock,
     .condvarInit   = &dcl_pthreads_condvarInit,
     .condvarWait   = &dcl_pthreads_condvarWait,
-    .condvarSignal = &dcl_pthreads_condvarSignal
+    .condvarSignal = &dcl_pthreads_condvarSignal,
+    .getTimeMs     = &dcl_pthreads_getTimeMs
 };
 
 
-DeadcomL2Result dcPthreadsInit(DeadcomL2 *deadcom,
-                               bool (*transmitBytes)(const uint8_t*, size_t, void*),
-                               void *transmissionContext) {
+DeadcomL2Result dcPthreadsInitConfig(DeadcomL2 *deadcom, const DeadcomL2Config *config,
+                                     bool (*transmitBytes)(const uint8_t*, size_t, void*),
+                                     void *transmissionContext) {
+    DeadcomL2Config c;
+    if (config != NULL) {
+        c = *config;
+    } else {
+        dcDefaultConfig(&c);
+    }
+
     pthread_mutex_t *mutx = malloc(sizeof(pthread_mutex_t));
     pthread_cond_t  *cond = malloc(sizeof(pthread_cond_t));
     dcl2_pthread_cond_t *combined_cond = malloc(sizeof(dcl2_pthread_cond_t));
 
     combined_cond->mutx = mutx;
     combined_cond->cond = cond;
+    combined_cond->storage = NULL;
+    combined_cond->tx_worker = NULL;
+    combined_cond->event_fd = -1;
+    if (c.storage == NULL) {
+        c.storage_len = DEADCOM_STORAGE_SIZE(c.max_payload_len, c.window_slots, c.rx_queue_slots);
+        c.storage = combined_cond->storage = malloc(c.storage_len);
+    }
+
+    DeadcomL2Result result = dcInit(deadcom, mutx, combined_cond, &pthreadsDeadcom, transmitBytes,
+                                    transmissionContext, &c);
+    if (result != DC_OK) {
+        return result;
+    }
+
+    // dcWaitMessage waits on its own condvar, sharing the mutex of the link
+    dcl2_pthread_cond_t *rx_cond = malloc(sizeof(dcl2_pthread_cond_t));
+    rx_cond->mutx = mutx;
+    rx_cond->cond = malloc(sizeof(pthread_cond_t));
+    rx_cond->storage = NULL;
+    rx_cond->tx_worker = NULL;
+    rx_cond->event_fd = -1;
+    return dcSetReceiveCondvar(deadcom, rx_cond);
+}
+
+
+DeadcomL2Result dcPthreadsInit(DeadcomL2 *deadcom,
+                               bool (*transmitBytes)(const uint8_t*, size_t, void*),
+                               void *transmissionContext) {
+    return dcPthreadsInitConfig(deadcom, NULL, transmitBytes, transmissionContext);
+}
+
+
+bool dcPthreadsWriteFd(const uint8_t *bytes, size_t len, void *fd_p) {
+    int fd = *(int*) fd_p;
+    while (len > 0) {
+        ssize_t written = write(fd, bytes, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        len -= written;
+    }
+    return true;
+}
+
+
+bool dcPthreadsWritevFd(const yahdlc_iovec_t *iov, size_t iov_count, void *fd_p) {
+    int fd = *(int*) fd_p;
+    struct iovec v[YAHDLC_IOV_MAX];
+    while (iov_count > 0) {
+        size_t batch = (iov_count < YAHDLC_IOV_MAX) ? iov_count : YAHDLC_IOV_MAX;
+        for (size_t i = 0; i < batch; i++) {
+            v[i].iov_base = (void*) iov[i].base;
+            v[i].iov_len = iov[i].len;
+        }
+
+        // Write the batch, continuing after partial writes from the first unwritten byte
+        struct iovec *next = v;
+        size_t n = batch;
+        while (n > 0) {
+            ssize_t written = writev(fd, next, n);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            while (n > 0 && (size_t)written >= next->iov_len) {
+                written -= next->iov_len;
+                next++;
+                n--;
+            }
+            if (n > 0) {
+                next->iov_base = (uint8_t*) next->iov_base + written;
+                next->iov_len -= written;
+            }
+        }
+
+        iov += batch;
+        iov_count -= batch;
+    }
+    return true;
+}
 
-    return dcInit(deadcom, mutx, combined_cond, &pthreadsDeadcom, transmitBytes,
-                  transmissionContext);
+
+struct dcl2_pthread_tx_worker {
+    DeadcomL2 *deadcom;
+    pthread_t thread;
+    pthread_mutex_t mutx;
+    pthread_cond_t cond;
+    // Are frames waiting for dcTransmitPending? Should the thread exit?
+    bool pending;
+    bool stop;
+};
+
+
+static void dcl_pthreads_txNotify(void *context) {
+    dcl2_pthread_tx_worker_t *w = context;
+    pthread_mutex_lock(&w->mutx);
+    w->pending = true;
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->mutx);
+}
+
+
+static void *dcl_pthreads_txWorker(void *context) {
+    dcl2_pthread_tx_worker_t *w = context;
+    pthread_mutex_lock(&w->mutx);
+    while (!w->stop) {
+        if (!w->pending) {
+            pthread_cond_wait(&w->cond, &w->mutx);
+            continue;
+        }
+        w->pending = false;
+        pthread_mutex_unlock(&w->mutx);
+        // If transmission fails, the remaining frames are retried once more frames are queued,
+        // and the protocol recovers from the lost ones by retransmission
+        dcTransmitPending(w->deadcom);
+        pthread_mutex_lock(&w->mutx);
+    }
+    pthread_mutex_unlock(&w->mutx);
+    return NULL;
+}
+
+
+DeadcomL2Result dcPthreadsStartTxWorker(DeadcomL2 *deadcom) {
+    dcl2_pthread_cond_t *combined_cond = deadcom->condvar_p;
+    if (combined_cond->tx_worker != NULL) {
+        return DC_FAILURE;
+    }
+
+    dcl2_pthread_tx_worker_t *w = malloc(sizeof(dcl2_pthread_tx_worker_t));
+    w->deadcom = deadcom;
+    w->pending = false;
+    w->stop = false;
+    pthread_mutex_init(&w->mutx, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    if (pthread_create(&w->thread, NULL, dcl_pthreads_txWorker, w) != 0) {
+        pthread_cond_destroy(&w->cond);
+        pthread_mutex_destroy(&w->mutx);
+        free(w);
+        return DC_FAILURE;
+    }
+    combined_cond->tx_worker = w;
+    return dcSetTransmitQueue(deadcom, dcl_pthreads_txNotify, w);
+}
+
+
+static void dcl_pthreads_eventNotify(void *context) {
+    dcl2_pthread_cond_t *combined_cond = context;
+    uint64_t one = 1;
+    // Only fails if the counter would overflow, the descriptor is readable then anyway
+    ssize_t written = write(combined_cond->event_fd, &one, sizeof(one));
+    (void) written;
+}
+
+
+int dcPthreadsEventFd(DeadcomL2 *deadcom) {
+    dcl2_pthread_cond_t *combined_cond = deadcom->condvar_p;
+    if (combined_cond->event_fd >= 0) {
+        return combined_cond->event_fd;
+    }
+
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    combined_cond->event_fd = fd;
+    if (dcSetEventCallback(deadcom, dcl_pthreads_eventNotify, combined_cond) != DC_OK) {
+        combined_cond->event_fd = -1;
+        close(fd);
+        return -1;
+    }
+    // Whatever happened before the descriptor existed was not reported, let the caller look
+    dcl_pthreads_eventNotify(combined_cond);
+    return fd;
+}
+
+
+bool dcPthreadsClearEventFd(DeadcomL2 *deadcom) {
+    dcl2_pthread_cond_t *combined_cond = deadcom->condvar_p;
+    uint64_t count;
+    if (read(combined_cond->event_fd, &count, sizeof(count)) < 0) {
+        return errno == EAGAIN;
+    }
+    return true;
 }
 
 
 void dcPthreadsFree(DeadcomL2 *deadcom) {
     dcl2_pthread_cond_t *combined_cond = deadcom->condvar_p;
+    dcl2_pthread_tx_worker_t *w = combined_cond->tx_worker;
+    if (w != NULL) {
+        pthread_mutex_lock(&w->mutx);
+        w->stop = true;
+        pthread_cond_signal(&w->cond);
+        pthread_mutex_unlock(&w->mutx);
+        pthread_join(w->thread, NULL);
+        pthread_cond_destroy(&w->cond);
+        pthread_mutex_destroy(&w->mutx);
+        free(w);
+    }
+    if (combined_cond->event_fd >= 0) {
+        dcSetEventCallback(deadcom, NULL, NULL);
+        close(combined_cond->event_fd);
+    }
+    dcl2_pthread_cond_t *rx_cond = deadcom->rxCondvar_p;
+    if (rx_cond != NULL) {
+        pthread_cond_destroy(rx_cond->cond);
+        free(rx_cond->cond);
+        free(rx_cond);
+    }
     free(combined_cond->mutx);
     free(combined_cond->cond);
+    free(combined_cond->storage);
     free(combined_cond);
 }
@@ -19,14 +19,65 @@
 #include "yahdlc.h"
 
 
+// Default link parameters, used by dcDefaultConfig. Each link may be configured differently, see
+// DeadcomL2Config.
 #define DEADCOM_CONN_TIMEOUT_MS    100
 #define DEADCOM_ACK_TIMEOUT_MS     100
 #define DEADCOM_PAYLOAD_MAX_LEN    249
 #define DEADCOM_MAX_FAILURE_COUNT  3
 
-// Max frame length is 2 for start and end frame flags + 4 for escaped FCS (worst-case) +
-// 4 for escaped address and control byte (worst case) + 2*MAX_PAYLOAD for escaped payload
-#define DEADCOM_MAX_FRAME_LEN ((DEADCOM_PAYLOAD_MAX_LEN*2)+10)
+// Suggested maximum message length of bulk links, which should use CRC-32C FCS (see
+// DeadcomL2Config). CRC-16 FCS does not protect frames this long well enough.
+#define DEADCOM_JUMBO_PAYLOAD_MAX_LEN 4096
+
+// Default bounds of the retransmission timeout. The timeout starts at DEADCOM_ACK_TIMEOUT_MS and
+// once round-trip time of the link is measured it is derived from it (see dcGetRttEstimate).
+#ifndef DEADCOM_RTO_MIN_MS
+#define DEADCOM_RTO_MIN_MS         10
+#endif
+
+#ifndef DEADCOM_RTO_MAX_MS
+#define DEADCOM_RTO_MAX_MS         3000
+#endif
+
+// Default maximum number of DATA frames that may be awaiting acknowledgment at the same time.
+// Links in basic (modulo 8) mode use at most 7 slots, only links in extended (modulo 128) mode can
+// use more.
+#ifndef DEADCOM_MAX_WINDOW_SIZE
+#define DEADCOM_MAX_WINDOW_SIZE    7
+#endif
+
+#if DEADCOM_MAX_WINDOW_SIZE < 1 || DEADCOM_MAX_WINDOW_SIZE > 127
+#error "DEADCOM_MAX_WINDOW_SIZE must be between 1 and 127 (sequence numbers are modulo 128)"
+#endif
+
+// Default number of received messages that may be waiting to be picked up by the application.
+// Messages arriving while the queue is full are discarded and later rejected, so to receive bursts
+// without retransmissions this should be at least the transmit window size of the other station.
+#ifndef DEADCOM_RX_QUEUE_SIZE
+#define DEADCOM_RX_QUEUE_SIZE      7
+#endif
+
+#if DEADCOM_RX_QUEUE_SIZE < 1 || DEADCOM_RX_QUEUE_SIZE > 127
+#error "DEADCOM_RX_QUEUE_SIZE must be between 1 and 127"
+#endif
+
+// Number of control frames (and selective retransmissions of DATA frames) that may be waiting for
+// dcTransmitPending when transmission is queued (see dcSetTransmitQueue). Frames which don't fit
+// are discarded and recovered from just like frames lost on the line.
+#ifndef DEADCOM_TX_QUEUE_SIZE
+#define DEADCOM_TX_QUEUE_SIZE      8
+#endif
+
+#if DEADCOM_TX_QUEUE_SIZE < 1 || DEADCOM_TX_QUEUE_SIZE > 255
+#error "DEADCOM_TX_QUEUE_SIZE must be between 1 and 255"
+#endif
+
+// Max frame length is 2 for start and end frame flags + 8 for escaped CRC-32C FCS (worst-case) +
+// 6 for escaped address and two-byte extended control field (worst case) + 2*payload for
+// escaped payload
+#define DEADCOM_FRAME_LEN(max_payload_len) (((max_payload_len)*2)+16)
+#define DEADCOM_MAX_FRAME_LEN DEADCOM_FRAME_LEN(DEADCOM_PAYLOAD_MAX_LEN)
 
 typedef enum {
     DC_DISCONNECTED,
@@ -47,10 +98,96 @@ typedef enum {
     DC_OK,
     DC_FAILURE,
     DC_NOT_CONNECTED,
-    DC_LINK_RESET
+    DC_LINK_RESET,
+    DC_BUSY
 } DeadcomL2Result;
 
 
+/**
+ * @brief Bookkeeping of one slot of the transmit window.
+ */
+typedef struct {
+    // Length of the payload stored in the slot
+    uint16_t len;
+
+    // Is the payload a fragment of a longer message, continued in the next slot?
+    bool more;
+
+    // Completion callback (and its context) of frames transmitted by dcSendMessageAsync, NULL for
+    // frames transmitted by dcSendMessage.
+    void (*onComplete)(DeadcomL2Result, void*);
+    void *context;
+} DeadcomL2TxSlot;
+
+
+// Number of bytes of storage a link with given parameters needs, see DeadcomL2Config. Includes
+// slack for aligning the storage.
+#define DEADCOM_STORAGE_SIZE(max_payload_len, window_slots, rx_queue_slots)                 \
+    (sizeof(void*) + (window_slots)*sizeof(DeadcomL2TxSlot) +                              \
+     (rx_queue_slots)*sizeof(uint16_t) + ((window_slots) + (rx_queue_slots))*(max_payload_len) + \
+     (max_payload_len) + 4 + DEADCOM_FRAME_LEN(max_payload_len))
+
+// Storage needed by a link using the default configuration
+#define DEADCOM_DEFAULT_STORAGE_SIZE \
+    DEADCOM_STORAGE_SIZE(DEADCOM_PAYLOAD_MAX_LEN, DEADCOM_MAX_WINDOW_SIZE, DEADCOM_RX_QUEUE_SIZE)
+
+
+/**
+ * @brief Parameters of a DeadCom link.
+ *
+ * Fill it with defaults using dcDefaultConfig, adjust what is necessary and pass it to dcInit.
+ * The library does not allocate any memory: all buffers of the link live in `storage` supplied by
+ * the caller, at least DEADCOM_STORAGE_SIZE(max_payload_len, window_slots, rx_queue_slots) bytes
+ * long. Therefore stations with little RAM can use short messages and few slots, while bulk links
+ * can use large ones, with the same build of the library.
+ */
+typedef struct {
+    // How long to wait for response to a connection request
+    uint32_t conn_timeout_ms;
+
+    // Retransmission timeout used until round-trip time of the link is measured
+    uint32_t ack_timeout_ms;
+
+    // Bounds of the retransmission timeout
+    uint32_t rto_min_ms;
+    uint32_t rto_max_ms;
+
+    // Number of consecutive timeouts (or rejects) after which the link is reset
+    uint8_t max_failure_count;
+
+    // Maximum length of a message, in both directions. Both stations should use the same value,
+    // longer messages are discarded by the receiving station.
+    uint16_t max_payload_len;
+
+    // Maximum transmit window size (see dcSetWindowSize), between 1 and 127
+    uint8_t window_slots;
+
+    // Number of received messages that may be waiting to be picked up, between 1 and 127
+    uint8_t rx_queue_slots;
+
+    // Protect frames with 4-byte CRC-32C instead of 2-byte CRC-16 FCS. Meant for links with long
+    // messages (see DEADCOM_JUMBO_PAYLOAD_MAX_LEN). Both stations must use the same FCS.
+    bool fcs32;
+
+    // Memory for buffers of the link and its length. It must stay valid until the link is no
+    // longer used.
+    void *storage;
+    size_t storage_len;
+
+    // Buffer for reassembly of received messages longer than `max_payload_len` and its length,
+    // which limits the length of such messages. NULL (the default) if the station does not expect
+    // them. It must stay valid until the link is no longer used.
+    void *reassembly_buffer;
+    size_t reassembly_buffer_len;
+
+    // Ring buffer for received bytes passed by dcRxPush to dcRxDrain and its length, which must be
+    // a power of two. NULL (the default) if received bytes are passed to dcProcessData directly.
+    // It must stay valid until the link is no longer used.
+    void *rx_ring;
+    size_t rx_ring_len;
+} DeadcomL2Config;
+
+
 /**
  * @brief Methods for operations on synchronization primitives
  *
@@ -86,6 +223,11 @@ typedef struct {
 
     // Signal conditional variable object
     bool (*condvarSignal)(void *condvar_p);
+
+    // Optional: current value of a monotonic millisecond clock (may wrap around). Used to measure
+    // round-trip time of the link. If NULL, time passed to dcTick is used instead, and if that
+    // function is not called either, the retransmission timeout stays fixed.
+    uint32_t (*getTimeMs)(void);
 } DeadcomL2ThreadingMethods;
 
 
@@ -99,30 +241,128 @@ typedef struct {
     // State of the communication library.
     DeadcomL2State state;
 
-    // Buffer for extracted data.
-    uint8_t extractionBuffer[DEADCOM_PAYLOAD_MAX_LEN];
-
-    // Scratchpad buffer for data extraction from newly-received frames
-    uint8_t scratchpadBuffer[DEADCOM_PAYLOAD_MAX_LEN];
-
-    // Length of extracted data, if any.
-    // Type of this should be size_t, but we need it to be singed and I don't feel like using
-    // ssize_t since it comes from POSIX, not the C standard. This code must run on devices that
-    // never heard of POSIX.
-    int16_t extractionBufferSize;
-
-    // Does extractionBuffer contain the whole message or only a part of it?
-    bool extractionComplete;
+    // Parameters of the link
+    DeadcomL2Config config;
+
+    // Received messages waiting to be picked up by the application, `config.rx_queue_slots` slots
+    // of `config.max_payload_len` bytes. Slot `rxQueueStart` holds the oldest one, the following
+    // messages are stored in the following slots (modulo `config.rx_queue_slots`). With selective
+    // reject, frames received out of sequence are held in the free slots after them, as if the
+    // missing frames were queued. Length of a free slot is 0.
+    uint8_t *rxQueue;
+    uint16_t *rxQueueLen;
+    uint8_t rxQueueStart;
+    uint8_t rxQueueCount;
+
+    // Fragments of a message longer than one frame are collected in `config.reassembly_buffer`.
+    // Is such message being received (and does it fit into the buffer), how many bytes of it were
+    // received so far, and is the complete message at the head of the receive queue? Its slot in
+    // the queue holds no payload then, the whole message is in the reassembly buffer.
+    bool rxReassembling;
+    bool rxReassemblyOverflow;
+    size_t rxReassemblyLen;
+    bool rxReassembled;
+
+    // Scratchpad buffer for data extraction from newly-received frames (payload and FCS, up to 4
+    // bytes)
+    uint8_t *scratchpadBuffer;
+
+    // Number of bytes ever stored in `config.rx_ring` by dcRxPush and taken from it by dcRxDrain.
+    // The counters wrap around, byte number `n` lives at `n % config.rx_ring_len`. Each of them is
+    // written only by its side of the ring and read by the other one with atomic accesses, so the
+    // ring needs no lock.
+    size_t rxRingHead;
+    size_t rxRingTail;
+
+    // Buffer for outgoing frames, DEADCOM_FRAME_LEN(config.max_payload_len) bytes
+    uint8_t *txFrame;
 
     // State of the underlying yahdlc library
     yahdlc_state_t yahdlc_state;
 
+    // Does the current link use extended (modulo 128) sequence numbers? Chosen by the station which
+    // initiated the connection.
+    bool extended_mode;
+
+    // Should connections initiated by this station use extended (modulo 128) sequence numbers?
+    bool request_extended_mode;
+
     // Outgoing frame number
     uint8_t send_number;
 
-    // Last acknowledged frame number by the other side
+    // Number of the oldest frame not yet acknowledged by the other side
     uint8_t next_expected_ack;
 
+    // Maximum number of DATA frames that may be awaiting acknowledgment (1 means stop-and-wait)
+    uint8_t window_size;
+
+    // Payloads of transmitted DATA frames not yet acknowledged by the other side,
+    // `config.window_slots` slots of `config.max_payload_len` bytes, and their bookkeeping. Slot
+    // `txWindowStart` holds the frame numbered `next_expected_ack`, the following frames are
+    // stored in the following slots (modulo `config.window_slots`).
+    uint8_t *txWindow;
+    DeadcomL2TxSlot *txSlots;
+    uint8_t txWindowStart;
+
+    // Time of the last dcTick call and the time when frames awaiting acknowledgment are to be
+    // retransmitted if no thread is waiting for them
+    uint32_t tickTime;
+    uint32_t ackDeadline;
+
+    // Has dcTick been called? If there is no getTimeMs threading method, tickTime is our clock.
+    bool ticking;
+
+    // Smoothed round-trip time (scaled by 8) and its mean deviation (scaled by 4) in milliseconds,
+    // as in TCP (RFC 6298). Valid only once the round-trip time was measured.
+    bool rttMeasured;
+    uint32_t srtt;
+    uint32_t rttvar;
+
+    // Current retransmission timeout in milliseconds
+    uint32_t rto;
+
+    // Is the round-trip time of frame number `rttSeq`, transmitted at `rttStart`, being measured?
+    // Only one frame is timed at a time, and never a retransmitted one (Karn's rule).
+    bool rttTiming;
+    uint8_t rttSeq;
+    uint32_t rttStart;
+
+    // Was the link reset while some frames were awaiting acknowledgment with no thread waiting
+    // for them? The next dcSendMessage or dcFlush call reports this.
+    bool txWindowLost;
+
+    // Did we have to discard a DATA frame which we will have to reject once all messages in the
+    // receive queue are picked up?
+    bool rxDiscarded;
+
+    // Have we told the other station that we are not ready to receive (RNR), and not yet that we
+    // are ready again (ACK or reject)? Has the other station told us so?
+    bool rxNotReady;
+    bool peerBusy;
+
+    // Have we rejected a frame which was not retransmitted yet? Only one reject may be outstanding.
+    bool rxRejected;
+
+    // How far ahead of recv_number was the last out-of-sequence frame received while the reject
+    // was outstanding? Used to tell when the other station went back but lost the frame again.
+    uint8_t rxRejectedAhead;
+
+    // Should frames received out of sequence be kept and only the missing frames rejected
+    // (selective reject)? How many frames following recv_number were already received or
+    // selectively rejected?
+    bool selectiveReject;
+    uint8_t rxSelectAhead;
+
+    // Should acknowledgments of picked up messages be held back, so that they can ride on the next
+    // DATA frame?
+    bool delayAcks;
+
+    // Should messages be acknowledged once stored in the receive queue instead of once picked up?
+    bool earlyAcks;
+
+    // Is acknowledgment of the last picked up (or stored, see earlyAcks) message held back?
+    bool ackPending;
+
     // Number of frame we expect to receive next
     uint8_t recv_number;
 
@@ -135,12 +375,44 @@ typedef struct {
     // Function for transmitting outgoing bytes
     bool (*transmitBytes)(const uint8_t*, size_t, void*);
 
+    // Function for transmitting outgoing frames as segments, used instead of transmitBytes if set
+    bool (*transmitVec)(const yahdlc_iovec_t*, size_t, void*);
+
+    // Function notified that frames are waiting for dcTransmitPending, and its context. If NULL,
+    // frames are transmitted directly.
+    void (*onTransmitPending)(void*);
+    void *transmitPendingContext;
+
+    // Control frames waiting for dcTransmitPending. Entry `txQueueStart` is the oldest one. DATA
+    // entries stand for selective retransmission of the window frame with their N(S).
+    yahdlc_control_t txQueue[DEADCOM_TX_QUEUE_SIZE];
+    uint8_t txQueueStart;
+    uint8_t txQueueCount;
+
+    // How many frames of the transmit window were transmitted by dcTransmitPending (since the last
+    // retransmission of the whole window)? Is dcTransmitPending transmitting a frame right now?
+    uint8_t txWindowSent;
+    bool txDraining;
+
+    // Function receiving messages directly from scratchpadBuffer instead of the receive queue, and
+    // its context
+    void (*onMessage)(const uint8_t*, size_t, void*);
+    void *onMessageContext;
+
+    // Function notified that a message was received, frames were acknowledged or the link was
+    // (dis)connected, and its context
+    void (*onEvent)(void*);
+    void *eventContext;
+
     // Pointer to mutex for locking this structure
     void *mutex_p;
 
     // Pointer to conditional variable to wait on
     void *condvar_p;
 
+    // Pointer to conditional variable signalled when a message is received (optional)
+    void *rxCondvar_p;
+
     // Transmission context
     void *transmission_context_p;
 
@@ -151,6 +423,17 @@ typedef struct {
 
 // ---- UPPER LAYER API (for use by Application Protocol implementation) ----
 
+/**
+ * Fill link parameters with defaults.
+ *
+ * Timeouts, retry count, payload length and the numbers of slots are set to the DEADCOM_* defaults.
+ * No storage is assigned, the caller has to supply at least DEADCOM_DEFAULT_STORAGE_SIZE bytes
+ * (or DEADCOM_STORAGE_SIZE with the adjusted parameters).
+ *
+ * @param[out] config  Parameters to fill
+ */
+void dcDefaultConfig(DeadcomL2Config *config);
+
 /**
  * Initialize an object representing a DeadCom link.
  *
@@ -169,14 +452,17 @@ typedef struct {
  *                         - const uint8_t* : the byte buffer to transmit
  *                         - size_t         : size of that byte buffer
  *                         - void*          : Transmission context
+ * @param config  Parameters of the link, see DeadcomL2Config. The structure is copied, the storage
+ *                it points to must outlive the link.
  *
  * @retval DC_OK  DeadCom Layer 2 object initialized successfully
- * @retval DC_FAILURE  Invalid parameters or external method has failed
+ * @retval DC_FAILURE  Invalid parameters (including invalid configuration or too small storage) or
+ *                     external method has failed
  */
 DeadcomL2Result dcInit(DeadcomL2 *deadcom, void *mutex_p, void *condvar_p,
                        DeadcomL2ThreadingMethods *t,
                        bool (*transmitBytes)(const uint8_t*, size_t, void*),
-                       void *transmitBytesContext);
+                       void *transmitBytesContext, const DeadcomL2Config *config);
 
 /**
  * Try to establish a connection.
@@ -214,38 +500,386 @@ DeadcomL2Result dcConnect(DeadcomL2 *deadcom);
  */
 DeadcomL2Result dcDisconnect(DeadcomL2 *deadcom);
 
+/**
+ * Set size of the transmit window.
+ *
+ * The transmit window is the number of DATA frames that may be sent before the first of them is
+ * acknowledged by the receiving station. Window of size 1 (the default) means stop-and-wait
+ * operation: dcSendMessage returns only after the message has been acknowledged.
+ *
+ * With larger windows dcSendMessage returns as soon as the message is transmitted and blocks only
+ * while the window is full. Frames are acknowledged cumulatively and lost frames are retransmitted
+ * go-back-N style. Use dcFlush to wait until all transmitted messages are acknowledged.
+ *
+ * The window size may be changed at any time, a smaller window takes effect once enough
+ * outstanding frames are acknowledged. Links in basic (modulo 8) mode limit the window to 7
+ * frames, see dcSetExtendedMode.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] window_size  New window size, between 1 and `window_slots` of the link configuration
+ *
+ * @retval DC_OK  Window size was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetWindowSize(DeadcomL2 *deadcom, uint8_t window_size);
+
+/**
+ * Select sequence numbering mode for connections initiated by this station.
+ *
+ * In basic mode (the default) frames are numbered modulo 8, and therefore at most 7 frames may be
+ * awaiting acknowledgment. In extended mode frames carry two-byte control field and are numbered
+ * modulo 128, allowing transmit windows of up to 127 frames (limited by the configuration).
+ * This is useful on links with large buffers or long round-trip times.
+ *
+ * The mode is negotiated during link establishment: the station which sends the connection
+ * request decides, the other station follows. The new setting takes effect with the next call
+ * to dcConnect.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] extended  Use extended (modulo 128) mode
+ *
+ * @retval DC_OK  The mode was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetExtendedMode(DeadcomL2 *deadcom, bool extended);
+
+/**
+ * Reject lost frames selectively.
+ *
+ * By default a station which receives DATA frame out of sequence discards it and rejects all frames
+ * from the missing one on (go-back-N), so the other station retransmits its whole window after a
+ * single loss. With selective reject the station keeps frames received out of sequence in free
+ * slots of its receive queue and rejects only the missing frames with SREJ frames, the other
+ * station retransmits just those. If a frame can't be kept, the station falls back to go-back-N.
+ *
+ * Both stations must enable this option. So that retransmitted frames can't be mistaken for new
+ * ones, it limits the transmit window of the station to half of the sequence number space (4
+ * frames in basic mode, 64 in extended mode), and the station receiving out-of-sequence frames
+ * relies on the other station doing so. Older versions of this library don't understand SREJ
+ * frames at all.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] selective  Use selective reject
+ *
+ * @retval DC_OK  The option was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetSelectiveReject(DeadcomL2 *deadcom, bool selective);
+
+/**
+ * Hold back acknowledgments so that they can be piggybacked on outgoing DATA frames.
+ *
+ * Every DATA frame carries acknowledgment of all messages picked up by the application so far.
+ * By default dcGetReceivedMsg transmits a separate acknowledgment as soon as a message is picked
+ * up. With delayed acknowledgments it leaves the acknowledgment pending instead, and it is sent
+ * with the next message transmitted by dcSendMessage. This saves one frame per exchange in
+ * request/response traffic. If no message is transmitted in the meantime, the acknowledgment is
+ * sent separately by the next call of dcGetReceivedMsg or dcTick, therefore applications using this
+ * option must keep calling one of them.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] delayed  Hold back acknowledgments
+ *
+ * @retval DC_OK  The option was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetDelayedAck(DeadcomL2 *deadcom, bool delayed);
+
+/**
+ * Acknowledge received messages as soon as they are stored in the receive queue.
+ *
+ * By default a message is acknowledged only once the application picks it up by
+ * dcGetReceivedMsg, so the round-trip time seen by the other station (and whether it retransmits
+ * in vain) depends on how often the application polls. With early acknowledgments the library
+ * acknowledges the message as soon as it owns a copy of it. The application then has to pick up
+ * all acknowledged messages, they are not retransmitted if it resets the link before. If the
+ * receive queue fills up, the other station is told to hold back (RNR) until a message is picked
+ * up. Can be combined with delayed acknowledgments.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] early  Acknowledge messages once stored
+ *
+ * @retval DC_OK  The option was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetEarlyAck(DeadcomL2 *deadcom, bool early);
+
+/**
+ * Deliver received messages by a callback.
+ *
+ * Instead of queuing received messages for dcGetReceivedMsg, the library passes each message to
+ * `onMessage` as soon as it is received. The payload pointer points directly into the internal
+ * buffer of the library and is valid only until the callback returns, therefore the message is not
+ * copied at all unless the application does so (messages reassembled from fragments are passed
+ * from the reassembly buffer). The message is considered picked up (and acknowledged) once the
+ * callback returns.
+ *
+ * The callback is invoked from the thread calling dcProcessData while the link is locked. It must
+ * not block and it must not call any function of this library. Messages which were already queued
+ * when the callback was set are still returned by dcGetReceivedMsg, and messages arriving until
+ * they are picked up are queued as well so that the order of messages is preserved.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] onMessage  Callback receiving the payload, its length and `context`, or NULL to queue
+ *                       received messages for dcGetReceivedMsg (the default)
+ * @param[in] context  Context passed to the callback
+ *
+ * @retval DC_OK  The callback was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetMessageCallback(DeadcomL2 *deadcom,
+                                     void (*onMessage)(const uint8_t*, size_t, void*),
+                                     void *context);
+
+/**
+ * Set the conditional variable dcWaitMessage waits on.
+ *
+ * The condvar is initialized by this function (using condvarInit of the threading VMT) and it is
+ * waited on and signalled with the mutex of the link locked, just like the condvar passed to
+ * dcInit. It must be a different object than that one, since both may be waited on at the same
+ * time by different threads.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] condvar_p  Pointer to a Conditional Variable object, uninitialized
+ *
+ * @retval DC_OK  The condvar was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetReceiveCondvar(DeadcomL2 *deadcom, void *condvar_p);
+
+/**
+ * Get notified about events on the link.
+ *
+ * `onEvent` is called whenever a message is stored in the receive queue, DATA frames are
+ * acknowledged by the other station (which completes dcSendMessage or dcSendMessageAsync) or the
+ * link is connected or disconnected. It tells an event loop serving many links which of them need
+ * attention (see dcPthreadsEventFd), the loop then finds out what happened by the usual calls,
+ * such as dcGetReceivedMsg. Several events may result in a single notification and vice versa.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] onEvent  Function called (with the link locked) on every event, or NULL to stop the
+ *                     notifications. It must not block and it must not call into the library.
+ *                     Parameter is:
+ *                       - void* : `context`
+ * @param[in] context  Context passed to `onEvent`
+ *
+ * @retval DC_OK  The function was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetEventCallback(DeadcomL2 *deadcom, void (*onEvent)(void*), void *context);
+
+/**
+ * Transmit frames as segments instead of contiguous buffers.
+ *
+ * By default each frame is assembled in the transmit buffer of the link and passed to
+ * transmitBytes. With `transmitVec` set, the library passes the frame as a sequence of segments
+ * (start flag with header, runs of payload pointing directly into the transmit window, escaped
+ * bytes, FCS with end flag) instead, so neither new frames nor retransmissions are copied. This
+ * maps directly onto `writev` (see dcPthreadsWritevFd). A frame is passed in one call unless its
+ * payload contains many bytes which need escaping, in which case it is passed in several calls of
+ * up to YAHDLC_IOV_MAX segments each.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] transmitVec  Function transmitting segments, with the same semantics and context as
+ *                         transmitBytes passed to dcInit, or NULL to use transmitBytes (the
+ *                         default). Parameters are:
+ *                           - const yahdlc_iovec_t* : segments to transmit
+ *                           - size_t                : number of segments
+ *                           - void*                 : Transmission context
+ *
+ * @retval DC_OK  The function was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetTransmitVec(DeadcomL2 *deadcom,
+                                 bool (*transmitVec)(const yahdlc_iovec_t*, size_t, void*));
+
+/**
+ * Queue outgoing frames instead of transmitting them right away.
+ *
+ * By default frames are transmitted by whichever call produced them, with the link locked, so a
+ * slow transmitBytes holds up dcProcessData and every other call on the link. With queued
+ * transmission the library only records that frames are to be transmitted and calls
+ * `onTransmitPending`; the frames are then transmitted by dcTransmitPending, typically called
+ * from a dedicated transmit thread (see dcPthreadsStartTxWorker). Control frames (acknowledgments,
+ * rejects, connection management) are transmitted ahead of DATA frames, and acknowledgment numbers
+ * are filled in only when a frame is actually transmitted.
+ *
+ * Set this before connecting. Frames still waiting in the queue when this is called are discarded.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] onTransmitPending  Function called (with the link locked) whenever frames are waiting
+ *                               for dcTransmitPending, or NULL to transmit frames directly (the
+ *                               default). It must not call into the library. Parameter is:
+ *                                 - void* : `context`
+ * @param[in] context  Context passed to `onTransmitPending`
+ *
+ * @retval DC_OK  The function was set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetTransmitQueue(DeadcomL2 *deadcom, void (*onTransmitPending)(void*),
+                                   void *context);
+
+/**
+ * Transmit frames waiting in the queue.
+ *
+ * Transmits queued frames until there are none left. The link is locked only while a frame is
+ * taken from the queue and encoded, transmitBytes (or transmitVec) is called with the link
+ * unlocked. If another thread is already transmitting queued frames, the function returns
+ * immediately and that thread transmits the frames instead.
+ *
+ * @param[in] deadcom  Instance of DeadCom link with queued transmission
+ *
+ * @retval DC_OK  All queued frames were transmitted (or are being transmitted by another thread)
+ * @retval DC_FAILURE  Invalid parameters, transmission is not queued or external method has failed
+ */
+DeadcomL2Result dcTransmitPending(DeadcomL2 *deadcom);
+
+/**
+ * Change bounds of the retransmission timeout set by the link configuration.
+ *
+ * The library measures round-trip time of the link (from transmission of a DATA frame to its
+ * acknowledgment) and derives the timeout after which unacknowledged frames are retransmitted from
+ * the smoothed round-trip time and its variance. After each timeout the timeout is doubled until
+ * a new measurement is made. The result is always kept between `min_ms` and `max_ms`.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] min_ms  Floor of the retransmission timeout, at least 1
+ * @param[in] max_ms  Ceiling of the retransmission timeout, at least `min_ms`
+ *
+ * @retval DC_OK  The bounds were set
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcSetRetransmitTimeoutBounds(DeadcomL2 *deadcom, uint32_t min_ms, uint32_t max_ms);
+
+/**
+ * Get the current round-trip time estimate of the link.
+ *
+ * Round-trip time can be measured only if the threading VMT provides getTimeMs or the application
+ * calls dcTick. Until the first measurement the estimate is zero and the retransmission timeout is
+ * `ack_timeout_ms` of the configuration (within the bounds). The estimate is kept when the link is
+ * reset.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[out] srtt_ms  Smoothed round-trip time in milliseconds, may be NULL
+ * @param[out] rttvar_ms  Mean deviation of the round-trip time in milliseconds, may be NULL
+ * @param[out] rto_ms  Current retransmission timeout in milliseconds, may be NULL
+ *
+ * @retval DC_OK  The estimate was retrieved
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcGetRttEstimate(DeadcomL2 *deadcom, uint32_t *srtt_ms, uint32_t *rttvar_ms,
+                                 uint32_t *rto_ms);
+
 /**
  * Transmit a message.
  *
- * This function encapsulates the given message and transmits it over open link. It then waits
- * for confirmation that the message has been received by the receiving side. It automatically
+ * This function encapsulates the given message and transmits it over open link. It automatically
  * tries to retransmit the message several times if the confirmation didn't arrive.
- * It returns after the message has been acknowledged by the receiving side or transmission failed
- * and the link was reset.
  *
- * If a message is currently being transmitted over this link, this function waits for that
- * transmission and acknowledgment reception to complete.
+ * In stop-and-wait mode (window size 1) it then waits for confirmation that the message has been
+ * received by the receiving side. It returns after the message has been acknowledged by the
+ * receiving side or transmission failed and the link was reset.
+ *
+ * If the window size is larger than 1, this function waits only while the transmit window is full
+ * and returns as soon as the message is transmitted. Delivery failure of such message is reported
+ * by a later call of dcSendMessage or dcFlush.
+ *
+ * Messages longer than `max_payload_len` of the link configuration are split into fragments sent
+ * in consecutive DATA frames, which are pipelined in the transmit window like separate messages.
+ * The receiving station reassembles them into its reassembly buffer (see DeadcomL2Config) and
+ * delivers the whole message at once. Messages which don't fit into that buffer are discarded by
+ * the receiving station.
  *
  * @param[in] deadcom  Instance of an open DeadCom link
  * @param[in] message  Message to be transmitted
  * @param[in] message_len  Length of the message to be transmitted
  *
  * @retval  DC_OK  If the transmission succeeded and the receiving station has acknowledged the
- *                 message
+ *                 message (stop-and-wait), or the message was transmitted (windowed mode)
  * @retval  DC_NOT_CONNECTED  If the link is not in the connected state
  * @retval  DC_LINK_RESET  If the tranission has failed / receiving station failed to acknowledge
  *                         the frame and the link has been reset as the result.
- * @retval  DC_FAILURE  Incorrect parameters, message too long or external method has failed.
+ * @retval  DC_FAILURE  Incorrect parameters, another thread is already waiting for acknowledgments
+ *                      on this link or external method has failed.
  */
 DeadcomL2Result dcSendMessage(DeadcomL2 *deadcom, const uint8_t *message, size_t message_len);
 
+/**
+ * Transmit a message without waiting for acknowledgment.
+ *
+ * This function stores the message in the transmit window, transmits it and returns right away.
+ * The message has to fit into one frame (`max_payload_len` of the link configuration).
+ * Retransmissions of messages sent this way are driven by dcTick, which must be called
+ * periodically (starting before the first message is sent), unless some other thread waits for
+ * acknowledgments in dcSendMessage or dcFlush.
+ *
+ * Once the message is acknowledged by the receiving station `onComplete` is called with DC_OK. If
+ * the link is reset (because the message could not be delivered, the other station has reset the
+ * link or dcDisconnect was called) before that, `onComplete` is called with DC_LINK_RESET.
+ * `onComplete` is invoked from whichever thread has processed the event (usually the one calling
+ * dcProcessData or dcTick) while the link is locked. It must not block and it must not call any
+ * function of this library.
+ *
+ * @param[in] deadcom  Instance of an open DeadCom link
+ * @param[in] message  Message to be transmitted
+ * @param[in] message_len  Length of the message to be transmitted
+ * @param[in] onComplete  Completion callback, receives the result and `context`
+ * @param[in] context  Context passed to the completion callback
+ *
+ * @retval  DC_OK  The message was transmitted, its result will be reported by `onComplete`
+ * @retval  DC_BUSY  The transmit window is full or another thread is waiting for it. Try again once
+ *                   some of the messages are acknowledged.
+ * @retval  DC_NOT_CONNECTED  If the link is not in the connected state
+ * @retval  DC_FAILURE  Incorrect parameters, message too long or external method has failed.
+ *                      `onComplete` will not be called.
+ */
+DeadcomL2Result dcSendMessageAsync(DeadcomL2 *deadcom, const uint8_t *message, size_t message_len,
+                                   void (*onComplete)(DeadcomL2Result, void*), void *context);
+
+/**
+ * Drive timers of the link.
+ *
+ * This function retransmits messages sent by dcSendMessageAsync if they are not acknowledged in
+ * time, and resets the link if the other station stays unresponsive. It also transmits
+ * acknowledgments held back by dcSetDelayedAck which did not ride on any DATA frame since the last
+ * call. The function never blocks for longer than it takes to transmit the frames, therefore one
+ * thread can drive many links. Unless the threading VMT provides getTimeMs, `now_ms` is also used
+ * to measure round-trip time of the link, so its resolution limits precision of the measurement.
+ *
+ * @param[in] deadcom  Instance of DeadCom link
+ * @param[in] now_ms  Current time in milliseconds from an arbitrary monotonic clock. It may wrap
+ *                    around.
+ *
+ * @retval DC_OK  Operation succeeded
+ * @retval DC_FAILURE  Invalid parameters or external method has failed
+ */
+DeadcomL2Result dcTick(DeadcomL2 *deadcom, uint32_t now_ms);
+
+/**
+ * Wait until all transmitted messages are acknowledged.
+ *
+ * This function blocks the calling thread until the receiving station acknowledges all messages
+ * transmitted by dcSendMessage, retransmitting them if needed. In stop-and-wait mode there is never
+ * anything to wait for and this function returns immediately.
+ *
+ * @param[in] deadcom  Instance of an open DeadCom link
+ *
+ * @retval  DC_OK  All transmitted messages were acknowledged
+ * @retval  DC_NOT_CONNECTED  If the link is not in the connected state
+ * @retval  DC_LINK_RESET  Receiving station failed to acknowledge some messages and the link has been
+ *                         reset as the result.
+ * @retval  DC_FAILURE  Invalid parameters, another thread is already waiting for acknowledgments on
+ *                      this link or external method has failed.
+ */
+DeadcomL2Result dcFlush(DeadcomL2 *deadcom);
+
 /**
  * Get the received message.
  *
  * This function returns the received message, if any. When the message is copied this function
- * transmits a message acknowledgment to the sending station. This means that if this function
- * is not called in time the sending station may decide that we are unresponsive and terminate
- * the link.
+ * transmits a message acknowledgment to the sending station (or holds it back until the next call,
+ * see dcSetDelayedAck). This means that if this function is not called in time the sending
+ * station may decide that we are unresponsive and terminate the link.
  *
  * @param[in] deadcom  Instance of an open DeadCom link
  * @param[out] buffer  Buffer the message will be stored in or NULL. It should be big enough to
@@ -254,6 +888,10 @@ DeadcomL2Result dcSendMessage(DeadcomL2 *deadcom, const uint8_t *message, size_t
  * @param[out] msg_len  Number of bytes that were copied to `buffer` (or would have been copied
  *                      to `buffer` if it wasnt NULL). 0 if no message is pending.
  *
+ * Received messages are queued (up to `rx_queue_slots` of them) and this function returns
+ * them in the order they were received. Messages longer than `max_payload_len` of the link
+ * configuration are returned once all their fragments are received.
+ *
  * @note   Since to get the message you may need to call this function twice (first time to get
  *         the required buffer size, second time to actually copy the message), one might expect
  *         "Time of check to time of use" race condition might occur.
@@ -261,9 +899,9 @@ DeadcomL2Result dcSendMessage(DeadcomL2 *deadcom, const uint8_t *message, size_t
  *         was no message present at the call time and does not guarantee that next call will
  *         copy 0 bytes.
  *         However, by nature of this library, once this function returns a non-zero in `msg_len`
- *         (thereby singnaling that a message is received and is pending to be picked up), no other
- *         message will be accepted until this one is picked up. Pending message can be cleared only
- *         by "picking it up" by calling this function with non-NULL buffer.
+ *         (thereby singnaling that a message is received and is pending to be picked up), it stays
+ *         at the head of the receive queue until it is picked up. Pending message can be cleared
+ *         only by "picking it up" by calling this function with non-NULL buffer.
  *         Therefore if a message is pending, subsequent calls to dcGetReceivedMsg are guaranteed
  *         to:
  *           - Either copy the whole message with length as returned by previous invocation of this
@@ -276,13 +914,41 @@ DeadcomL2Result dcSendMessage(DeadcomL2 *deadcom, const uint8_t *message, size_t
  */
 DeadcomL2Result dcGetReceivedMsg(DeadcomL2 *deadcom, uint8_t *buffer, size_t *msg_len);
 
+/**
+ * Wait for a received message.
+ *
+ * Blocks until a message is received (or the link is disconnected) and picks it up just like
+ * dcGetReceivedMsg with non-NULL buffer does. If a message is pending already, it returns right
+ * away. The function waits on the condvar set by dcSetReceiveCondvar, which is signalled by
+ * dcProcessData once it stores a complete message in the receive queue, so there is no need to
+ * poll dcGetReceivedMsg. Only one thread should wait for messages of a link at a time.
+ *
+ * Messages delivered by a callback (see dcSetMessageCallback) are not stored in the receive queue,
+ * so waiting for them times out.
+ *
+ * @param[in] deadcom  Instance of an open DeadCom link with a receive condvar
+ * @param[out] buffer  Buffer the message will be stored in
+ * @param[in] buffer_len  Size of `buffer`
+ * @param[out] msg_len  Number of bytes copied to `buffer`, 0 if no message was received before
+ *                      the timeout. If the message does not fit into `buffer`, its length is
+ *                      stored here and the message stays pending.
+ * @param[in] timeout_ms  How long to wait for a message, in milliseconds
+ *
+ * @retval DC_OK  Operation succeeded, a message was picked up or the wait timed out
+ * @retval DC_NOT_CONNECTED  Link is (or became) disconnected, no messages can be pending
+ * @retval DC_FAILURE  Invalid parameters, the link has no receive condvar, the message does not
+ *                     fit into `buffer` or external method has failed
+ */
+DeadcomL2Result dcWaitMessage(DeadcomL2 *deadcom, uint8_t *buffer, size_t buffer_len,
+                              size_t *msg_len, uint32_t timeout_ms);
+
 /**
  * Process received data.
  *
  * This function processes all received bytes in the buffer `data` and triggers appropriate
  * responses. The buffer may contain any chunk of received data, it does not have to contain the
  * whole frame. This processing (and acting upon received data) may take some time, so this function
- * is not to be called from an interrupt handler.
+ * is not to be called from an interrupt handler. Use dcRxPush there and dcRxDrain in a thread.
  *
  * @param[in] deadcom  Instance of an open DeadCom link
  * @param[in] data  Data that were just received
@@ -293,5 +959,43 @@ DeadcomL2Result dcGetReceivedMsg(DeadcomL2 *deadcom, uint8_t *buffer, size_t *ms
  */
 DeadcomL2Result dcProcessData(DeadcomL2 *deadcom, const uint8_t *data, size_t len);
 
+/**
+ * Store received bytes in the receive ring of the link.
+ *
+ * Unlike dcProcessData this function does not lock the link and never blocks, it just copies the
+ * bytes into the ring buffer supplied in the link configuration (`rx_ring`). Therefore it may be
+ * called from an interrupt handler or a signal handler. The bytes are processed later by
+ * dcRxDrain. Only one context may push bytes to a link, and pushing must not run concurrently
+ * with dcInit.
+ *
+ * If the ring is full, the bytes which don't fit are discarded. The frames they belonged to are
+ * then lost just as if they were corrupted on the line, and the protocol recovers from that by
+ * retransmission.
+ *
+ * @param[in] deadcom  Instance of DeadCom link with a receive ring
+ * @param[in] data  Data that were just received
+ * @param[in] len  Number of received bytes
+ *
+ * @retval DC_OK  All bytes were stored
+ * @retval DC_BUSY  The ring is full, some of the bytes were discarded
+ * @retval DC_FAILURE  Invalid parameters or the link has no receive ring
+ */
+DeadcomL2Result dcRxPush(DeadcomL2 *deadcom, const uint8_t *data, size_t len);
+
+/**
+ * Process bytes stored in the receive ring.
+ *
+ * This function passes all bytes stored by dcRxPush so far to dcProcessData, straight from the
+ * ring buffer in (at most two) contiguous chunks. Only one thread may drain a link. Bytes pushed
+ * while the function runs are left for the next call.
+ *
+ * @param[in] deadcom  Instance of DeadCom link with a receive ring
+ *
+ * @retval DC_OK  Operation succeeded (also when there was nothing to process)
+ * @retval DC_FAILURE  Invalid parameters, the link has no receive ring or external method has
+ *                     failed
+ */
+DeadcomL2Result dcRxDrain(DeadcomL2 *deadcom);
+
 
 #endif
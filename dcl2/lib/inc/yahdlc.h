@@ -44,6 +44,7 @@ This file was modified for use in Project Deadlock (component libdeadcom). Notab
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
 
 /** FCS initialization value. */
@@ -52,6 +53,12 @@ This file was modified for use in Project Deadlock (component libdeadcom). Notab
 /** FCS value for valid frames. */
 #define FCS16_GOOD_VALUE 0xF0B8
 
+/** CRC-32C FCS initialization value. */
+#define FCS32_INIT_VALUE 0xFFFFFFFF
+
+/** CRC-32C FCS value for valid frames. */
+#define FCS32_GOOD_VALUE 0xB798B438
+
 /** HDLC start/end flag sequence */
 #define YAHDLC_FLAG_SEQUENCE 0x7E
 
@@ -61,6 +68,9 @@ This file was modified for use in Project Deadlock (component libdeadcom). Notab
 /** HDLC all station address */
 #define YAHDLC_ALL_STATION_ADDR 0xFF
 
+/** Maximum number of segments yahdlc_frame_data_vec passes to its transmit function at once */
+#define YAHDLC_IOV_MAX 16
+
 /** Supported HDLC frame types */
 typedef enum {
     YAHDLC_FRAME_DATA,
@@ -68,29 +78,66 @@ typedef enum {
     YAHDLC_FRAME_NACK,
     YAHDLC_FRAME_CONN,
     YAHDLC_FRAME_CONN_ACK,
+    YAHDLC_FRAME_SREJ,
+    YAHDLC_FRAME_RNR,
 } yahdlc_frame_t;
 
 /** Control field information */
 typedef struct {
     yahdlc_frame_t frame;
-    uint8_t send_seq_no :3;
-    uint8_t recv_seq_no :3;
+    /** Send sequence number (3-bit in basic mode, 7-bit in extended mode) */
+    uint8_t send_seq_no :7;
+    /** Receive sequence number (3-bit in basic mode, 7-bit in extended mode) */
+    uint8_t recv_seq_no :7;
+    /**
+     * Extended (modulo 128) mode. DATA, ACK, NACK and SREJ frames are encoded with two-byte control
+     * field, CONN frame is encoded as HDLC SABME (instead of SABM) command.
+     */
+    uint8_t extended :1;
+    /**
+     * DATA frame carries a fragment of a longer message and more fragments follow. Encoded as
+     * cleared P/F bit, therefore DATA frames of stations which don't fragment messages are always
+     * complete messages.
+     */
+    uint8_t more :1;
+    /**
+     * Frame is protected by 4-byte CRC-32C instead of 2-byte CRC-16 FCS. Both stations of a link
+     * must use the same FCS.
+     */
+    uint8_t fcs32 :1;
 } yahdlc_control_t;
 
+/** One segment of a frame created by yahdlc_frame_data_vec */
+typedef struct {
+    const uint8_t *base;
+    size_t len;
+} yahdlc_iovec_t;
+
 /**
  * Variables used in yahdlc_get_data and yahdlc_get_data_with_state
  * to keep track of received buffers
  */
 typedef struct {
     uint8_t control_escape;
-    uint16_t fcs;
+    uint32_t fcs;
     ptrdiff_t start_index;
     ptrdiff_t end_index;
     ptrdiff_t src_index;
     unsigned int frame_byte_index;
     ptrdiff_t dest_index;
     uint8_t frame_control;
+    uint8_t frame_control_ext;
     size_t max_frame_len;
+    /**
+     * Expect two-byte (modulo 128) control field in DATA, ACK and NACK frames. Set to 0 by
+     * yahdlc_reset_state, and preserved between frames afterwards.
+     */
+    uint8_t extended;
+    /**
+     * Expect 4-byte CRC-32C FCS instead of CRC-16. Set to 0 by yahdlc_reset_state, and preserved
+     * between frames afterwards.
+     */
+    uint8_t fcs32;
 } yahdlc_state_t;
 
 /**
@@ -102,9 +149,31 @@ typedef struct {
  */
 uint16_t fcs16(uint16_t fcs, uint8_t value);
 
+/**
+ * Calculates a new FCS based on the current value and a buffer of data. Same as calling fcs16 for
+ * every byte of the buffer, but faster.
+ *
+ * @param fcs Current FCS value
+ * @param buf Data to be added
+ * @param len Length of the data
+ * @returns Calculated FCS value
+ */
+uint16_t fcs16_buf(uint16_t fcs, const uint8_t *buf, size_t len);
+
+/**
+ * Calculates a new CRC-32C FCS based on the current value and a buffer of data.
+ *
+ * @param fcs Current FCS value
+ * @param buf Data to be added
+ * @param len Length of the data
+ * @returns Calculated FCS value
+ */
+uint32_t fcs32_buf(uint32_t fcs, const uint8_t *buf, size_t len);
+
 /**
  * Resets values used in yahdlc_get_data function to keep track of received buffers.
- * Sets the new maximum frame length for frame decoding.
+ * Sets the new maximum frame length for frame decoding and switches the decoder to basic
+ * (modulo 8) mode with CRC-16 FCS.
  */
 void yahdlc_reset_state(yahdlc_state_t *state, size_t max_frame_len);
 
@@ -146,4 +215,45 @@ int yahdlc_get_data(yahdlc_state_t *state, yahdlc_control_t *control, const uint
 int yahdlc_frame_data(yahdlc_control_t *control, const uint8_t *src, size_t src_len,
                       uint8_t *dest, size_t *dest_len);
 
+/**
+ * Looks up HDLC frame without data, which was encoded in advance.
+ *
+ * Control frames are few and one of them is transmitted for every received message, therefore
+ * ACK, NACK, SREJ, CONN and CONN_ACK frames of basic mode and ACK frames of extended mode with
+ * CRC-16 FCS are kept encoded in a constant table. Other frames must be created by
+ * yahdlc_frame_data.
+ *
+ * @param[in] control Control field structure with frame type and sequence number
+ * @param[out] frame Pointer to the encoded frame
+ * @param[out] frame_len Length of the encoded frame
+ *
+ * @retval 0 Success
+ * @retval -EINVAL Invalid parameter
+ * @retval -ENOENT The frame is not in the table
+ */
+int yahdlc_frame_lookup(const yahdlc_control_t *control, const uint8_t **frame,
+                        size_t *frame_len);
+
+/**
+ * Creates HDLC frame with specified data buffer without assembling it in memory.
+ *
+ * The frame is passed to `transmit` as a sequence of segments: start flag with escaped address
+ * and control field, runs of data which need no escaping (pointing directly into `src`), escaped
+ * bytes, and escaped FCS with end flag. `transmit` is called with up to YAHDLC_IOV_MAX segments at
+ * once, therefore more than once only if the data contain many bytes which need escaping. Segments
+ * are valid only during the call.
+ *
+ * @param[in] control Control field structure with frame type and sequence number
+ * @param[in] src Source buffer with data
+ * @param[in] src_len Source buffer length
+ * @param[in] transmit Function transmitting segments of the frame, returning false on failure
+ * @param[in] context Context passed to `transmit`
+ *
+ * @retval 0 Success
+ * @retval -EINVAL Invalid parameter
+ * @retval -EIO `transmit` has failed
+ */
+int yahdlc_frame_data_vec(yahdlc_control_t *control, const uint8_t *src, size_t src_len,
+                          bool (*transmit)(const yahdlc_iovec_t*, size_t, void*), void *context);
+
 #endif
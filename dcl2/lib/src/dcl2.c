@@ -2,135 +2,1275 @@
 #include "dcl2.h"
 
 
+static uint8_t seqModulo(DeadcomL2 *deadcom) {
+    return deadcom->extended_mode ? 128 : 8;
+}
+
+
+/**
+ * Payload buffer of slot `slot` of the transmit window.
+ */
+static uint8_t* txWindowSlot(DeadcomL2 *deadcom, uint8_t slot) {
+    return deadcom->txWindow + slot * deadcom->config.max_payload_len;
+}
+
+
+/**
+ * Payload buffer of slot `slot` of the receive queue.
+ */
+static uint8_t* rxQueueSlot(DeadcomL2 *deadcom, uint8_t slot) {
+    return deadcom->rxQueue + slot * deadcom->config.max_payload_len;
+}
+
+
+static uint8_t framesInFlight(DeadcomL2 *deadcom) {
+    uint8_t modulo = seqModulo(deadcom);
+    return (deadcom->send_number + modulo - deadcom->next_expected_ack) % modulo;
+}
+
+
+/**
+ * Report result of messages transmitted by dcSendMessageAsync stored in `count` slots of the
+ * transmit window, starting with slot `start`.
+ */
+static void completeAsyncFrames(DeadcomL2 *deadcom, uint8_t start, uint8_t count,
+                                DeadcomL2Result result) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t slot = (start + i) % deadcom->config.window_slots;
+        void (*onComplete)(DeadcomL2Result, void*) = deadcom->txSlots[slot].onComplete;
+        if (onComplete != NULL) {
+            deadcom->txSlots[slot].onComplete = NULL;
+            onComplete(result, deadcom->txSlots[slot].context);
+        }
+    }
+}
+
+
+/**
+ * Are there any frames transmitted by dcSendMessage awaiting acknowledgment?
+ */
+static bool blockingFramesInFlight(DeadcomL2 *deadcom) {
+    uint8_t in_flight = framesInFlight(deadcom);
+    for (uint8_t i = 0; i < in_flight; i++) {
+        uint8_t slot = (deadcom->txWindowStart + i) % deadcom->config.window_slots;
+        if (deadcom->txSlots[slot].onComplete == NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Can we measure round-trip time? Stores the current time in `now` if so.
+ */
+static bool readClock(DeadcomL2 *deadcom, uint32_t *now) {
+    if (deadcom->t->getTimeMs != NULL) {
+        *now = deadcom->t->getTimeMs();
+        return true;
+    }
+    *now = deadcom->tickTime;
+    return deadcom->ticking;
+}
+
+
+static uint32_t clampRto(DeadcomL2 *deadcom, uint32_t rto) {
+    if (rto < deadcom->config.rto_min_ms) {
+        return deadcom->config.rto_min_ms;
+    }
+    return (rto > deadcom->config.rto_max_ms) ? deadcom->config.rto_max_ms : rto;
+}
+
+
+/**
+ * Retransmission timeout derived from the current round-trip time estimate.
+ */
+static uint32_t estimatedRto(DeadcomL2 *deadcom) {
+    if (!deadcom->rttMeasured) {
+        return clampRto(deadcom, deadcom->config.ack_timeout_ms);
+    }
+    uint32_t variance = (deadcom->rttvar > 1) ? deadcom->rttvar : 1;
+    return clampRto(deadcom, (deadcom->srtt >> 3) + variance);
+}
+
+
+/**
+ * Update round-trip time estimate with a new measurement and derive the retransmission timeout
+ * from it (RFC 6298, with the same fixed-point arithmetic as TCP implementations).
+ */
+static void updateRtt(DeadcomL2 *deadcom, uint32_t rtt) {
+    if (!deadcom->rttMeasured) {
+        deadcom->srtt = rtt << 3;
+        deadcom->rttvar = rtt << 1;
+        deadcom->rttMeasured = true;
+    } else {
+        int32_t delta = (int32_t)rtt - (int32_t)(deadcom->srtt >> 3);
+        deadcom->srtt += delta;
+        if (delta < 0) {
+            delta = -delta;
+        }
+        deadcom->rttvar += delta - (int32_t)(deadcom->rttvar >> 2);
+    }
+    deadcom->rto = estimatedRto(deadcom);
+}
+
+
+/**
+ * Retransmission timeout has elapsed, back off until the next valid measurement. Without a clock
+ * there will never be one, so the timeout stays fixed.
+ */
+static void backoffRto(DeadcomL2 *deadcom) {
+    uint32_t now;
+    if (readClock(deadcom, &now)) {
+        deadcom->rto = clampRto(deadcom, deadcom->rto * 2);
+    }
+}
+
+
+/**
+ * Tell the application that something happened on the link (see dcSetEventCallback).
+ */
+static void notifyEvent(DeadcomL2 *deadcom) {
+    if (deadcom->onEvent != NULL) {
+        deadcom->onEvent(deadcom->eventContext);
+    }
+}
+
+
 static void resetLink(DeadcomL2 *deadcom) {
+    // Frames awaiting acknowledgment are lost
+    completeAsyncFrames(deadcom, deadcom->txWindowStart, framesInFlight(deadcom), DC_LINK_RESET);
+
     deadcom->send_number = 0;
     deadcom->next_expected_ack = 0;
     deadcom->recv_number = 0;
     deadcom->failure_count = 0;
-    deadcom->extractionBufferSize = 0;
-    deadcom->extractionComplete = false;
+    // Forget the back-off, but keep the estimate. It is the same physical line after all.
+    deadcom->rto = estimatedRto(deadcom);
+    deadcom->rttTiming = false;
+    deadcom->rxQueueStart = 0;
+    deadcom->rxQueueCount = 0;
+    memset(deadcom->rxQueueLen, 0, deadcom->config.rx_queue_slots * sizeof(uint16_t));
+    deadcom->rxSelectAhead = 0;
+    deadcom->rxReassembling = false;
+    deadcom->rxReassembled = false;
+    deadcom->txWindowStart = 0;
+    deadcom->txWindowSent = 0;
+    deadcom->txWindowLost = false;
+    deadcom->rxDiscarded = false;
+    deadcom->rxRejected = false;
+    deadcom->rxRejectedAhead = 0;
+    deadcom->rxNotReady = false;
+    deadcom->peerBusy = false;
+    deadcom->ackPending = false;
+    if (deadcom->state != DC_DISCONNECTED) {
+        notifyEvent(deadcom);
+    }
     deadcom->state = DC_DISCONNECTED;
+
+    // Wake up dcWaitMessage so that it reports the disconnection. If signalling fails, it finds
+    // out once its wait times out.
+    if (deadcom->rxCondvar_p != NULL) {
+        deadcom->t->condvarSignal(deadcom->rxCondvar_p);
+    }
+}
+
+
+/**
+ * Switch sequence numbering mode of the link (both our frames and decoding of incoming frames).
+ */
+static void setExtendedMode(DeadcomL2 *deadcom, bool extended) {
+    deadcom->extended_mode = extended;
+    deadcom->yahdlc_state.extended = extended;
+}
+
+
+/**
+ * Number of frames that may be awaiting acknowledgment, limited by sequence number space.
+ */
+static uint8_t effectiveWindowSize(DeadcomL2 *deadcom) {
+    if (deadcom->peerBusy) {
+        // The other station would discard the frames anyway, send one at a time until it is ready
+        return 1;
+    }
+    // With selective reject the receiving station can't tell a retransmitted frame from a new one
+    // if the window is larger than half of the sequence number space
+    uint8_t max = deadcom->selectiveReject ? seqModulo(deadcom) / 2 : seqModulo(deadcom) - 1;
+    return (deadcom->window_size > max) ? max : deadcom->window_size;
+}
+
+
+/**
+ * Number of messages in the receive queue which were not acknowledged yet. Frames in the receive
+ * queue are acknowledged only once they are picked up, unless early acknowledgments are enabled.
+ */
+static uint8_t unacknowledgedCount(DeadcomL2 *deadcom) {
+    return deadcom->earlyAcks ? 0 : deadcom->rxQueueCount;
+}
+
+
+/**
+ * Number of the last frame received in sequence which we acknowledge.
+ */
+static uint8_t lastAcknowledged(DeadcomL2 *deadcom) {
+    uint8_t modulo = seqModulo(deadcom);
+    return (deadcom->recv_number + 2*modulo - unacknowledgedCount(deadcom) - 1) % modulo;
+}
+
+
+/**
+ * Transmit a contiguous frame. Returns false if external method has failed.
+ */
+static bool writeFrame(DeadcomL2 *deadcom, const uint8_t *frame, size_t frame_len) {
+    if (deadcom->transmitVec != NULL) {
+        yahdlc_iovec_t iov = {frame, frame_len};
+        return deadcom->transmitVec(&iov, 1, deadcom->transmission_context_p);
+    }
+    return deadcom->transmitBytes(frame, frame_len, deadcom->transmission_context_p);
+}
+
+
+/**
+ * Encode a frame: control frames encoded in advance are taken from the lookup table, others are
+ * assembled in txFrame. Returns false if the frame could not be encoded.
+ */
+static bool encodeFrame(DeadcomL2 *deadcom, yahdlc_control_t *control, const uint8_t *payload,
+                        size_t payload_len, const uint8_t **frame, size_t *frame_len) {
+    control->fcs32 = deadcom->config.fcs32;
+    if (control->frame != YAHDLC_FRAME_DATA &&
+        yahdlc_frame_lookup(control, frame, frame_len) == 0) {
+        return true;
+    }
+    *frame = deadcom->txFrame;
+    return yahdlc_frame_data(control, payload, payload_len, deadcom->txFrame, frame_len) == 0;
+}
+
+
+/**
+ * Queue a control frame (or selective retransmission of a DATA frame, identified by its N(S))
+ * for dcTransmitPending. Acknowledgments are cumulative, so an ACK already waiting in the queue is
+ * just updated. If the queue is full the frame is discarded, as if it got lost on the line.
+ */
+static void queueControlFrame(DeadcomL2 *deadcom, const yahdlc_control_t *control) {
+    for (uint8_t i = 0; i < deadcom->txQueueCount; i++) {
+        yahdlc_control_t *queued = &deadcom->txQueue[(deadcom->txQueueStart + i) %
+                                                     DEADCOM_TX_QUEUE_SIZE];
+        if (control->frame == YAHDLC_FRAME_ACK && queued->frame == YAHDLC_FRAME_ACK) {
+            *queued = *control;
+            return;
+        }
+    }
+    if (deadcom->txQueueCount < DEADCOM_TX_QUEUE_SIZE) {
+        deadcom->txQueue[(deadcom->txQueueStart + deadcom->txQueueCount) %
+                         DEADCOM_TX_QUEUE_SIZE] = *control;
+        deadcom->txQueueCount++;
+    }
+    deadcom->onTransmitPending(deadcom->transmitPendingContext);
+}
+
+
+/**
+ * Transmit a frame, either as segments pointing into `payload` or assembled in txFrame. Control
+ * frames encoded in advance are transmitted directly. With queued transmission control frames are
+ * queued instead. Returns false if external method has failed.
+ */
+static bool transmitFrame(DeadcomL2 *deadcom, yahdlc_control_t *control, const uint8_t *payload,
+                          size_t payload_len) {
+    const uint8_t *encoded;
+    size_t frame_len;
+    if (deadcom->onTransmitPending != NULL && control->frame != YAHDLC_FRAME_DATA) {
+        queueControlFrame(deadcom, control);
+        return true;
+    }
+
+    if (deadcom->transmitVec != NULL && control->frame == YAHDLC_FRAME_DATA) {
+        control->fcs32 = deadcom->config.fcs32;
+        return yahdlc_frame_data_vec(control, payload, payload_len, deadcom->transmitVec,
+                                     deadcom->transmission_context_p) == 0;
+    }
+
+    if (!encodeFrame(deadcom, control, payload, payload_len, &encoded, &frame_len)) {
+        return false;
+    }
+    return writeFrame(deadcom, encoded, frame_len);
+}
+
+
+/**
+ * Acknowledge frame number `recv_seq_no` and all frames received before it.
+ */
+static bool transmitAck(DeadcomL2 *deadcom, uint8_t recv_seq_no) {
+    yahdlc_control_t control_ack = {
+        .frame = YAHDLC_FRAME_ACK,
+        .recv_seq_no = recv_seq_no,
+        .extended = deadcom->extended_mode
+    };
+    deadcom->ackPending = false;
+    deadcom->rxNotReady = false;
+    return transmitFrame(deadcom, &control_ack, NULL, 0);
+}
+
+
+/**
+ * Tell the other station that we can't take more frames until the application picks up the
+ * received messages (RNR). Acknowledges messages picked up (or queued) so far, like reject. Once
+ * there is room again, the other station learns that from our next ACK or reject.
+ */
+static bool transmitNotReady(DeadcomL2 *deadcom) {
+    yahdlc_control_t control_rnr = {
+        .frame = YAHDLC_FRAME_RNR,
+        .recv_seq_no = lastAcknowledged(deadcom),
+        .extended = deadcom->extended_mode
+    };
+    deadcom->rxNotReady = true;
+    deadcom->ackPending = false;
+    return transmitFrame(deadcom, &control_rnr, NULL, 0);
+}
+
+
+/**
+ * Transmit acknowledgment held back for piggybacking, if there is one.
+ */
+static bool transmitPendingAck(DeadcomL2 *deadcom) {
+    if (!deadcom->ackPending) {
+        return true;
+    }
+    // Messages acknowledged early don't hold the other station back, so once they fill the receive
+    // queue, it has to wait for the application explicitly
+    if (deadcom->earlyAcks && deadcom->rxQueueCount >= deadcom->config.rx_queue_slots) {
+        return transmitNotReady(deadcom);
+    }
+    return transmitAck(deadcom, lastAcknowledged(deadcom));
+}
+
+
+/**
+ * N(R) for outgoing DATA frames: number of the first frame we don't acknowledge yet.
+ */
+static uint8_t piggybackRecvNumber(DeadcomL2 *deadcom) {
+    return (lastAcknowledged(deadcom) + 1) % seqModulo(deadcom);
+}
+
+
+/**
+ * Reject all frames after the last one we have received in sequence and passed to the application.
+ */
+static bool transmitReject(DeadcomL2 *deadcom) {
+    yahdlc_control_t control_nack = {
+        .frame = YAHDLC_FRAME_NACK,
+        .recv_seq_no = lastAcknowledged(deadcom),
+        .extended = deadcom->extended_mode
+    };
+    deadcom->rxRejected = true;
+    deadcom->ackPending = false;
+    deadcom->rxNotReady = false;
+    return transmitFrame(deadcom, &control_nack, NULL, 0);
+}
+
+
+/**
+ * Reject just frame number `recv_seq_no`, which got lost. Unlike reject, this does not acknowledge
+ * any frames.
+ */
+static bool transmitSelectiveReject(DeadcomL2 *deadcom, uint8_t recv_seq_no) {
+    yahdlc_control_t control_srej = {
+        .frame = YAHDLC_FRAME_SREJ,
+        .recv_seq_no = recv_seq_no,
+        .extended = deadcom->extended_mode
+    };
+    return transmitFrame(deadcom, &control_srej, NULL, 0);
+}
+
+
+/**
+ * Frame number recv_number was received in sequence, expect the next one. Positions of frames
+ * received out of sequence are relative to recv_number, therefore they move by one.
+ */
+static void receivedInSequence(DeadcomL2 *deadcom) {
+    deadcom->recv_number = (deadcom->recv_number + 1) % seqModulo(deadcom);
+    deadcom->rxRejected = false;
+    deadcom->rxDiscarded = false;
+    if (deadcom->rxRejectedAhead > 0) {
+        deadcom->rxRejectedAhead--;
+    }
+    if (deadcom->rxSelectAhead > 0) {
+        deadcom->rxSelectAhead--;
+    }
+}
+
+
+/**
+ * A frame with invalid checksum (or too long) was received. It may have been a DATA frame, so
+ * reject it right away instead of letting the other station wait for acknowledgment timeout. A
+ * burst of noise may corrupt many frames in a row, therefore the same limit as for out-of-sequence
+ * frames applies: only one reject may be outstanding until a frame is received in sequence.
+ * Doesn't apply to selective reject. Returns false if external method has failed.
+ */
+static bool rejectCorrupted(DeadcomL2 *deadcom) {
+    if ((deadcom->state != DC_CONNECTED && deadcom->state != DC_TRANSMITTING) ||
+        deadcom->rxRejected || deadcom->rxDiscarded) {
+        return true;
+    }
+    if (deadcom->selectiveReject) {
+        // Rejecting all frames from the corrupted one on would defeat selective reject. The frames
+        // which follow tell which one is missing.
+        return true;
+    }
+    // Frames which were already on the way are going to arrive out of sequence, they must not be
+    // mistaken for the other station going back
+    deadcom->rxRejectedAhead = 0;
+    if (unacknowledgedCount(deadcom) > 0) {
+        deadcom->rxDiscarded = true;
+        return true;
+    }
+    return transmitReject(deadcom);
+}
+
+
+/**
+ * Process fragment of a message longer than one frame, received in sequence. Fragments are
+ * collected in the reassembly buffer and picked up right away, so that the other station can keep
+ * its transmit window full. The last fragment completes the message, which is then delivered as
+ * any other message. Returns false if external method has failed.
+ */
+static bool receiveFragment(DeadcomL2 *deadcom, const uint8_t *payload, size_t len, bool more) {
+    if (!deadcom->rxReassembling) {
+        if (deadcom->rxQueueCount > 0) {
+            // Messages received before have to be picked up first (the last of them may occupy the
+            // reassembly buffer). Discard the fragment, it will be rejected once they are.
+            if (!deadcom->rxRejected) {
+                deadcom->rxDiscarded = true;
+                return transmitNotReady(deadcom);
+            }
+            return true;
+        }
+        deadcom->rxReassembling = true;
+        deadcom->rxReassemblyOverflow = false;
+        deadcom->rxReassemblyLen = 0;
+    }
+
+    if (deadcom->rxReassemblyLen + len > deadcom->config.reassembly_buffer_len) {
+        // The message does not fit into the buffer, its fragments are just acknowledged
+        deadcom->rxReassemblyOverflow = true;
+    }
+    if (!deadcom->rxReassemblyOverflow) {
+        memcpy((uint8_t*)deadcom->config.reassembly_buffer + deadcom->rxReassemblyLen,
+               payload, len);
+        deadcom->rxReassemblyLen += len;
+    }
+    receivedInSequence(deadcom);
+
+    if (!more) {
+        deadcom->rxReassembling = false;
+        if (!deadcom->rxReassemblyOverflow && deadcom->onMessage != NULL) {
+            deadcom->onMessage(deadcom->config.reassembly_buffer, deadcom->rxReassemblyLen,
+                               deadcom->onMessageContext);
+        } else if (!deadcom->rxReassemblyOverflow) {
+            // The receive queue is empty, the complete message takes its first slot and it is
+            // acknowledged once picked up (or right away with early acknowledgments)
+            deadcom->rxQueueCount = 1;
+            deadcom->rxReassembled = true;
+            deadcom->ackPending = deadcom->ackPending || deadcom->earlyAcks;
+            return true;
+        }
+    }
+
+    // The fragment was picked up, its slot of the (empty) receive queue is free again
+    deadcom->rxQueueStart = (deadcom->rxQueueStart + 1) % deadcom->config.rx_queue_slots;
+    deadcom->ackPending = true;
+    return deadcom->delayAcks || transmitPendingAck(deadcom);
+}
+
+
+/**
+ * Move frames received out of sequence which are no longer preceded by missing frames into the
+ * receive queue (or deliver them to the callback). Returns false if external method has failed.
+ */
+static bool collectReordered(DeadcomL2 *deadcom) {
+    while (deadcom->rxQueueCount < deadcom->config.rx_queue_slots) {
+        uint8_t slot = (deadcom->rxQueueStart + deadcom->rxQueueCount) %
+                       deadcom->config.rx_queue_slots;
+        uint16_t len = deadcom->rxQueueLen[slot];
+        if (len == 0) {
+            break;
+        }
+        if (deadcom->rxReassembling) {
+            // Only complete messages and last fragments are kept, this one completes the message
+            deadcom->rxQueueLen[slot] = 0;
+            if (!receiveFragment(deadcom, rxQueueSlot(deadcom, slot), len, false)) {
+                return false;
+            }
+        } else if (deadcom->onMessage != NULL && deadcom->rxQueueCount == 0) {
+            receivedInSequence(deadcom);
+            deadcom->rxQueueLen[slot] = 0;
+            deadcom->rxQueueStart = (slot + 1) % deadcom->config.rx_queue_slots;
+            deadcom->onMessage(rxQueueSlot(deadcom, slot), len, deadcom->onMessageContext);
+            deadcom->ackPending = true;
+            if (!deadcom->delayAcks && !transmitPendingAck(deadcom)) {
+                return false;
+            }
+        } else {
+            // The frame is already stored in the right slot
+            receivedInSequence(deadcom);
+            deadcom->rxQueueCount++;
+            deadcom->ackPending = deadcom->ackPending || deadcom->earlyAcks;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Can DATA frame received `ahead` frames after recv_number be kept until the missing frames are
+ * retransmitted? If not, we have to fall back to go-back-N.
+ */
+static bool canKeepOutOfSequence(DeadcomL2 *deadcom, uint8_t ahead, size_t len, bool more) {
+    // Frames more than half of the sequence number space ahead are in fact old retransmissions.
+    // Fragments are reassembled in sequence only.
+    return deadcom->selectiveReject && ahead < seqModulo(deadcom) / 2 && len != 0 && !more &&
+           deadcom->rxQueueCount + ahead < deadcom->config.rx_queue_slots;
+}
+
+
+/**
+ * Keep DATA frame received `ahead` frames after recv_number, waiting in the scratchpad, and
+ * selectively reject the frames before it which are missing. `wentBack` tells that the other
+ * station went back, therefore frame number recv_number got lost again. Returns false if external
+ * method has failed.
+ */
+static bool keepOutOfSequence(DeadcomL2 *deadcom, uint8_t ahead, size_t len, bool wentBack) {
+    uint8_t slot = (deadcom->rxQueueStart + deadcom->rxQueueCount + ahead) %
+                   deadcom->config.rx_queue_slots;
+    if (deadcom->rxQueueLen[slot] == 0) {
+        memcpy(rxQueueSlot(deadcom, slot), deadcom->scratchpadBuffer, len);
+        deadcom->rxQueueLen[slot] = len;
+    }
+
+    if (wentBack && deadcom->rxSelectAhead > 0 &&
+        !transmitSelectiveReject(deadcom, deadcom->recv_number)) {
+        return false;
+    }
+    // Reject the frames we haven't seen or rejected yet
+    for (uint8_t i = deadcom->rxSelectAhead; i < ahead; i++) {
+        uint8_t missing = (deadcom->rxQueueStart + deadcom->rxQueueCount + i) %
+                          deadcom->config.rx_queue_slots;
+        if (deadcom->rxQueueLen[missing] == 0 &&
+            !transmitSelectiveReject(deadcom, (deadcom->recv_number + i) % seqModulo(deadcom))) {
+            return false;
+        }
+    }
+    if (ahead >= deadcom->rxSelectAhead) {
+        deadcom->rxSelectAhead = ahead + 1;
+    }
+    return true;
+}
+
+
+/**
+ * Process acknowledgment of frames up to and including frame number `recv_seq_no`.
+ *
+ * Returns false if that frame is not awaiting acknowledgment (stale or invalid acknowledgment).
+ */
+static bool acknowledgeFrames(DeadcomL2 *deadcom, uint8_t recv_seq_no) {
+    uint8_t modulo = seqModulo(deadcom);
+    uint8_t acked = ((recv_seq_no + modulo - deadcom->next_expected_ack) % modulo) + 1;
+    if (acked > framesInFlight(deadcom)) {
+        return false;
+    }
+    uint32_t now;
+    if (deadcom->rttTiming && readClock(deadcom, &now) &&
+        (deadcom->rttSeq + modulo - deadcom->next_expected_ack) % modulo < acked) {
+        deadcom->rttTiming = false;
+        updateRtt(deadcom, now - deadcom->rttStart);
+    }
+    uint8_t acked_start = deadcom->txWindowStart;
+    deadcom->txWindowSent -= (acked < deadcom->txWindowSent) ? acked : deadcom->txWindowSent;
+    deadcom->next_expected_ack = (deadcom->next_expected_ack + acked) % modulo;
+    deadcom->txWindowStart = (deadcom->txWindowStart + acked) % deadcom->config.window_slots;
+    // The other station is alive, restart the acknowledgment timer for the remaining frames
+    deadcom->failure_count = 0;
+    deadcom->ackDeadline = deadcom->tickTime + deadcom->rto;
+    completeAsyncFrames(deadcom, acked_start, acked, DC_OK);
+    notifyEvent(deadcom);
+    return true;
+}
+
+
+/**
+ * Process acknowledgment received either in ACK frame or piggybacked on DATA frame and wake up
+ * the thread waiting for it. Returns false if external method has failed.
+ */
+static bool processAck(DeadcomL2 *deadcom, uint8_t recv_seq_no) {
+    if (acknowledgeFrames(deadcom, recv_seq_no)) {
+        deadcom->last_response = DC_RESP_OK;
+        if (deadcom->state == DC_TRANSMITTING) {
+            return deadcom->t->condvarSignal(deadcom->condvar_p);
+        }
+    }
+    // Discard incorrect acknowledgment.
+    return true;
+}
+
+
+/**
+ * Control field of frame from the transmit window. The frame carries acknowledgment of all
+ * messages picked up so far.
+ */
+static yahdlc_control_t windowFrameControl(DeadcomL2 *deadcom, uint8_t offset) {
+    uint8_t slot = (deadcom->txWindowStart + offset) % deadcom->config.window_slots;
+    yahdlc_control_t control = {
+        .frame = YAHDLC_FRAME_DATA,
+        .send_seq_no = (deadcom->next_expected_ack + offset) % seqModulo(deadcom),
+        .recv_seq_no = piggybackRecvNumber(deadcom),
+        .extended = deadcom->extended_mode,
+        .more = deadcom->txSlots[slot].more
+    };
+    deadcom->ackPending = false;
+    return control;
+}
+
+
+/**
+ * Encode frame from the transmit window into txFrame. Returns false if the frame could not be
+ * encoded.
+ */
+static bool encodeWindowFrame(DeadcomL2 *deadcom, uint8_t offset, const uint8_t **frame,
+                              size_t *frame_len) {
+    uint8_t slot = (deadcom->txWindowStart + offset) % deadcom->config.window_slots;
+    yahdlc_control_t control = windowFrameControl(deadcom, offset);
+    return encodeFrame(deadcom, &control, txWindowSlot(deadcom, slot), deadcom->txSlots[slot].len,
+                       frame, frame_len);
+}
+
+
+/**
+ * Transmit frame from the transmit window. With queued transmission frames not transmitted yet are
+ * left for dcTransmitPending, and retransmission of a frame transmitted before is queued.
+ */
+static bool transmitWindowFrame(DeadcomL2 *deadcom, uint8_t offset) {
+    if (deadcom->onTransmitPending != NULL) {
+        if (offset < deadcom->txWindowSent) {
+            yahdlc_control_t control = {
+                .frame = YAHDLC_FRAME_DATA,
+                .send_seq_no = (deadcom->next_expected_ack + offset) % seqModulo(deadcom)
+            };
+            queueControlFrame(deadcom, &control);
+        } else {
+            deadcom->onTransmitPending(deadcom->transmitPendingContext);
+        }
+        return true;
+    }
+
+    uint8_t slot = (deadcom->txWindowStart + offset) % deadcom->config.window_slots;
+    yahdlc_control_t control = windowFrameControl(deadcom, offset);
+    return transmitFrame(deadcom, &control, txWindowSlot(deadcom, slot),
+                         deadcom->txSlots[slot].len);
+}
+
+
+/**
+ * Store a new message (or its fragment, followed by `more` fragments) in the transmit window and
+ * transmit it. `onComplete` is called once the message is acknowledged or lost, NULL for messages
+ * sent by dcSendMessage.
+ */
+static bool transmitNewFrame(DeadcomL2 *deadcom, const uint8_t *message, size_t message_len,
+                             bool more, void (*onComplete)(DeadcomL2Result, void*),
+                             void *context) {
+    uint8_t offset = framesInFlight(deadcom);
+    uint8_t slot = (deadcom->txWindowStart + offset) % deadcom->config.window_slots;
+    memcpy(txWindowSlot(deadcom, slot), message, message_len);
+    deadcom->txSlots[slot].len = message_len;
+    deadcom->txSlots[slot].more = more;
+    deadcom->txSlots[slot].onComplete = onComplete;
+    deadcom->txSlots[slot].context = context;
+    if (offset == 0) {
+        // Nothing was awaiting acknowledgment, start the acknowledgment timer
+        deadcom->ackDeadline = deadcom->tickTime + deadcom->rto;
+    }
+    uint8_t modulo = seqModulo(deadcom);
+    uint8_t seq = deadcom->send_number;
+    deadcom->send_number = (deadcom->send_number + 1) % modulo;
+
+    if (!transmitWindowFrame(deadcom, offset)) {
+        deadcom->send_number = seq;
+        deadcom->txSlots[slot].onComplete = NULL;
+        return false;
+    }
+    if (!deadcom->rttTiming && readClock(deadcom, &deadcom->rttStart)) {
+        deadcom->rttTiming = true;
+        deadcom->rttSeq = seq;
+    }
+    return true;
+}
+
+
+/**
+ * Go-back-N: retransmit all frames awaiting acknowledgment.
+ */
+static bool retransmitWindow(DeadcomL2 *deadcom) {
+    // Acknowledgment of a retransmitted frame can't tell which transmission it belongs to
+    deadcom->rttTiming = false;
+    if (deadcom->peerBusy) {
+        // Poll the busy station with the oldest frame, it would discard the others
+        return framesInFlight(deadcom) == 0 || transmitWindowFrame(deadcom, 0);
+    }
+    if (deadcom->onTransmitPending != NULL) {
+        // dcTransmitPending starts over from the oldest frame
+        deadcom->txWindowSent = 0;
+        deadcom->onTransmitPending(deadcom->transmitPendingContext);
+        return true;
+    }
+    uint8_t in_flight = framesInFlight(deadcom);
+    for (uint8_t i = 0; i < in_flight; i++) {
+        if (!transmitWindowFrame(deadcom, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Retransmit frame number `send_seq_no` rejected by the other station, if it is still awaiting
+ * acknowledgment. Returns false if external method has failed.
+ */
+static bool retransmitSelected(DeadcomL2 *deadcom, uint8_t send_seq_no) {
+    uint8_t modulo = seqModulo(deadcom);
+    uint8_t offset = (send_seq_no + modulo - deadcom->next_expected_ack) % modulo;
+    if (offset >= framesInFlight(deadcom)) {
+        // Stale reject
+        return true;
+    }
+    // Acknowledgment of a retransmitted frame can't tell which transmission it belongs to, and the
+    // frames after it wait for it at the other station
+    deadcom->rttTiming = false;
+    return transmitWindowFrame(deadcom, offset);
+}
+
+
+/**
+ * Wait until at most `max_in_flight` frames are awaiting acknowledgment, retransmitting them if
+ * necessary. Must be called with the mutex locked, in DC_CONNECTED state.
+ */
+static DeadcomL2Result awaitAcknowledgments(DeadcomL2 *deadcom, uint8_t max_in_flight) {
+    deadcom->failure_count = 0;
+    while (framesInFlight(deadcom) > max_in_flight) {
+        // Don't keep the other station waiting for our acknowledgments while we wait for theirs
+        if (!transmitPendingAck(deadcom)) {
+            return DC_FAILURE;
+        }
+
+        uint8_t oldest_unacked = deadcom->next_expected_ack;
+        deadcom->state = DC_TRANSMITTING;
+
+        bool timed_out;
+        if (!deadcom->t->condvarWait(deadcom->condvar_p, deadcom->rto, &timed_out)) {
+            deadcom->state = DC_CONNECTED;
+            return DC_FAILURE;
+        }
+
+        if (!timed_out && deadcom->last_response == DC_RESP_NOLINK) {
+            // The other station dropped link. Let's drop ours
+            resetLink(deadcom);
+            return DC_LINK_RESET;
+        }
+
+        if (deadcom->next_expected_ack != oldest_unacked) {
+            // Receive thread has processed an acknowledgment, the other station is alive
+            deadcom->failure_count = 0;
+        }
+
+        if (timed_out || deadcom->last_response == DC_RESP_REJECT) {
+            if (timed_out) {
+                backoffRto(deadcom);
+            }
+            deadcom->failure_count++;
+            if (deadcom->failure_count >= deadcom->config.max_failure_count) {
+                // the other station is unresponsive, reset the link.
+                resetLink(deadcom);
+                return DC_LINK_RESET;
+            }
+            if (!retransmitWindow(deadcom)) {
+                deadcom->state = DC_CONNECTED;
+                return DC_FAILURE;
+            }
+        }
+    }
+    deadcom->state = DC_CONNECTED;
+    return DC_OK;
+}
+
+
+void dcDefaultConfig(DeadcomL2Config *config) {
+    if (config == NULL) {
+        return;
+    }
+    memset(config, 0, sizeof(DeadcomL2Config));
+    config->conn_timeout_ms = DEADCOM_CONN_TIMEOUT_MS;
+    config->ack_timeout_ms = DEADCOM_ACK_TIMEOUT_MS;
+    config->rto_min_ms = DEADCOM_RTO_MIN_MS;
+    config->rto_max_ms = DEADCOM_RTO_MAX_MS;
+    config->max_failure_count = DEADCOM_MAX_FAILURE_COUNT;
+    config->max_payload_len = DEADCOM_PAYLOAD_MAX_LEN;
+    config->window_slots = DEADCOM_MAX_WINDOW_SIZE;
+    config->rx_queue_slots = DEADCOM_RX_QUEUE_SIZE;
+}
+
+
+/**
+ * Split storage supplied in the configuration into buffers of the link. The layout must match
+ * DEADCOM_STORAGE_SIZE. Returns false if the storage is too small.
+ */
+static bool assignStorage(DeadcomL2 *deadcom) {
+    DeadcomL2Config *c = &(deadcom->config);
+    if (c->storage == NULL ||
+        c->storage_len < DEADCOM_STORAGE_SIZE(c->max_payload_len, c->window_slots,
+                                              c->rx_queue_slots)) {
+        return false;
+    }
+
+    // Bookkeeping structures go first, aligned for pointers. Byte buffers follow.
+    uintptr_t misalignment = (uintptr_t)c->storage % sizeof(void*);
+    uint8_t *p = (uint8_t*)c->storage + (misalignment ? sizeof(void*) - misalignment : 0);
+    deadcom->txSlots = (DeadcomL2TxSlot*)p;
+    p += c->window_slots * sizeof(DeadcomL2TxSlot);
+    deadcom->rxQueueLen = (uint16_t*)p;
+    p += c->rx_queue_slots * sizeof(uint16_t);
+    deadcom->txWindow = p;
+    p += c->window_slots * c->max_payload_len;
+    deadcom->rxQueue = p;
+    p += c->rx_queue_slots * c->max_payload_len;
+    deadcom->scratchpadBuffer = p;
+    p += c->max_payload_len + 4;
+    deadcom->txFrame = p;
+
+    memset(deadcom->txSlots, 0, c->window_slots * sizeof(DeadcomL2TxSlot));
+    return true;
 }
 
 
 DeadcomL2Result dcInit(DeadcomL2 *deadcom, void *_mutex_p, void *_condvar_p,
                        DeadcomL2ThreadingMethods *_t,
                        bool (*transmitBytes)(const uint8_t*, size_t, void*),
-                       void *transmissionContext) {
+                       void *transmissionContext, const DeadcomL2Config *config) {
     if (deadcom == NULL || transmitBytes == NULL || _mutex_p == NULL || _condvar_p == NULL ||
-        _t == NULL) {
+        _t == NULL || config == NULL) {
+        return DC_FAILURE;
+    }
+    if (config->conn_timeout_ms == 0 || config->ack_timeout_ms == 0 || config->rto_min_ms == 0 ||
+        config->rto_max_ms < config->rto_min_ms || config->max_failure_count == 0 ||
+        config->max_payload_len == 0 || config->window_slots == 0 ||
+        config->window_slots > 127 || config->rx_queue_slots == 0 ||
+        config->rx_queue_slots > 127 ||
+        (config->reassembly_buffer == NULL && config->reassembly_buffer_len > 0) ||
+        (config->rx_ring == NULL && config->rx_ring_len > 0) ||
+        (config->rx_ring != NULL &&
+         (config->rx_ring_len == 0 || (config->rx_ring_len & (config->rx_ring_len - 1)) != 0))) {
         return DC_FAILURE;
     }
 
     // Initialize DeadcomL2 structure
     memset(deadcom, 0, sizeof(DeadcomL2));
+    deadcom->config = *config;
+    if (!assignStorage(deadcom)) {
+        return DC_FAILURE;
+    }
     resetLink(deadcom);
     deadcom->transmitBytes = transmitBytes;
     deadcom->mutex_p = _mutex_p;
     deadcom->condvar_p = _condvar_p;
     deadcom->t = _t;
     deadcom->transmission_context_p = transmissionContext;
-    yahdlc_reset_state(&(deadcom->yahdlc_state), DEADCOM_MAX_FRAME_LEN);
+    deadcom->window_size = 1;
+    // yahdlc stores payload followed by FCS and rejects frames which would fill its buffer
+    yahdlc_reset_state(&(deadcom->yahdlc_state),
+                       deadcom->config.max_payload_len + (deadcom->config.fcs32 ? 4 : 2) + 1);
+    deadcom->yahdlc_state.fcs32 = deadcom->config.fcs32;
+
+    // Initialize synchronization objects
+    if (!deadcom->t->mutexInit(deadcom->mutex_p)) {return DC_FAILURE;}
+    if (!deadcom->t->condvarInit(deadcom->condvar_p)) {return DC_FAILURE;}
+
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcConnect(DeadcomL2 *deadcom) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+
+    if (deadcom->state == DC_CONNECTED) {
+        // no-op then
+        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+        return DC_OK;
+    } else if (deadcom->state == DC_CONNECTING) {
+        // some other thread is attempting connection
+        // ext method retcode does not matter, we are signaling failure either way
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
+    }
+
+    deadcom->state = DC_CONNECTING;
+
+    // Construct a CONN frame and transmit it
+    yahdlc_control_t control_connect = {
+        .frame = YAHDLC_FRAME_CONN,
+        .extended = deadcom->request_extended_mode
+    };
+    if (!transmitFrame(deadcom, &control_connect, NULL, 0)) {
+        deadcom->state = DC_DISCONNECTED;
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
+    }
+
+    // Wait on conditional variable. This condvar will be signaled once the other station has
+    // acknowledged our connection request (or decided to initiate connection at the same time).
+    bool timed_out = false;
+    if (!deadcom->t->condvarWait(deadcom->condvar_p, deadcom->config.conn_timeout_ms, &timed_out)) {
+        deadcom->state = DC_DISCONNECTED;
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
+    }
+
+    if (timed_out) {
+        // no response was received.
+        deadcom->state = DC_DISCONNECTED;
+        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+        return DC_NOT_CONNECTED;
+    } else {
+        // Connection successful, reset state variables and transition to connected state
+        resetLink(deadcom);
+        deadcom->state = DC_CONNECTED;
+        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {
+            deadcom->state = DC_DISCONNECTED;
+            return DC_FAILURE;
+        }
+        return DC_OK;
+    }
+}
+
+
+DeadcomL2Result dcDisconnect(DeadcomL2 *deadcom) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+
+    if (deadcom->state == DC_CONNECTING) {
+        // Cant disconnect connecting link
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
+    }
+
+    if (deadcom->state == DC_CONNECTED) {
+        // Report messages sent by dcSendMessageAsync and not acknowledged yet as lost
+        resetLink(deadcom);
+    }
+    deadcom->state = DC_DISCONNECTED;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetWindowSize(DeadcomL2 *deadcom, uint8_t window_size) {
+    if (deadcom == NULL || window_size == 0 || window_size > deadcom->config.window_slots) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->window_size = window_size;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetExtendedMode(DeadcomL2 *deadcom, bool extended) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->request_extended_mode = extended;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetSelectiveReject(DeadcomL2 *deadcom, bool selective) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->selectiveReject = selective;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetDelayedAck(DeadcomL2 *deadcom, bool delayed) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->delayAcks = delayed;
+    if (!delayed && !transmitPendingAck(deadcom)) {
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetEarlyAck(DeadcomL2 *deadcom, bool early) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->earlyAcks = early;
+    // Messages already waiting in the receive queue are acknowledged now
+    if (early && deadcom->rxQueueCount > 0) {
+        deadcom->ackPending = true;
+        if (!deadcom->delayAcks && !transmitPendingAck(deadcom)) {
+            deadcom->t->mutexUnlock(deadcom->mutex_p);
+            return DC_FAILURE;
+        }
+    }
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetMessageCallback(DeadcomL2 *deadcom,
+                                     void (*onMessage)(const uint8_t*, size_t, void*),
+                                     void *context) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->onMessage = onMessage;
+    deadcom->onMessageContext = context;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetReceiveCondvar(DeadcomL2 *deadcom, void *condvar_p) {
+    if (deadcom == NULL || condvar_p == NULL || condvar_p == deadcom->condvar_p) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    if (!deadcom->t->condvarInit(condvar_p)) {
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
+    }
+    deadcom->rxCondvar_p = condvar_p;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetEventCallback(DeadcomL2 *deadcom, void (*onEvent)(void*), void *context) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->onEvent = onEvent;
+    deadcom->eventContext = context;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetTransmitVec(DeadcomL2 *deadcom,
+                                 bool (*transmitVec)(const yahdlc_iovec_t*, size_t, void*)) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->transmitVec = transmitVec;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetTransmitQueue(DeadcomL2 *deadcom, void (*onTransmitPending)(void*),
+                                   void *context) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->onTransmitPending = onTransmitPending;
+    deadcom->transmitPendingContext = context;
+    // Frames still waiting in the queue are lost
+    deadcom->txQueueCount = 0;
+    deadcom->txWindowSent = framesInFlight(deadcom);
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+DeadcomL2Result dcSetRetransmitTimeoutBounds(DeadcomL2 *deadcom, uint32_t min_ms,
+                                             uint32_t max_ms) {
+    if (deadcom == NULL || min_ms == 0 || max_ms < min_ms) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    deadcom->config.rto_min_ms = min_ms;
+    deadcom->config.rto_max_ms = max_ms;
+    deadcom->rto = clampRto(deadcom, deadcom->rto);
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
 
-    // Initialize synchronization objects
-    if (!deadcom->t->mutexInit(deadcom->mutex_p)) {return DC_FAILURE;}
-    if (!deadcom->t->condvarInit(deadcom->condvar_p)) {return DC_FAILURE;}
 
+DeadcomL2Result dcGetRttEstimate(DeadcomL2 *deadcom, uint32_t *srtt_ms, uint32_t *rttvar_ms,
+                                 uint32_t *rto_ms) {
+    if (deadcom == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    if (srtt_ms != NULL) {
+        *srtt_ms = deadcom->srtt >> 3;
+    }
+    if (rttvar_ms != NULL) {
+        *rttvar_ms = deadcom->rttvar >> 2;
+    }
+    if (rto_ms != NULL) {
+        *rto_ms = deadcom->rto;
+    }
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
     return DC_OK;
 }
 
 
-DeadcomL2Result dcConnect(DeadcomL2 *deadcom) {
-    if (deadcom == NULL) {
+DeadcomL2Result dcSendMessage(DeadcomL2 *deadcom, const uint8_t *message, size_t message_len) {
+    if (deadcom == NULL || message == NULL || message_len == 0) {
         return DC_FAILURE;
     }
     if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
 
-    if (deadcom->state == DC_CONNECTED) {
-        // no-op then
-        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
-        return DC_OK;
-    } else if (deadcom->state == DC_CONNECTING) {
-        // some other thread is attempting connection
-        // ext method retcode does not matter, we are signaling failure either way
+    if (deadcom->state == DC_TRANSMITTING) {
+        // Another thread is already awaiting reponse on a message, we can't transmit another
         deadcom->t->mutexUnlock(deadcom->mutex_p);
         return DC_FAILURE;
+    } else if (deadcom->state != DC_CONNECTED) {
+        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+        return DC_NOT_CONNECTED;
     }
 
-    deadcom->state = DC_CONNECTING;
+    if (deadcom->txWindowLost) {
+        // Previously transmitted messages were lost when the other station reset the link
+        deadcom->txWindowLost = false;
+        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+        return DC_LINK_RESET;
+    }
 
-    // Construct a CONN frame and transmit it
-    yahdlc_control_t control_connect = {
-        .frame = YAHDLC_FRAME_CONN
-    };
-    // Calculate frame size
-    size_t frame_length = 0;
-    yahdlc_frame_data(&control_connect, NULL, 0, NULL, &frame_length);
+    // Messages longer than one frame are sent in fragments, each of them in its own window slot
+    DeadcomL2Result result = DC_OK;
+    size_t offset = 0;
+    while (result == DC_OK && offset < message_len) {
+        size_t fragment_len = message_len - offset;
+        if (fragment_len > deadcom->config.max_payload_len) {
+            fragment_len = deadcom->config.max_payload_len;
+        }
 
-    // Create the frame
-    uint8_t frame_data[frame_length];
-    yahdlc_frame_data(&control_connect, NULL, 0, frame_data, &frame_length);
+        // Wait for a free slot in the transmit window
+        result = awaitAcknowledgments(deadcom, effectiveWindowSize(deadcom) - 1);
+        if (result != DC_OK) {
+            break;
+        }
 
-    if (!deadcom->transmitBytes(frame_data, frame_length, deadcom->transmission_context_p)) {
-        deadcom->state = DC_DISCONNECTED;
-        deadcom->t->mutexUnlock(deadcom->mutex_p);
-        return DC_FAILURE;
+        bool more = offset + fragment_len < message_len;
+        if (!transmitNewFrame(deadcom, message + offset, fragment_len, more, NULL, NULL)) {
+            deadcom->t->mutexUnlock(deadcom->mutex_p);
+            return DC_FAILURE;
+        }
+        offset += fragment_len;
+
+        if (effectiveWindowSize(deadcom) == 1) {
+            // Stop-and-wait, continue only after the fragment is acknowledged
+            result = awaitAcknowledgments(deadcom, 0);
+        }
     }
 
-    // Wait on conditional variable. This condvar will be signaled once the other station has
-    // acknowledged our connection request (or decided to initiate connection at the same time).
-    bool timed_out = false;
-    if (!deadcom->t->condvarWait(deadcom->condvar_p, DEADCOM_CONN_TIMEOUT_MS, &timed_out)) {
-        deadcom->state = DC_DISCONNECTED;
-        deadcom->t->mutexUnlock(deadcom->mutex_p);
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return result;
+}
+
+
+DeadcomL2Result dcSendMessageAsync(DeadcomL2 *deadcom, const uint8_t *message, size_t message_len,
+                                   void (*onComplete)(DeadcomL2Result, void*), void *context) {
+    if (deadcom == NULL || message == NULL || message_len == 0 ||
+        message_len > deadcom->config.max_payload_len || onComplete == NULL) {
         return DC_FAILURE;
     }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
 
-    if (timed_out) {
-        // no response was received.
-        deadcom->state = DC_DISCONNECTED;
-        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
-        return DC_NOT_CONNECTED;
+    DeadcomL2Result result = DC_OK;
+    if (deadcom->state == DC_TRANSMITTING ||
+        framesInFlight(deadcom) >= effectiveWindowSize(deadcom)) {
+        // Another thread is waiting for the window, or there is no room in it
+        result = DC_BUSY;
+    } else if (deadcom->state != DC_CONNECTED) {
+        result = DC_NOT_CONNECTED;
     } else {
-        // Connection successful, reset state variables and transition to connected state
-        resetLink(deadcom);
-        deadcom->state = DC_CONNECTED;
-        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {
-            deadcom->state = DC_DISCONNECTED;
+        if (!transmitNewFrame(deadcom, message, message_len, false, onComplete, context)) {
+            deadcom->t->mutexUnlock(deadcom->mutex_p);
             return DC_FAILURE;
         }
-        return DC_OK;
     }
+
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return result;
 }
 
 
-DeadcomL2Result dcDisconnect(DeadcomL2 *deadcom) {
+DeadcomL2Result dcTick(DeadcomL2 *deadcom, uint32_t now_ms) {
     if (deadcom == NULL) {
         return DC_FAILURE;
     }
     if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
 
-    if (deadcom->state == DC_CONNECTING) {
-        // Cant disconnect connecting link
-        deadcom->t->mutexUnlock(deadcom->mutex_p);
-        return DC_FAILURE;
+    deadcom->tickTime = now_ms;
+    deadcom->ticking = true;
+    if (deadcom->state == DC_CONNECTED) {
+        // Acknowledgment held back since the last tick did not ride on any DATA frame
+        bool transmitted = transmitPendingAck(deadcom);
+
+        // Recover from lost frames or acknowledgments. While some thread waits for
+        // acknowledgments (DC_TRANSMITTING state) it takes care of this itself.
+        if (transmitted && framesInFlight(deadcom) > 0 &&
+            (int32_t)(now_ms - deadcom->ackDeadline) >= 0) {
+            deadcom->failure_count++;
+            if (deadcom->failure_count >= deadcom->config.max_failure_count) {
+                // the other station is unresponsive, reset the link.
+                resetLink(deadcom);
+            } else {
+                backoffRto(deadcom);
+                transmitted = retransmitWindow(deadcom);
+                deadcom->ackDeadline = now_ms + deadcom->rto;
+            }
+        }
+
+        if (!transmitted) {
+            deadcom->t->mutexUnlock(deadcom->mutex_p);
+            return DC_FAILURE;
+        }
     }
 
-    deadcom->state = DC_DISCONNECTED;
     if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
     return DC_OK;
 }
 
 
-DeadcomL2Result dcSendMessage(DeadcomL2 *deadcom, const uint8_t *message, size_t message_len) {
-    if (deadcom == NULL || message == NULL || message_len == 0 ||
-        message_len > DEADCOM_PAYLOAD_MAX_LEN) {
+DeadcomL2Result dcFlush(DeadcomL2 *deadcom) {
+    if (deadcom == NULL) {
         return DC_FAILURE;
     }
     if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
 
     if (deadcom->state == DC_TRANSMITTING) {
-        // We are already awaiting reponse on a message, we can't transmit another
         deadcom->t->mutexUnlock(deadcom->mutex_p);
         return DC_FAILURE;
     } else if (deadcom->state != DC_CONNECTED) {
@@ -138,69 +1278,77 @@ DeadcomL2Result dcSendMessage(DeadcomL2 *deadcom, const uint8_t *message, size_t
         return DC_NOT_CONNECTED;
     }
 
-    yahdlc_control_t control = {
-        .frame = YAHDLC_FRAME_DATA,
-        .send_seq_no = deadcom->send_number,
-        .recv_seq_no = deadcom->recv_number
-    };
-    deadcom->send_number = (deadcom->send_number + 1) % 8;
-    deadcom->failure_count = 0;
-    deadcom->state = DC_TRANSMITTING;
+    DeadcomL2Result result;
+    if (deadcom->txWindowLost) {
+        deadcom->txWindowLost = false;
+        result = DC_LINK_RESET;
+    } else {
+        result = awaitAcknowledgments(deadcom, 0);
+    }
 
-    size_t frame_len;
-    if (yahdlc_frame_data(&control, message, message_len, NULL, &frame_len) != -EINVAL) {
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return result;
+}
 
-        uint8_t frame[frame_len];
-        yahdlc_frame_data(&control, message, message_len, frame, &frame_len);
 
-        bool transmit_success = false;
-        deadcom->failure_count = 0;
-        while (deadcom->failure_count < DEADCOM_MAX_FAILURE_COUNT) {
+/**
+ * Pick up the oldest received message (or just get its length if `buffer` is NULL), with the link
+ * locked. See dcGetReceivedMsg.
+ */
+static DeadcomL2Result pickUpMessage(DeadcomL2 *deadcom, uint8_t *buffer, size_t *msg_len) {
+    if (deadcom->state == DC_DISCONNECTED || deadcom->state == DC_CONNECTING) {
+        *msg_len = 0;
+        return DC_NOT_CONNECTED;
+    }
 
-            if (!deadcom->transmitBytes(frame, frame_len, deadcom->transmission_context_p)) {
-                deadcom->state = DC_CONNECTED;
-                deadcom->send_number = (deadcom->send_number + 7) % 8;
-                deadcom->t->mutexUnlock(deadcom->mutex_p);
-                return DC_FAILURE;
-            }
-            bool timed_out;
-            if (!deadcom->t->condvarWait(deadcom->condvar_p, DEADCOM_ACK_TIMEOUT_MS, &timed_out)) {
-                deadcom->state = DC_CONNECTED;
-                deadcom->send_number = (deadcom->send_number + 7) % 8;
-                deadcom->t->mutexUnlock(deadcom->mutex_p);
-                return DC_FAILURE;
-            }
+    // Acknowledgment held back since the last call did not ride on any DATA frame, send it now
+    if (!transmitPendingAck(deadcom)) {
+        return DC_FAILURE;
+    }
 
-            if (!timed_out) {
-                if (deadcom->last_response == DC_RESP_OK) {
-                    transmit_success = true;
-                    break;
-                } else if (deadcom->last_response == DC_RESP_NOLINK) {
-                    // The other station dropped link. Let's drop ours
-                    transmit_success = false;
-                    break;
-                }
+    if (deadcom->rxQueueCount == 0) {
+        *msg_len = 0;
+        return DC_OK;
+    }
+
+    const uint8_t *message = rxQueueSlot(deadcom, deadcom->rxQueueStart);
+    *msg_len = deadcom->rxQueueLen[deadcom->rxQueueStart];
+    if (deadcom->rxReassembled) {
+        // The oldest message was reassembled from fragments
+        message = deadcom->config.reassembly_buffer;
+        *msg_len = deadcom->rxReassemblyLen;
+    }
+
+    if (buffer != NULL) {
+        memcpy(buffer, message, *msg_len);
+        deadcom->rxReassembled = false;
+        deadcom->rxQueueLen[deadcom->rxQueueStart] = 0;
+        deadcom->rxQueueStart = (deadcom->rxQueueStart + 1) % deadcom->config.rx_queue_slots;
+        deadcom->rxQueueCount--;
+
+        // acknowledge reception and frame processing. If we had to discard subsequent frames
+        // because the receive queue was full, reject them once all queued messages are
+        // acknowledged so that the other station retransmits them right away. Otherwise the
+        // acknowledgment may be held back until the next call of this function, so that it can
+        // ride on a DATA frame sent in the meantime, unless the other station holds back its
+        // frames since we reported that we are not ready. Messages acknowledged early only need
+        // the latter.
+        bool transmitted = true;
+        if (deadcom->rxDiscarded && unacknowledgedCount(deadcom) == 0) {
+            deadcom->rxDiscarded = false;
+            transmitted = transmitReject(deadcom);
+        } else if (!deadcom->earlyAcks || deadcom->rxNotReady) {
+            deadcom->ackPending = true;
+            if (!deadcom->delayAcks || deadcom->rxNotReady) {
+                transmitted = transmitPendingAck(deadcom);
             }
-            deadcom->failure_count++;
         }
-
-        if (transmit_success) {
-            // last_acked number was updated by receive thread when handling DC_ACK response
-            deadcom->state = DC_CONNECTED;
-            if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
-            return DC_OK;
-        } else {
-            // the other station is unresponsive, reset the link.
-            resetLink(deadcom);
-            if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
-            return DC_LINK_RESET;
+        if (!transmitted) {
+            return DC_FAILURE;
         }
-
-    } else {
-        // Invalid parameters passwd to frame_data function
-        deadcom->t->mutexUnlock(deadcom->mutex_p);
-        return DC_FAILURE;
     }
+
+    return DC_OK;
 }
 
 
@@ -211,48 +1359,73 @@ DeadcomL2Result dcGetReceivedMsg(DeadcomL2 *deadcom, uint8_t *buffer, size_t *ms
 
     if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
 
-    if (deadcom->state == DC_DISCONNECTED || deadcom->state == DC_CONNECTING) {
-        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
-        *msg_len = 0;
-        return DC_NOT_CONNECTED;
+    DeadcomL2Result result = pickUpMessage(deadcom, buffer, msg_len);
+    if (result == DC_FAILURE) {
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
     }
 
-    if (!deadcom->extractionComplete) {
-        *msg_len = 0;
-        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
-        return DC_OK;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {
+        return DC_FAILURE;
     }
 
-    *msg_len = deadcom->extractionBufferSize;
+    return result;
+}
 
-    if (buffer != NULL) {
-        memcpy(buffer, deadcom->extractionBuffer, deadcom->extractionBufferSize);
 
-        // acknowledge reception and frame processing
-        yahdlc_control_t control_ack = {
-            .frame = YAHDLC_FRAME_ACK,
-            .recv_seq_no = (deadcom->recv_number + 7) % 8
-        };
+DeadcomL2Result dcWaitMessage(DeadcomL2 *deadcom, uint8_t *buffer, size_t buffer_len,
+                              size_t *msg_len, uint32_t timeout_ms) {
+    if (deadcom == NULL || buffer == NULL || msg_len == NULL) {
+        return DC_FAILURE;
+    }
+
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
 
-        size_t ack_frame_length;
-        yahdlc_frame_data(&control_ack, NULL, 0, NULL, &ack_frame_length);
+    if (deadcom->rxCondvar_p == NULL) {
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
+        return DC_FAILURE;
+    }
 
-        uint8_t ack_frame[ack_frame_length];
-        yahdlc_frame_data(&control_ack, NULL, 0, ack_frame, &ack_frame_length);
-        if (!deadcom->transmitBytes(ack_frame, ack_frame_length, deadcom->transmission_context_p)) {
+    // Without a clock the remaining time can't be tracked, so we give up after the first wake-up
+    // that brought no message
+    uint32_t start = 0;
+    bool clock = deadcom->t->getTimeMs != NULL;
+    if (clock) {
+        start = deadcom->t->getTimeMs();
+    }
+    uint32_t remaining = timeout_ms;
+    while (deadcom->state == DC_CONNECTED || deadcom->state == DC_TRANSMITTING) {
+        if (deadcom->rxQueueCount > 0 || remaining == 0) {
+            break;
+        }
+        bool timed_out;
+        if (!deadcom->t->condvarWait(deadcom->rxCondvar_p, remaining, &timed_out)) {
             deadcom->t->mutexUnlock(deadcom->mutex_p);
             return DC_FAILURE;
         }
-
-        deadcom->extractionBufferSize = 0;
-        deadcom->extractionComplete = false;
+        if (timed_out || !clock) {
+            remaining = 0;
+        } else {
+            uint32_t elapsed = deadcom->t->getTimeMs() - start;
+            remaining = (elapsed < timeout_ms) ? timeout_ms - elapsed : 0;
+        }
     }
 
-    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {
+    // Leave the message pending if it does not fit, so that the caller can retry with a bigger
+    // buffer
+    DeadcomL2Result result = pickUpMessage(deadcom, NULL, msg_len);
+    if (result == DC_OK && *msg_len > buffer_len) {
+        result = DC_FAILURE;
+    } else if (result == DC_OK && *msg_len > 0) {
+        result = pickUpMessage(deadcom, buffer, msg_len);
+    }
+    if (result == DC_FAILURE) {
+        deadcom->t->mutexUnlock(deadcom->mutex_p);
         return DC_FAILURE;
     }
 
-    return DC_OK;
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return result;
 }
 
 
@@ -263,9 +1436,10 @@ DeadcomL2Result dcProcessData(DeadcomL2 *deadcom, const uint8_t *data, size_t le
 
     if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
 
+    uint8_t queued = deadcom->rxQueueCount;
     size_t processed = 0;
     while (processed < len) {
-        yahdlc_control_t frame_control;
+        yahdlc_control_t frame_control = {0};
         size_t dest_len = 0;
         int yahdlc_result = yahdlc_get_data(&(deadcom->yahdlc_state), &frame_control,
                                             data+processed, len-processed,
@@ -277,6 +1451,10 @@ DeadcomL2Result dcProcessData(DeadcomL2 *deadcom, const uint8_t *data, size_t le
         } else if (yahdlc_result == -EIO) {
             // Invalid frame checksum we should discard `processed_bytes` from the buffer
             processed += dest_len;
+            if (!rejectCorrupted(deadcom)) {
+                deadcom->t->mutexUnlock(deadcom->mutex_p);
+                return DC_FAILURE;
+            }
         } else if (yahdlc_result == -ENOMSG) {
             // This buffer did not contain end-of-frame mark. It was parsed and we may
             // discard it.
@@ -287,71 +1465,183 @@ DeadcomL2Result dcProcessData(DeadcomL2 *deadcom, const uint8_t *data, size_t le
             // bytes from the buffer
             processed += yahdlc_result;
             yahdlc_control_t resp_ctrl;
+            bool wasBusy;
             switch (frame_control.frame) {
                 case YAHDLC_FRAME_DATA:
                     // We should process DATA frames only if we are connected
                     if (deadcom->state == DC_CONNECTED || deadcom->state == DC_TRANSMITTING) {
+                        // N(R) of DATA frame is the number of the next frame the other station
+                        // expects, therefore it acknowledges all frames before it.
+                        uint8_t modulo = seqModulo(deadcom);
+                        uint8_t acked = (frame_control.recv_seq_no + modulo - 1) % modulo;
+                        if (!processAck(deadcom, acked)) {
+                            deadcom->t->mutexUnlock(deadcom->mutex_p);
+                            return DC_FAILURE;
+                        }
+
+                        // How many frames did we receive in sequence after this one?
+                        uint8_t age = (deadcom->recv_number + modulo - 1 -
+                                       frame_control.send_seq_no) % modulo;
+
                         if (frame_control.send_seq_no == deadcom->recv_number) {
-                            if (deadcom->extractionBufferSize == 0 && dest_len != 0) {
-                                deadcom->extractionBufferSize = dest_len;
-                                deadcom->extractionComplete = true;
-                                memcpy(deadcom->extractionBuffer, deadcom->scratchpadBuffer,
+                            if (dest_len != 0 &&
+                                (frame_control.more || deadcom->rxReassembling)) {
+                                if (!receiveFragment(deadcom, deadcom->scratchpadBuffer, dest_len,
+                                                     frame_control.more)) {
+                                    deadcom->t->mutexUnlock(deadcom->mutex_p);
+                                    return DC_FAILURE;
+                                }
+                            } else if (deadcom->onMessage != NULL && deadcom->rxQueueCount == 0 &&
+                                       dest_len != 0) {
+                                // Hand the message over right from the scratchpad, it is picked up
+                                // once the callback returns
+                                receivedInSequence(deadcom);
+                                deadcom->rxQueueStart = (deadcom->rxQueueStart + 1) %
+                                                        deadcom->config.rx_queue_slots;
+                                deadcom->onMessage(deadcom->scratchpadBuffer, dest_len,
+                                                   deadcom->onMessageContext);
+                                deadcom->ackPending = true;
+                                if (!deadcom->delayAcks && !transmitPendingAck(deadcom)) {
+                                    deadcom->t->mutexUnlock(deadcom->mutex_p);
+                                    return DC_FAILURE;
+                                }
+                            } else if (deadcom->rxQueueCount < deadcom->config.rx_queue_slots &&
+                                       dest_len != 0) {
+                                uint8_t slot = (deadcom->rxQueueStart + deadcom->rxQueueCount) %
+                                               deadcom->config.rx_queue_slots;
+                                memcpy(rxQueueSlot(deadcom, slot), deadcom->scratchpadBuffer,
                                        dest_len);
-                                deadcom->recv_number = (deadcom->recv_number + 1) % 8;
+                                deadcom->rxQueueLen[slot] = dest_len;
+                                deadcom->rxQueueCount++;
+                                // The other station went back, nothing is missing any more
+                                receivedInSequence(deadcom);
+                                deadcom->ackPending = deadcom->ackPending || deadcom->earlyAcks;
+                            } else if (dest_len != 0) {
+                                // The receive queue is full. We have to discard this frame, and
+                                // we will reject it once the queued messages are picked up (again,
+                                // if it was a response to our reject). Until then the other
+                                // station should hold back.
+                                deadcom->rxDiscarded = true;
+                                if (!transmitNotReady(deadcom)) {
+                                    deadcom->t->mutexUnlock(deadcom->mutex_p);
+                                    return DC_FAILURE;
+                                }
                             }
-                            // else: there already is a message in the extraction buffer. That means
-                            // that the other station has sent a frame without waiting for ack on
-                            // the previous frame. We will therefore ignore it.
-                        } else if (!deadcom->extractionComplete &&
-                                   (frame_control.send_seq_no + 1) % 8 == deadcom->recv_number) {
+                            // Frames received out of sequence may have been waiting for this one.
+                            // With early acknowledgments, the queued frames are acknowledged at once.
+                            if (!collectReordered(deadcom) ||
+                                (!deadcom->delayAcks && !transmitPendingAck(deadcom))) {
+                                deadcom->t->mutexUnlock(deadcom->mutex_p);
+                                return DC_FAILURE;
+                            }
+                        } else if (age == unacknowledgedCount(deadcom)) {
                             // We've seen and previously acked this frame. Since we've received
-                            // again that ack must've gotten lost, so retransmit it.
-                            yahdlc_control_t control_ack = {
-                                .frame = YAHDLC_FRAME_ACK,
-                                .recv_seq_no = (deadcom->recv_number + 7) % 8
-                            };
-
-                            size_t ack_frame_length;
-                            yahdlc_frame_data(&control_ack, NULL, 0, NULL, &ack_frame_length);
-
-                            uint8_t ack_frame[ack_frame_length];
-                            yahdlc_frame_data(&control_ack, NULL, 0, ack_frame, &ack_frame_length);
-                            if (!deadcom->transmitBytes(ack_frame, ack_frame_length,
-                                deadcom->transmission_context_p)) {
+                            // again that ack must've gotten lost (or was held back for too long),
+                            // so retransmit it.
+                            if (!transmitAck(deadcom, frame_control.send_seq_no)) {
+                                deadcom->t->mutexUnlock(deadcom->mutex_p);
+                                return DC_FAILURE;
+                            }
+                        } else if (age < unacknowledgedCount(deadcom)) {
+                            // Retransmission of a frame waiting in the receive queue. It will be
+                            // acknowledged once the application picks it up, until then tell the
+                            // other station that we are alive, just not ready.
+                            if (!transmitNotReady(deadcom)) {
                                 deadcom->t->mutexUnlock(deadcom->mutex_p);
                                 return DC_FAILURE;
                             }
+                        } else {
+                            // It is an out-of-sequence frame, some frames before it got lost.
+                            // Reject it so that the other station goes back right away instead of
+                            // waiting for acknowledgment timeout. While our reject is outstanding
+                            // the frames keep coming out of sequence, but if they start over from
+                            // an earlier one, the other station went back and the missing frame
+                            // got lost again, so it has to be rejected again. With selective
+                            // reject we keep the frame and reject just the missing ones instead.
+                            uint8_t ahead = (frame_control.send_seq_no + modulo -
+                                             deadcom->recv_number) % modulo;
+                            bool wentBack = ahead < deadcom->rxRejectedAhead;
+                            deadcom->rxRejectedAhead = ahead;
+                            if (canKeepOutOfSequence(deadcom, ahead, dest_len,
+                                                     frame_control.more)) {
+                                if (!keepOutOfSequence(deadcom, ahead, dest_len, wentBack)) {
+                                    deadcom->t->mutexUnlock(deadcom->mutex_p);
+                                    return DC_FAILURE;
+                                }
+                            } else if (!deadcom->rxRejected || wentBack) {
+                                if (unacknowledgedCount(deadcom) > 0 || deadcom->rxDiscarded) {
+                                    deadcom->rxDiscarded = true;
+                                } else if (!transmitReject(deadcom)) {
+                                    deadcom->t->mutexUnlock(deadcom->mutex_p);
+                                    return DC_FAILURE;
+                                }
+                            }
                         }
-                        // else: It is an out-of-sequence frame, it is safe to ignore.
                     }
                     break;
                 case YAHDLC_FRAME_ACK:
-                    // We should process ACK frames only if we are transmitting (and therefore
-                    // expecting them)
-                    if (deadcom->state == DC_TRANSMITTING) {
-                        if (frame_control.recv_seq_no == deadcom->next_expected_ack) {
-                            // Correct acknowledgment.
-                            deadcom->next_expected_ack = (deadcom->next_expected_ack + 1) % 8;
-                            deadcom->last_response = DC_RESP_OK;
-                            if (!deadcom->t->condvarSignal(deadcom->condvar_p)) {
-                                deadcom->t->mutexUnlock(deadcom->mutex_p);
-                                return DC_FAILURE;
-                            }
+                    // We should process ACK frames only if we are connected and have some frames
+                    // awaiting acknowledgment. Acknowledgments are cumulative: N(R) acknowledges
+                    // that frame and all frames transmitted before it. ACK also means that the
+                    // other station is ready to receive.
+                    if (deadcom->state == DC_CONNECTED || deadcom->state == DC_TRANSMITTING) {
+                        deadcom->peerBusy = false;
+                        if (!processAck(deadcom, frame_control.recv_seq_no)) {
+                            deadcom->t->mutexUnlock(deadcom->mutex_p);
+                            return DC_FAILURE;
+                        }
+                    }
+                    break;
+                case YAHDLC_FRAME_RNR:
+                    // The other station is alive, but its receive queue is full. N(R) acknowledges
+                    // frames its application has picked up. Until it is ready again, only the
+                    // oldest frame is retransmitted to poll it, and retransmissions it answers
+                    // don't count as failures, so a slow application does not reset the link.
+                    if (deadcom->state == DC_CONNECTED || deadcom->state == DC_TRANSMITTING) {
+                        deadcom->peerBusy = true;
+                        deadcom->failure_count = 0;
+                        if (!processAck(deadcom, frame_control.recv_seq_no)) {
+                            deadcom->t->mutexUnlock(deadcom->mutex_p);
+                            return DC_FAILURE;
                         }
-                        // Discard incorrect acknowledgment.
                     }
                     break;
                 case YAHDLC_FRAME_NACK:
-                    // We should process NACK frames only if we are transmitting (and therefore
-                    // expecting them)
-                    if (deadcom->state == DC_TRANSMITTING) {
-                        // The other station has received some garbage and is proactively requesting
-                        // retransmission
+                    // The other station has received some garbage (or had to discard some frames)
+                    // and is proactively requesting retransmission. N(R) acknowledges frames it
+                    // has received correctly. It is ready to receive again. If it was busy, it
+                    // just asks for frames it had no room for, which is no transmission failure.
+                    wasBusy = deadcom->peerBusy;
+                    if (deadcom->state == DC_CONNECTED || deadcom->state == DC_TRANSMITTING) {
+                        deadcom->peerBusy = false;
+                    }
+                    if (deadcom->state == DC_TRANSMITTING && !wasBusy) {
+                        acknowledgeFrames(deadcom, frame_control.recv_seq_no);
+                        // Thread waiting for acknowledgment will retransmit the rest
                         deadcom->last_response = DC_RESP_REJECT;
                         if (!deadcom->t->condvarSignal(deadcom->condvar_p)) {
                             deadcom->t->mutexUnlock(deadcom->mutex_p);
                             return DC_FAILURE;
                         }
+                    } else if ((deadcom->state == DC_CONNECTED ||
+                                deadcom->state == DC_TRANSMITTING) && framesInFlight(deadcom) > 0) {
+                        acknowledgeFrames(deadcom, frame_control.recv_seq_no);
+                        // Nobody is waiting for acknowledgments (or the waiting thread would count
+                        // it as a failure), go back N right away
+                        if (!retransmitWindow(deadcom)) {
+                            deadcom->t->mutexUnlock(deadcom->mutex_p);
+                            return DC_FAILURE;
+                        }
+                        deadcom->ackDeadline = deadcom->tickTime + deadcom->rto;
+                    }
+                    break;
+                case YAHDLC_FRAME_SREJ:
+                    // The other station has received frames following frame N(R), but not that one.
+                    // It does not acknowledge anything, just retransmit that frame.
+                    if ((deadcom->state == DC_CONNECTED || deadcom->state == DC_TRANSMITTING) &&
+                        !retransmitSelected(deadcom, frame_control.recv_seq_no)) {
+                        deadcom->t->mutexUnlock(deadcom->mutex_p);
+                        return DC_FAILURE;
                     }
                     break;
                 case YAHDLC_FRAME_CONN:
@@ -359,27 +1649,31 @@ DeadcomL2Result dcProcessData(DeadcomL2 *deadcom, const uint8_t *data, size_t le
                     // and transmit CONN_ACK frame (even if we already were in the CONNETED mode,
                     // the other station has obviously thought otherwise).
                     resp_ctrl.frame = YAHDLC_FRAME_CONN_ACK;
-
-                    size_t f_len = 0;
-                    if (yahdlc_frame_data(&resp_ctrl, NULL, 0, NULL, &f_len) == -EINVAL) {
+                    if (!transmitFrame(deadcom, &resp_ctrl, NULL, 0)) {
                         deadcom->t->mutexUnlock(deadcom->mutex_p);
                         return DC_FAILURE;
                     }
 
-                    {
-                        uint8_t resp_f[f_len];
-                        yahdlc_frame_data(&resp_ctrl, NULL, 0, resp_f, &f_len);
-                        if (!deadcom->transmitBytes(resp_f, f_len,
-                            deadcom->transmission_context_p)) {
-                            deadcom->t->mutexUnlock(deadcom->mutex_p);
-                            return DC_FAILURE;
-                        }
-                    }
-
                     DeadcomL2State original_state = deadcom->state;
+                    bool frames_lost = (original_state == DC_CONNECTED &&
+                                        blockingFramesInFlight(deadcom));
 
                     resetLink(deadcom);
                     deadcom->state = DC_CONNECTED;
+                    deadcom->txWindowLost = frames_lost;
+                    if (original_state == DC_DISCONNECTED) {
+                        // The other station connected the link
+                        notifyEvent(deadcom);
+                    }
+                    if (original_state == DC_CONNECTING) {
+                        // Both stations requested connection at the same time. Use extended mode
+                        // only if both of them asked for it, they will come to the same conclusion.
+                        setExtendedMode(deadcom, frame_control.extended &&
+                                                 deadcom->request_extended_mode);
+                    } else {
+                        // Sequence numbering mode is chosen by the connecting station
+                        setExtendedMode(deadcom, frame_control.extended);
+                    }
 
                     if (original_state == DC_TRANSMITTING) {
                         // We were transmitting when the link reset happened, we need to notify the
@@ -405,6 +1699,9 @@ DeadcomL2Result dcProcessData(DeadcomL2 *deadcom, const uint8_t *data, size_t le
                     // If we are connecting the other station has just accepted our connection.
                     // If we weren't connecting then we can safely ignore this.
                     if (deadcom->state == DC_CONNECTING) {
+                        // The other station has accepted our sequence numbering mode. Switch to
+                        // it right away, DATA frames may follow immediately.
+                        setExtendedMode(deadcom, deadcom->request_extended_mode);
                         deadcom->last_response = DC_RESP_OK;
                         if (!deadcom->t->condvarSignal(deadcom->condvar_p)) {
                             deadcom->t->mutexUnlock(deadcom->mutex_p);
@@ -416,6 +1713,126 @@ DeadcomL2Result dcProcessData(DeadcomL2 *deadcom, const uint8_t *data, size_t le
         }
     }
 
+    // Wake up dcWaitMessage (and the event loop) if a message was stored in the receive queue
+    if (deadcom->rxQueueCount > queued) {
+        notifyEvent(deadcom);
+        if (deadcom->rxCondvar_p != NULL && !deadcom->t->condvarSignal(deadcom->rxCondvar_p)) {
+            deadcom->t->mutexUnlock(deadcom->mutex_p);
+            return DC_FAILURE;
+        }
+    }
+
+    if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return DC_OK;
+}
+
+
+/**
+ * Take the next frame waiting for dcTransmitPending and encode it. Control frames go first, then
+ * the frames of the transmit window which were not transmitted yet. Returns false if there is no
+ * such frame, or if the frame could not be encoded.
+ */
+static bool dequeueFrame(DeadcomL2 *deadcom, const uint8_t **frame, size_t *frame_len) {
+    uint8_t modulo = seqModulo(deadcom);
+    while (deadcom->txQueueCount > 0) {
+        yahdlc_control_t control = deadcom->txQueue[deadcom->txQueueStart];
+        deadcom->txQueueStart = (deadcom->txQueueStart + 1) % DEADCOM_TX_QUEUE_SIZE;
+        deadcom->txQueueCount--;
+        if (control.frame != YAHDLC_FRAME_DATA) {
+            return encodeFrame(deadcom, &control, NULL, 0, frame, frame_len);
+        }
+        // Selective retransmission is dropped if the frame was acknowledged in the meantime, or if
+        // the whole window is being retransmitted and the frame was not transmitted again yet
+        uint8_t offset = (control.send_seq_no + modulo - deadcom->next_expected_ack) % modulo;
+        if (offset < deadcom->txWindowSent) {
+            return encodeWindowFrame(deadcom, offset, frame, frame_len);
+        }
+    }
+    if (deadcom->txWindowSent >= framesInFlight(deadcom)) {
+        return false;
+    }
+    return encodeWindowFrame(deadcom, deadcom->txWindowSent++, frame, frame_len);
+}
+
+
+DeadcomL2Result dcTransmitPending(DeadcomL2 *deadcom) {
+    if (deadcom == NULL || deadcom->onTransmitPending == NULL) {
+        return DC_FAILURE;
+    }
+    if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+    if (deadcom->txDraining) {
+        // Another thread is already transmitting and will pick up the new frames too
+        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+        return DC_OK;
+    }
+    deadcom->txDraining = true;
+
+    const uint8_t *frame;
+    size_t frame_len;
+    DeadcomL2Result result = DC_OK;
+    while (dequeueFrame(deadcom, &frame, &frame_len)) {
+        // txFrame is not touched by anyone else while txDraining is set
+        if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+        bool written = writeFrame(deadcom, frame, frame_len);
+        if (!deadcom->t->mutexLock(deadcom->mutex_p)) {return DC_FAILURE;}
+        if (!written) {
+            result = DC_FAILURE;
+            break;
+        }
+    }
+
+    deadcom->txDraining = false;
     if (!deadcom->t->mutexUnlock(deadcom->mutex_p)) {return DC_FAILURE;}
+    return result;
+}
+
+
+DeadcomL2Result dcRxPush(DeadcomL2 *deadcom, const uint8_t *data, size_t len) {
+    if (deadcom == NULL || data == NULL || deadcom->config.rx_ring == NULL) {
+        return DC_FAILURE;
+    }
+
+    uint8_t *ring = deadcom->config.rx_ring;
+    size_t ring_len = deadcom->config.rx_ring_len;
+    size_t head = deadcom->rxRingHead;
+    // Bytes taken by the draining thread must not be overwritten before it is done with them
+    size_t tail = __atomic_load_n(&(deadcom->rxRingTail), __ATOMIC_ACQUIRE);
+    size_t room = ring_len - (head - tail);
+    size_t stored = len < room ? len : room;
+
+    size_t index = head & (ring_len - 1);
+    size_t first = stored < ring_len - index ? stored : ring_len - index;
+    memcpy(ring + index, data, first);
+    memcpy(ring, data + first, stored - first);
+    // Publish the bytes only after they are copied
+    __atomic_store_n(&(deadcom->rxRingHead), head + stored, __ATOMIC_RELEASE);
+
+    return stored == len ? DC_OK : DC_BUSY;
+}
+
+
+DeadcomL2Result dcRxDrain(DeadcomL2 *deadcom) {
+    if (deadcom == NULL || deadcom->config.rx_ring == NULL) {
+        return DC_FAILURE;
+    }
+
+    uint8_t *ring = deadcom->config.rx_ring;
+    size_t ring_len = deadcom->config.rx_ring_len;
+    size_t tail = deadcom->rxRingTail;
+    size_t head = __atomic_load_n(&(deadcom->rxRingHead), __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        // Bytes up to the end of the ring buffer are processed in place, the rest from its start
+        size_t index = tail & (ring_len - 1);
+        size_t chunk = head - tail < ring_len - index ? head - tail : ring_len - index;
+        DeadcomL2Result res = dcProcessData(deadcom, ring + index, chunk);
+        tail += chunk;
+        // Hand the processed bytes back to the pushing side even if processing has failed
+        __atomic_store_n(&(deadcom->rxRingTail), tail, __ATOMIC_RELEASE);
+        if (res != DC_OK) {
+            return res;
+        }
+    }
+
     return DC_OK;
 }
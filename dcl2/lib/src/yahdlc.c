@@ -38,14 +38,51 @@ This file was modified for use in Project Deadlock (component libdeadcom). Notab
   - Return valid control struct from yahdlc_get_data if and only if return value is >= 0
     (and therefore valid frame was received), so that caller doesn't have to keep track of control
     struct from previous calls when parsing byte-by-byte from serial link.
+  - Support for extended (modulo 128) mode with two-byte control field in I and S frames and
+    SABME command for link establishment
   - Change types to represent the correct semantic meaning: if function takes 8-bit bytes, not a
     string of characters, it should use `uint8_t *b`, not `char *b`. If function takes size of
     buffer as parameter, `size_t` should be used, not `unsigned int`. `unsigned short` is not
     guaranteed to be 16 bits, use `uint16_t` instead.
+  - Received and transmitted data are scanned for flag sequence and control escape bytes with SIMD
+    instructions where available (SSE2, AVX2, NEON), runs of data between them are copied in bulk.
+  - FCS of the runs is computed with slice-by-8 tables, or folded with carry-less multiplication
+    (PCLMULQDQ, PMULL) where available.
+  - Optional CRC-32C FCS for long frames, computed with SSE4.2 or ARMv8 CRC instructions where
+    available.
 */
 
+#include <string.h>
 #include "yahdlc.h"
 
+// Define YAHDLC_NO_SIMD to scan data byte by byte and compute FCS with tables only, even where SIMD
+// instructions are available
+#ifndef YAHDLC_NO_SIMD
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define YAHDLC_SCAN_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define YAHDLC_SCAN_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define YAHDLC_SCAN_NEON
+#endif
+#if defined(__PCLMUL__) && defined(__SSE2__)
+#include <wmmintrin.h>
+#define YAHDLC_FCS_PCLMUL
+#elif defined(__ARM_NEON) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#define YAHDLC_FCS_PMULL
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define YAHDLC_FCS32_SSE42
+#elif defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_acle.h>
+#define YAHDLC_FCS32_ARM
+#endif
+#endif
+
 // HDLC Control field bit positions
 #define YAHDLC_CONTROL_S_OR_U_FRAME_BIT 0
 #define YAHDLC_CONTROL_SEND_SEQ_NO_BIT 1
@@ -54,6 +91,12 @@ This file was modified for use in Project Deadlock (component libdeadcom). Notab
 #define YAHDLC_CONTROL_RECV_SEQ_NO_BIT 5
 #define YAHDLC_CONTROL_U_ONLY_FRAME_BIT 1
 
+// HDLC extended (modulo 128) control field bit positions. Second byte of I and S frame control
+// field contains P/F bit and N(R), first byte of I frame contains N(S).
+#define YAHDLC_CONTROL_EXT_POLL_BIT 0
+#define YAHDLC_CONTROL_EXT_RECV_SEQ_NO_BIT 1
+#define YAHDLC_CONTROL_EXT_SEND_SEQ_NO_BIT 1
+
 // HDLC Control type definitions
 #define YAHDLC_CONTROL_TYPE_RECEIVE_READY 0
 #define YAHDLC_CONTROL_TYPE_RECEIVE_NOT_READY 1
@@ -66,8 +109,11 @@ This file was modified for use in Project Deadlock (component libdeadcom). Notab
 #define YAHDLC_CONTROL_U_TYPE_ADDED_BITS 3
 #define YAHDLC_CONTROL_CONN_SPECIAL_BIT 5
 
+#define YAHDLC_CONTROL_CONN_EXT_BIT 6
+
 #define YAHDLC_U_FRAME_CONN_CHECK 0x01
 #define YAHDLC_U_FRAME_CONN_ACK_CHECK 0x03
+#define YAHDLC_U_FRAME_CONN_EXT_CHECK 0x03
 
 
 static const uint16_t fcstab[256] = { 0x0000, 0x1189, 0x2312, 0x329b,
@@ -101,61 +147,608 @@ static const uint16_t fcstab[256] = { 0x0000, 0x1189, 0x2312, 0x329b,
     0x8330, 0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78
 };
 
-uint16_t fcs16(uint16_t fcs, uint8_t value) {
+// Slice tables, row k - 1 holds FCS of every byte value followed by k zero bytes. Define
+// YAHDLC_FCS_SLICES to 4 or 1 to save space.
+#ifndef YAHDLC_FCS_SLICES
+#define YAHDLC_FCS_SLICES 8
+#endif
+
+#if YAHDLC_FCS_SLICES >= 4
+static const uint16_t fcstab_slice[YAHDLC_FCS_SLICES - 1][256] = {
+    {
+        0x0000, 0x19d8, 0x33b0, 0x2a68, 0x6760, 0x7eb8, 0x54d0, 0x4d08,
+        0xcec0, 0xd718, 0xfd70, 0xe4a8, 0xa9a0, 0xb078, 0x9a10, 0x83c8,
+        0x9591, 0x8c49, 0xa621, 0xbff9, 0xf2f1, 0xeb29, 0xc141, 0xd899,
+        0x5b51, 0x4289, 0x68e1, 0x7139, 0x3c31, 0x25e9, 0x0f81, 0x1659,
+        0x2333, 0x3aeb, 0x1083, 0x095b, 0x4453, 0x5d8b, 0x77e3, 0x6e3b,
+        0xedf3, 0xf42b, 0xde43, 0xc79b, 0x8a93, 0x934b, 0xb923, 0xa0fb,
+        0xb6a2, 0xaf7a, 0x8512, 0x9cca, 0xd1c2, 0xc81a, 0xe272, 0xfbaa,
+        0x7862, 0x61ba, 0x4bd2, 0x520a, 0x1f02, 0x06da, 0x2cb2, 0x356a,
+        0x4666, 0x5fbe, 0x75d6, 0x6c0e, 0x2106, 0x38de, 0x12b6, 0x0b6e,
+        0x88a6, 0x917e, 0xbb16, 0xa2ce, 0xefc6, 0xf61e, 0xdc76, 0xc5ae,
+        0xd3f7, 0xca2f, 0xe047, 0xf99f, 0xb497, 0xad4f, 0x8727, 0x9eff,
+        0x1d37, 0x04ef, 0x2e87, 0x375f, 0x7a57, 0x638f, 0x49e7, 0x503f,
+        0x6555, 0x7c8d, 0x56e5, 0x4f3d, 0x0235, 0x1bed, 0x3185, 0x285d,
+        0xab95, 0xb24d, 0x9825, 0x81fd, 0xccf5, 0xd52d, 0xff45, 0xe69d,
+        0xf0c4, 0xe91c, 0xc374, 0xdaac, 0x97a4, 0x8e7c, 0xa414, 0xbdcc,
+        0x3e04, 0x27dc, 0x0db4, 0x146c, 0x5964, 0x40bc, 0x6ad4, 0x730c,
+        0x8ccc, 0x9514, 0xbf7c, 0xa6a4, 0xebac, 0xf274, 0xd81c, 0xc1c4,
+        0x420c, 0x5bd4, 0x71bc, 0x6864, 0x256c, 0x3cb4, 0x16dc, 0x0f04,
+        0x195d, 0x0085, 0x2aed, 0x3335, 0x7e3d, 0x67e5, 0x4d8d, 0x5455,
+        0xd79d, 0xce45, 0xe42d, 0xfdf5, 0xb0fd, 0xa925, 0x834d, 0x9a95,
+        0xafff, 0xb627, 0x9c4f, 0x8597, 0xc89f, 0xd147, 0xfb2f, 0xe2f7,
+        0x613f, 0x78e7, 0x528f, 0x4b57, 0x065f, 0x1f87, 0x35ef, 0x2c37,
+        0x3a6e, 0x23b6, 0x09de, 0x1006, 0x5d0e, 0x44d6, 0x6ebe, 0x7766,
+        0xf4ae, 0xed76, 0xc71e, 0xdec6, 0x93ce, 0x8a16, 0xa07e, 0xb9a6,
+        0xcaaa, 0xd372, 0xf91a, 0xe0c2, 0xadca, 0xb412, 0x9e7a, 0x87a2,
+        0x046a, 0x1db2, 0x37da, 0x2e02, 0x630a, 0x7ad2, 0x50ba, 0x4962,
+        0x5f3b, 0x46e3, 0x6c8b, 0x7553, 0x385b, 0x2183, 0x0beb, 0x1233,
+        0x91fb, 0x8823, 0xa24b, 0xbb93, 0xf69b, 0xef43, 0xc52b, 0xdcf3,
+        0xe999, 0xf041, 0xda29, 0xc3f1, 0x8ef9, 0x9721, 0xbd49, 0xa491,
+        0x2759, 0x3e81, 0x14e9, 0x0d31, 0x4039, 0x59e1, 0x7389, 0x6a51,
+        0x7c08, 0x65d0, 0x4fb8, 0x5660, 0x1b68, 0x02b0, 0x28d8, 0x3100,
+        0xb2c8, 0xab10, 0x8178, 0x98a0, 0xd5a8, 0xcc70, 0xe618, 0xffc0
+    },
+    {
+        0x0000, 0x5adc, 0xb5b8, 0xef64, 0x6361, 0x39bd, 0xd6d9, 0x8c05,
+        0xc6c2, 0x9c1e, 0x737a, 0x29a6, 0xa5a3, 0xff7f, 0x101b, 0x4ac7,
+        0x8595, 0xdf49, 0x302d, 0x6af1, 0xe6f4, 0xbc28, 0x534c, 0x0990,
+        0x4357, 0x198b, 0xf6ef, 0xac33, 0x2036, 0x7aea, 0x958e, 0xcf52,
+        0x033b, 0x59e7, 0xb683, 0xec5f, 0x605a, 0x3a86, 0xd5e2, 0x8f3e,
+        0xc5f9, 0x9f25, 0x7041, 0x2a9d, 0xa698, 0xfc44, 0x1320, 0x49fc,
+        0x86ae, 0xdc72, 0x3316, 0x69ca, 0xe5cf, 0xbf13, 0x5077, 0x0aab,
+        0x406c, 0x1ab0, 0xf5d4, 0xaf08, 0x230d, 0x79d1, 0x96b5, 0xcc69,
+        0x0676, 0x5caa, 0xb3ce, 0xe912, 0x6517, 0x3fcb, 0xd0af, 0x8a73,
+        0xc0b4, 0x9a68, 0x750c, 0x2fd0, 0xa3d5, 0xf909, 0x166d, 0x4cb1,
+        0x83e3, 0xd93f, 0x365b, 0x6c87, 0xe082, 0xba5e, 0x553a, 0x0fe6,
+        0x4521, 0x1ffd, 0xf099, 0xaa45, 0x2640, 0x7c9c, 0x93f8, 0xc924,
+        0x054d, 0x5f91, 0xb0f5, 0xea29, 0x662c, 0x3cf0, 0xd394, 0x8948,
+        0xc38f, 0x9953, 0x7637, 0x2ceb, 0xa0ee, 0xfa32, 0x1556, 0x4f8a,
+        0x80d8, 0xda04, 0x3560, 0x6fbc, 0xe3b9, 0xb965, 0x5601, 0x0cdd,
+        0x461a, 0x1cc6, 0xf3a2, 0xa97e, 0x257b, 0x7fa7, 0x90c3, 0xca1f,
+        0x0cec, 0x5630, 0xb954, 0xe388, 0x6f8d, 0x3551, 0xda35, 0x80e9,
+        0xca2e, 0x90f2, 0x7f96, 0x254a, 0xa94f, 0xf393, 0x1cf7, 0x462b,
+        0x8979, 0xd3a5, 0x3cc1, 0x661d, 0xea18, 0xb0c4, 0x5fa0, 0x057c,
+        0x4fbb, 0x1567, 0xfa03, 0xa0df, 0x2cda, 0x7606, 0x9962, 0xc3be,
+        0x0fd7, 0x550b, 0xba6f, 0xe0b3, 0x6cb6, 0x366a, 0xd90e, 0x83d2,
+        0xc915, 0x93c9, 0x7cad, 0x2671, 0xaa74, 0xf0a8, 0x1fcc, 0x4510,
+        0x8a42, 0xd09e, 0x3ffa, 0x6526, 0xe923, 0xb3ff, 0x5c9b, 0x0647,
+        0x4c80, 0x165c, 0xf938, 0xa3e4, 0x2fe1, 0x753d, 0x9a59, 0xc085,
+        0x0a9a, 0x5046, 0xbf22, 0xe5fe, 0x69fb, 0x3327, 0xdc43, 0x869f,
+        0xcc58, 0x9684, 0x79e0, 0x233c, 0xaf39, 0xf5e5, 0x1a81, 0x405d,
+        0x8f0f, 0xd5d3, 0x3ab7, 0x606b, 0xec6e, 0xb6b2, 0x59d6, 0x030a,
+        0x49cd, 0x1311, 0xfc75, 0xa6a9, 0x2aac, 0x7070, 0x9f14, 0xc5c8,
+        0x09a1, 0x537d, 0xbc19, 0xe6c5, 0x6ac0, 0x301c, 0xdf78, 0x85a4,
+        0xcf63, 0x95bf, 0x7adb, 0x2007, 0xac02, 0xf6de, 0x19ba, 0x4366,
+        0x8c34, 0xd6e8, 0x398c, 0x6350, 0xef55, 0xb589, 0x5aed, 0x0031,
+        0x4af6, 0x102a, 0xff4e, 0xa592, 0x2997, 0x734b, 0x9c2f, 0xc6f3
+    },
+    {
+        0x0000, 0x1cbb, 0x3976, 0x25cd, 0x72ec, 0x6e57, 0x4b9a, 0x5721,
+        0xe5d8, 0xf963, 0xdcae, 0xc015, 0x9734, 0x8b8f, 0xae42, 0xb2f9,
+        0xc3a1, 0xdf1a, 0xfad7, 0xe66c, 0xb14d, 0xadf6, 0x883b, 0x9480,
+        0x2679, 0x3ac2, 0x1f0f, 0x03b4, 0x5495, 0x482e, 0x6de3, 0x7158,
+        0x8f53, 0x93e8, 0xb625, 0xaa9e, 0xfdbf, 0xe104, 0xc4c9, 0xd872,
+        0x6a8b, 0x7630, 0x53fd, 0x4f46, 0x1867, 0x04dc, 0x2111, 0x3daa,
+        0x4cf2, 0x5049, 0x7584, 0x693f, 0x3e1e, 0x22a5, 0x0768, 0x1bd3,
+        0xa92a, 0xb591, 0x905c, 0x8ce7, 0xdbc6, 0xc77d, 0xe2b0, 0xfe0b,
+        0x16b7, 0x0a0c, 0x2fc1, 0x337a, 0x645b, 0x78e0, 0x5d2d, 0x4196,
+        0xf36f, 0xefd4, 0xca19, 0xd6a2, 0x8183, 0x9d38, 0xb8f5, 0xa44e,
+        0xd516, 0xc9ad, 0xec60, 0xf0db, 0xa7fa, 0xbb41, 0x9e8c, 0x8237,
+        0x30ce, 0x2c75, 0x09b8, 0x1503, 0x4222, 0x5e99, 0x7b54, 0x67ef,
+        0x99e4, 0x855f, 0xa092, 0xbc29, 0xeb08, 0xf7b3, 0xd27e, 0xcec5,
+        0x7c3c, 0x6087, 0x454a, 0x59f1, 0x0ed0, 0x126b, 0x37a6, 0x2b1d,
+        0x5a45, 0x46fe, 0x6333, 0x7f88, 0x28a9, 0x3412, 0x11df, 0x0d64,
+        0xbf9d, 0xa326, 0x86eb, 0x9a50, 0xcd71, 0xd1ca, 0xf407, 0xe8bc,
+        0x2d6e, 0x31d5, 0x1418, 0x08a3, 0x5f82, 0x4339, 0x66f4, 0x7a4f,
+        0xc8b6, 0xd40d, 0xf1c0, 0xed7b, 0xba5a, 0xa6e1, 0x832c, 0x9f97,
+        0xeecf, 0xf274, 0xd7b9, 0xcb02, 0x9c23, 0x8098, 0xa555, 0xb9ee,
+        0x0b17, 0x17ac, 0x3261, 0x2eda, 0x79fb, 0x6540, 0x408d, 0x5c36,
+        0xa23d, 0xbe86, 0x9b4b, 0x87f0, 0xd0d1, 0xcc6a, 0xe9a7, 0xf51c,
+        0x47e5, 0x5b5e, 0x7e93, 0x6228, 0x3509, 0x29b2, 0x0c7f, 0x10c4,
+        0x619c, 0x7d27, 0x58ea, 0x4451, 0x1370, 0x0fcb, 0x2a06, 0x36bd,
+        0x8444, 0x98ff, 0xbd32, 0xa189, 0xf6a8, 0xea13, 0xcfde, 0xd365,
+        0x3bd9, 0x2762, 0x02af, 0x1e14, 0x4935, 0x558e, 0x7043, 0x6cf8,
+        0xde01, 0xc2ba, 0xe777, 0xfbcc, 0xaced, 0xb056, 0x959b, 0x8920,
+        0xf878, 0xe4c3, 0xc10e, 0xddb5, 0x8a94, 0x962f, 0xb3e2, 0xaf59,
+        0x1da0, 0x011b, 0x24d6, 0x386d, 0x6f4c, 0x73f7, 0x563a, 0x4a81,
+        0xb48a, 0xa831, 0x8dfc, 0x9147, 0xc666, 0xdadd, 0xff10, 0xe3ab,
+        0x5152, 0x4de9, 0x6824, 0x749f, 0x23be, 0x3f05, 0x1ac8, 0x0673,
+        0x772b, 0x6b90, 0x4e5d, 0x52e6, 0x05c7, 0x197c, 0x3cb1, 0x200a,
+        0x92f3, 0x8e48, 0xab85, 0xb73e, 0xe01f, 0xfca4, 0xd969, 0xc5d2
+    },
+#if YAHDLC_FCS_SLICES >= 8
+    {
+        0x0000, 0x0b44, 0x1688, 0x1dcc, 0x2d10, 0x2654, 0x3b98, 0x30dc,
+        0x5a20, 0x5164, 0x4ca8, 0x47ec, 0x7730, 0x7c74, 0x61b8, 0x6afc,
+        0xb440, 0xbf04, 0xa2c8, 0xa98c, 0x9950, 0x9214, 0x8fd8, 0x849c,
+        0xee60, 0xe524, 0xf8e8, 0xf3ac, 0xc370, 0xc834, 0xd5f8, 0xdebc,
+        0x6091, 0x6bd5, 0x7619, 0x7d5d, 0x4d81, 0x46c5, 0x5b09, 0x504d,
+        0x3ab1, 0x31f5, 0x2c39, 0x277d, 0x17a1, 0x1ce5, 0x0129, 0x0a6d,
+        0xd4d1, 0xdf95, 0xc259, 0xc91d, 0xf9c1, 0xf285, 0xef49, 0xe40d,
+        0x8ef1, 0x85b5, 0x9879, 0x933d, 0xa3e1, 0xa8a5, 0xb569, 0xbe2d,
+        0xc122, 0xca66, 0xd7aa, 0xdcee, 0xec32, 0xe776, 0xfaba, 0xf1fe,
+        0x9b02, 0x9046, 0x8d8a, 0x86ce, 0xb612, 0xbd56, 0xa09a, 0xabde,
+        0x7562, 0x7e26, 0x63ea, 0x68ae, 0x5872, 0x5336, 0x4efa, 0x45be,
+        0x2f42, 0x2406, 0x39ca, 0x328e, 0x0252, 0x0916, 0x14da, 0x1f9e,
+        0xa1b3, 0xaaf7, 0xb73b, 0xbc7f, 0x8ca3, 0x87e7, 0x9a2b, 0x916f,
+        0xfb93, 0xf0d7, 0xed1b, 0xe65f, 0xd683, 0xddc7, 0xc00b, 0xcb4f,
+        0x15f3, 0x1eb7, 0x037b, 0x083f, 0x38e3, 0x33a7, 0x2e6b, 0x252f,
+        0x4fd3, 0x4497, 0x595b, 0x521f, 0x62c3, 0x6987, 0x744b, 0x7f0f,
+        0x8a55, 0x8111, 0x9cdd, 0x9799, 0xa745, 0xac01, 0xb1cd, 0xba89,
+        0xd075, 0xdb31, 0xc6fd, 0xcdb9, 0xfd65, 0xf621, 0xebed, 0xe0a9,
+        0x3e15, 0x3551, 0x289d, 0x23d9, 0x1305, 0x1841, 0x058d, 0x0ec9,
+        0x6435, 0x6f71, 0x72bd, 0x79f9, 0x4925, 0x4261, 0x5fad, 0x54e9,
+        0xeac4, 0xe180, 0xfc4c, 0xf708, 0xc7d4, 0xcc90, 0xd15c, 0xda18,
+        0xb0e4, 0xbba0, 0xa66c, 0xad28, 0x9df4, 0x96b0, 0x8b7c, 0x8038,
+        0x5e84, 0x55c0, 0x480c, 0x4348, 0x7394, 0x78d0, 0x651c, 0x6e58,
+        0x04a4, 0x0fe0, 0x122c, 0x1968, 0x29b4, 0x22f0, 0x3f3c, 0x3478,
+        0x4b77, 0x4033, 0x5dff, 0x56bb, 0x6667, 0x6d23, 0x70ef, 0x7bab,
+        0x1157, 0x1a13, 0x07df, 0x0c9b, 0x3c47, 0x3703, 0x2acf, 0x218b,
+        0xff37, 0xf473, 0xe9bf, 0xe2fb, 0xd227, 0xd963, 0xc4af, 0xcfeb,
+        0xa517, 0xae53, 0xb39f, 0xb8db, 0x8807, 0x8343, 0x9e8f, 0x95cb,
+        0x2be6, 0x20a2, 0x3d6e, 0x362a, 0x06f6, 0x0db2, 0x107e, 0x1b3a,
+        0x71c6, 0x7a82, 0x674e, 0x6c0a, 0x5cd6, 0x5792, 0x4a5e, 0x411a,
+        0x9fa6, 0x94e2, 0x892e, 0x826a, 0xb2b6, 0xb9f2, 0xa43e, 0xaf7a,
+        0xc586, 0xcec2, 0xd30e, 0xd84a, 0xe896, 0xe3d2, 0xfe1e, 0xf55a
+    },
+    {
+        0x0000, 0x042b, 0x0856, 0x0c7d, 0x10ac, 0x1487, 0x18fa, 0x1cd1,
+        0x2158, 0x2573, 0x290e, 0x2d25, 0x31f4, 0x35df, 0x39a2, 0x3d89,
+        0x42b0, 0x469b, 0x4ae6, 0x4ecd, 0x521c, 0x5637, 0x5a4a, 0x5e61,
+        0x63e8, 0x67c3, 0x6bbe, 0x6f95, 0x7344, 0x776f, 0x7b12, 0x7f39,
+        0x8560, 0x814b, 0x8d36, 0x891d, 0x95cc, 0x91e7, 0x9d9a, 0x99b1,
+        0xa438, 0xa013, 0xac6e, 0xa845, 0xb494, 0xb0bf, 0xbcc2, 0xb8e9,
+        0xc7d0, 0xc3fb, 0xcf86, 0xcbad, 0xd77c, 0xd357, 0xdf2a, 0xdb01,
+        0xe688, 0xe2a3, 0xeede, 0xeaf5, 0xf624, 0xf20f, 0xfe72, 0xfa59,
+        0x02d1, 0x06fa, 0x0a87, 0x0eac, 0x127d, 0x1656, 0x1a2b, 0x1e00,
+        0x2389, 0x27a2, 0x2bdf, 0x2ff4, 0x3325, 0x370e, 0x3b73, 0x3f58,
+        0x4061, 0x444a, 0x4837, 0x4c1c, 0x50cd, 0x54e6, 0x589b, 0x5cb0,
+        0x6139, 0x6512, 0x696f, 0x6d44, 0x7195, 0x75be, 0x79c3, 0x7de8,
+        0x87b1, 0x839a, 0x8fe7, 0x8bcc, 0x971d, 0x9336, 0x9f4b, 0x9b60,
+        0xa6e9, 0xa2c2, 0xaebf, 0xaa94, 0xb645, 0xb26e, 0xbe13, 0xba38,
+        0xc501, 0xc12a, 0xcd57, 0xc97c, 0xd5ad, 0xd186, 0xddfb, 0xd9d0,
+        0xe459, 0xe072, 0xec0f, 0xe824, 0xf4f5, 0xf0de, 0xfca3, 0xf888,
+        0x05a2, 0x0189, 0x0df4, 0x09df, 0x150e, 0x1125, 0x1d58, 0x1973,
+        0x24fa, 0x20d1, 0x2cac, 0x2887, 0x3456, 0x307d, 0x3c00, 0x382b,
+        0x4712, 0x4339, 0x4f44, 0x4b6f, 0x57be, 0x5395, 0x5fe8, 0x5bc3,
+        0x664a, 0x6261, 0x6e1c, 0x6a37, 0x76e6, 0x72cd, 0x7eb0, 0x7a9b,
+        0x80c2, 0x84e9, 0x8894, 0x8cbf, 0x906e, 0x9445, 0x9838, 0x9c13,
+        0xa19a, 0xa5b1, 0xa9cc, 0xade7, 0xb136, 0xb51d, 0xb960, 0xbd4b,
+        0xc272, 0xc659, 0xca24, 0xce0f, 0xd2de, 0xd6f5, 0xda88, 0xdea3,
+        0xe32a, 0xe701, 0xeb7c, 0xef57, 0xf386, 0xf7ad, 0xfbd0, 0xfffb,
+        0x0773, 0x0358, 0x0f25, 0x0b0e, 0x17df, 0x13f4, 0x1f89, 0x1ba2,
+        0x262b, 0x2200, 0x2e7d, 0x2a56, 0x3687, 0x32ac, 0x3ed1, 0x3afa,
+        0x45c3, 0x41e8, 0x4d95, 0x49be, 0x556f, 0x5144, 0x5d39, 0x5912,
+        0x649b, 0x60b0, 0x6ccd, 0x68e6, 0x7437, 0x701c, 0x7c61, 0x784a,
+        0x8213, 0x8638, 0x8a45, 0x8e6e, 0x92bf, 0x9694, 0x9ae9, 0x9ec2,
+        0xa34b, 0xa760, 0xab1d, 0xaf36, 0xb3e7, 0xb7cc, 0xbbb1, 0xbf9a,
+        0xc0a3, 0xc488, 0xc8f5, 0xccde, 0xd00f, 0xd424, 0xd859, 0xdc72,
+        0xe1fb, 0xe5d0, 0xe9ad, 0xed86, 0xf157, 0xf57c, 0xf901, 0xfd2a
+    },
+    {
+        0x0000, 0x9fd5, 0x37bb, 0xa86e, 0x6f76, 0xf0a3, 0x58cd, 0xc718,
+        0xdeec, 0x4139, 0xe957, 0x7682, 0xb19a, 0x2e4f, 0x8621, 0x19f4,
+        0xb5c9, 0x2a1c, 0x8272, 0x1da7, 0xdabf, 0x456a, 0xed04, 0x72d1,
+        0x6b25, 0xf4f0, 0x5c9e, 0xc34b, 0x0453, 0x9b86, 0x33e8, 0xac3d,
+        0x6383, 0xfc56, 0x5438, 0xcbed, 0x0cf5, 0x9320, 0x3b4e, 0xa49b,
+        0xbd6f, 0x22ba, 0x8ad4, 0x1501, 0xd219, 0x4dcc, 0xe5a2, 0x7a77,
+        0xd64a, 0x499f, 0xe1f1, 0x7e24, 0xb93c, 0x26e9, 0x8e87, 0x1152,
+        0x08a6, 0x9773, 0x3f1d, 0xa0c8, 0x67d0, 0xf805, 0x506b, 0xcfbe,
+        0xc706, 0x58d3, 0xf0bd, 0x6f68, 0xa870, 0x37a5, 0x9fcb, 0x001e,
+        0x19ea, 0x863f, 0x2e51, 0xb184, 0x769c, 0xe949, 0x4127, 0xdef2,
+        0x72cf, 0xed1a, 0x4574, 0xdaa1, 0x1db9, 0x826c, 0x2a02, 0xb5d7,
+        0xac23, 0x33f6, 0x9b98, 0x044d, 0xc355, 0x5c80, 0xf4ee, 0x6b3b,
+        0xa485, 0x3b50, 0x933e, 0x0ceb, 0xcbf3, 0x5426, 0xfc48, 0x639d,
+        0x7a69, 0xe5bc, 0x4dd2, 0xd207, 0x151f, 0x8aca, 0x22a4, 0xbd71,
+        0x114c, 0x8e99, 0x26f7, 0xb922, 0x7e3a, 0xe1ef, 0x4981, 0xd654,
+        0xcfa0, 0x5075, 0xf81b, 0x67ce, 0xa0d6, 0x3f03, 0x976d, 0x08b8,
+        0x861d, 0x19c8, 0xb1a6, 0x2e73, 0xe96b, 0x76be, 0xded0, 0x4105,
+        0x58f1, 0xc724, 0x6f4a, 0xf09f, 0x3787, 0xa852, 0x003c, 0x9fe9,
+        0x33d4, 0xac01, 0x046f, 0x9bba, 0x5ca2, 0xc377, 0x6b19, 0xf4cc,
+        0xed38, 0x72ed, 0xda83, 0x4556, 0x824e, 0x1d9b, 0xb5f5, 0x2a20,
+        0xe59e, 0x7a4b, 0xd225, 0x4df0, 0x8ae8, 0x153d, 0xbd53, 0x2286,
+        0x3b72, 0xa4a7, 0x0cc9, 0x931c, 0x5404, 0xcbd1, 0x63bf, 0xfc6a,
+        0x5057, 0xcf82, 0x67ec, 0xf839, 0x3f21, 0xa0f4, 0x089a, 0x974f,
+        0x8ebb, 0x116e, 0xb900, 0x26d5, 0xe1cd, 0x7e18, 0xd676, 0x49a3,
+        0x411b, 0xdece, 0x76a0, 0xe975, 0x2e6d, 0xb1b8, 0x19d6, 0x8603,
+        0x9ff7, 0x0022, 0xa84c, 0x3799, 0xf081, 0x6f54, 0xc73a, 0x58ef,
+        0xf4d2, 0x6b07, 0xc369, 0x5cbc, 0x9ba4, 0x0471, 0xac1f, 0x33ca,
+        0x2a3e, 0xb5eb, 0x1d85, 0x8250, 0x4548, 0xda9d, 0x72f3, 0xed26,
+        0x2298, 0xbd4d, 0x1523, 0x8af6, 0x4dee, 0xd23b, 0x7a55, 0xe580,
+        0xfc74, 0x63a1, 0xcbcf, 0x541a, 0x9302, 0x0cd7, 0xa4b9, 0x3b6c,
+        0x9751, 0x0884, 0xa0ea, 0x3f3f, 0xf827, 0x67f2, 0xcf9c, 0x5049,
+        0x49bd, 0xd668, 0x7e06, 0xe1d3, 0x26cb, 0xb91e, 0x1170, 0x8ea5
+    },
+    {
+        0x0000, 0x81bf, 0x0b6f, 0x8ad0, 0x16de, 0x9761, 0x1db1, 0x9c0e,
+        0x2dbc, 0xac03, 0x26d3, 0xa76c, 0x3b62, 0xbadd, 0x300d, 0xb1b2,
+        0x5b78, 0xdac7, 0x5017, 0xd1a8, 0x4da6, 0xcc19, 0x46c9, 0xc776,
+        0x76c4, 0xf77b, 0x7dab, 0xfc14, 0x601a, 0xe1a5, 0x6b75, 0xeaca,
+        0xb6f0, 0x374f, 0xbd9f, 0x3c20, 0xa02e, 0x2191, 0xab41, 0x2afe,
+        0x9b4c, 0x1af3, 0x9023, 0x119c, 0x8d92, 0x0c2d, 0x86fd, 0x0742,
+        0xed88, 0x6c37, 0xe6e7, 0x6758, 0xfb56, 0x7ae9, 0xf039, 0x7186,
+        0xc034, 0x418b, 0xcb5b, 0x4ae4, 0xd6ea, 0x5755, 0xdd85, 0x5c3a,
+        0x65f1, 0xe44e, 0x6e9e, 0xef21, 0x732f, 0xf290, 0x7840, 0xf9ff,
+        0x484d, 0xc9f2, 0x4322, 0xc29d, 0x5e93, 0xdf2c, 0x55fc, 0xd443,
+        0x3e89, 0xbf36, 0x35e6, 0xb459, 0x2857, 0xa9e8, 0x2338, 0xa287,
+        0x1335, 0x928a, 0x185a, 0x99e5, 0x05eb, 0x8454, 0x0e84, 0x8f3b,
+        0xd301, 0x52be, 0xd86e, 0x59d1, 0xc5df, 0x4460, 0xceb0, 0x4f0f,
+        0xfebd, 0x7f02, 0xf5d2, 0x746d, 0xe863, 0x69dc, 0xe30c, 0x62b3,
+        0x8879, 0x09c6, 0x8316, 0x02a9, 0x9ea7, 0x1f18, 0x95c8, 0x1477,
+        0xa5c5, 0x247a, 0xaeaa, 0x2f15, 0xb31b, 0x32a4, 0xb874, 0x39cb,
+        0xcbe2, 0x4a5d, 0xc08d, 0x4132, 0xdd3c, 0x5c83, 0xd653, 0x57ec,
+        0xe65e, 0x67e1, 0xed31, 0x6c8e, 0xf080, 0x713f, 0xfbef, 0x7a50,
+        0x909a, 0x1125, 0x9bf5, 0x1a4a, 0x8644, 0x07fb, 0x8d2b, 0x0c94,
+        0xbd26, 0x3c99, 0xb649, 0x37f6, 0xabf8, 0x2a47, 0xa097, 0x2128,
+        0x7d12, 0xfcad, 0x767d, 0xf7c2, 0x6bcc, 0xea73, 0x60a3, 0xe11c,
+        0x50ae, 0xd111, 0x5bc1, 0xda7e, 0x4670, 0xc7cf, 0x4d1f, 0xcca0,
+        0x266a, 0xa7d5, 0x2d05, 0xacba, 0x30b4, 0xb10b, 0x3bdb, 0xba64,
+        0x0bd6, 0x8a69, 0x00b9, 0x8106, 0x1d08, 0x9cb7, 0x1667, 0x97d8,
+        0xae13, 0x2fac, 0xa57c, 0x24c3, 0xb8cd, 0x3972, 0xb3a2, 0x321d,
+        0x83af, 0x0210, 0x88c0, 0x097f, 0x9571, 0x14ce, 0x9e1e, 0x1fa1,
+        0xf56b, 0x74d4, 0xfe04, 0x7fbb, 0xe3b5, 0x620a, 0xe8da, 0x6965,
+        0xd8d7, 0x5968, 0xd3b8, 0x5207, 0xce09, 0x4fb6, 0xc566, 0x44d9,
+        0x18e3, 0x995c, 0x138c, 0x9233, 0x0e3d, 0x8f82, 0x0552, 0x84ed,
+        0x355f, 0xb4e0, 0x3e30, 0xbf8f, 0x2381, 0xa23e, 0x28ee, 0xa951,
+        0x439b, 0xc224, 0x48f4, 0xc94b, 0x5545, 0xd4fa, 0x5e2a, 0xdf95,
+        0x6e27, 0xef98, 0x6548, 0xe4f7, 0x78f9, 0xf946, 0x7396, 0xf229
+    }
+#endif
+};
+#endif
+
+// Used by the encoder, so that it does not call the exported fcs16 for every byte
+static inline uint16_t yahdlc_fcs16(uint16_t fcs, uint8_t value) {
     return (fcs >> 8) ^ fcstab[(fcs ^ value) & 0xff];
 }
 
+uint16_t fcs16(uint16_t fcs, uint8_t value) {
+    return yahdlc_fcs16(fcs, value);
+}
+
+
+// CRC-32C (Castagnoli) table, reflected polynomial 0x82F63B78
+static const uint32_t fcs32tab[256] = {
+    0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
+    0x26a1e7e8, 0xd4ca64eb, 0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+    0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24, 0x105ec76f, 0xe235446c,
+    0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+    0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc,
+    0xbc267848, 0x4e4dfb4b, 0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+    0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35, 0xaa64d611, 0x580f5512,
+    0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+    0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad,
+    0x1642ae59, 0xe4292d5a, 0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+    0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595, 0x417b1dbc, 0xb3109ebf,
+    0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+    0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f,
+    0xed03a29b, 0x1f682198, 0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+    0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38, 0xdbfc821c, 0x2997011f,
+    0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+    0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e,
+    0x4767748a, 0xb50cf789, 0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+    0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46, 0x7198540d, 0x83f3d70e,
+    0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+    0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de,
+    0xdde0eb2a, 0x2f8b6829, 0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+    0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93, 0x082f63b7, 0xfa44e0b4,
+    0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+    0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b,
+    0xb4091bff, 0x466298fc, 0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+    0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033, 0xa24bb5a6, 0x502036a5,
+    0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+    0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975,
+    0x0e330a81, 0xfc588982, 0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+    0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622, 0x38cc2a06, 0xcaa7a905,
+    0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+    0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8,
+    0xe52cc12c, 0x1747422f, 0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+    0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0, 0xd3d3e1ab, 0x21b862a8,
+    0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+    0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78,
+    0x7fab5e8c, 0x8dc0dd8f, 0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+    0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1, 0x69e9f0d5, 0x9b8273d6,
+    0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+    0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69,
+    0xd5cf889d, 0x27a40b9e, 0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+    0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+};
+
+static inline uint32_t yahdlc_fcs32(uint32_t fcs, uint8_t value) {
+    return (fcs >> 8) ^ fcs32tab[(fcs ^ value) & 0xff];
+}
+
+uint32_t fcs32_buf(uint32_t fcs, const uint8_t *buf, size_t len) {
+#if defined(YAHDLC_FCS32_SSE42) && defined(__x86_64__)
+    for (; len >= 8; buf += 8, len -= 8) {
+        uint64_t word;
+        memcpy(&word, buf, sizeof(word));
+        fcs = (uint32_t)_mm_crc32_u64(fcs, word);
+    }
+#elif defined(YAHDLC_FCS32_SSE42)
+    for (; len >= 4; buf += 4, len -= 4) {
+        uint32_t word;
+        memcpy(&word, buf, sizeof(word));
+        fcs = _mm_crc32_u32(fcs, word);
+    }
+#elif defined(YAHDLC_FCS32_ARM)
+    for (; len >= 8; buf += 8, len -= 8) {
+        uint64_t word;
+        memcpy(&word, buf, sizeof(word));
+        fcs = __crc32cd(fcs, word);
+    }
+#endif
+    for (; len > 0; buf++, len--) {
+        fcs = yahdlc_fcs32(fcs, *buf);
+    }
+    return fcs;
+}
+
+
+#if defined(YAHDLC_FCS_PCLMUL) || defined(YAHDLC_FCS_PMULL)
+// Folding constants x^191 mod P and x^127 mod P of the FCS polynomial, bit-reflected into 64 bits
+#define YAHDLC_FCS_FOLD_HI 0xa95d000000000000ULL
+#define YAHDLC_FCS_FOLD_LO 0x7eea000000000000ULL
+
+/**
+ * Folds `len` bytes of `buf` (at least 32) 16 bytes at a time with carry-less multiplication until
+ * the last 16 to 31 bytes. Stores the folded 16 bytes, which have the same FCS (starting at zero)
+ * as all but the unprocessed bytes, to `folded`. Returns the number of bytes processed.
+ */
+static size_t yahdlc_fcs16_fold(uint16_t fcs, const uint8_t *buf, size_t len, uint8_t *folded) {
+    size_t i = 16;
+#if defined(YAHDLC_FCS_PCLMUL)
+    const __m128i k = _mm_set_epi64x(YAHDLC_FCS_FOLD_LO, YAHDLC_FCS_FOLD_HI);
+    __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*)buf), _mm_cvtsi32_si128(fcs));
+    for (; i + 16 <= len; i += 16) {
+        x = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00),
+                                        _mm_clmulepi64_si128(x, k, 0x11)),
+                          _mm_loadu_si128((const __m128i*)(buf + i)));
+    }
+    _mm_storeu_si128((__m128i*)folded, x);
+#else
+    uint64x2_t x = veorq_u64(vreinterpretq_u64_u8(vld1q_u8(buf)),
+                             vsetq_lane_u64(fcs, vdupq_n_u64(0), 0));
+    for (; i + 16 <= len; i += 16) {
+        uint64x2_t hi = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(x, 0),
+                                                         (poly64_t)YAHDLC_FCS_FOLD_HI));
+        uint64x2_t lo = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(x, 1),
+                                                         (poly64_t)YAHDLC_FCS_FOLD_LO));
+        x = veorq_u64(veorq_u64(hi, lo), vreinterpretq_u64_u8(vld1q_u8(buf + i)));
+    }
+    vst1q_u8(folded, vreinterpretq_u8_u64(x));
+#endif
+    return i;
+}
+#endif
+
+
+/**
+ * Updates FCS with `len` bytes of `buf` using the slice tables
+ */
+static uint16_t yahdlc_fcs16_slices(uint16_t fcs, const uint8_t *buf, size_t len) {
+#if YAHDLC_FCS_SLICES >= 8
+    for (; len >= 8; buf += 8, len -= 8) {
+        fcs ^= buf[0] | (buf[1] << 8);
+        fcs = fcstab_slice[6][fcs & 0xff] ^ fcstab_slice[5][fcs >> 8] ^
+              fcstab_slice[4][buf[2]] ^ fcstab_slice[3][buf[3]] ^ fcstab_slice[2][buf[4]] ^
+              fcstab_slice[1][buf[5]] ^ fcstab_slice[0][buf[6]] ^ fcstab[buf[7]];
+    }
+#endif
+#if YAHDLC_FCS_SLICES >= 4
+    for (; len >= 4; buf += 4, len -= 4) {
+        fcs ^= buf[0] | (buf[1] << 8);
+        fcs = fcstab_slice[2][fcs & 0xff] ^ fcstab_slice[1][fcs >> 8] ^
+              fcstab_slice[0][buf[2]] ^ fcstab[buf[3]];
+    }
+#endif
+    for (; len > 0; buf++, len--) {
+        fcs = yahdlc_fcs16(fcs, *buf);
+    }
+    return fcs;
+}
+
+
+uint16_t fcs16_buf(uint16_t fcs, const uint8_t *buf, size_t len) {
+#if defined(YAHDLC_FCS_PCLMUL) || defined(YAHDLC_FCS_PMULL)
+    if (len >= 32) {
+        uint8_t folded[16];
+        size_t processed = yahdlc_fcs16_fold(fcs, buf, len, folded);
+        fcs = yahdlc_fcs16_slices(0, folded, sizeof(folded));
+        buf += processed;
+        len -= processed;
+    }
+#endif
+    return yahdlc_fcs16_slices(fcs, buf, len);
+}
+
+
+// FCS of the kind selected by `fcs32`: its initial value, length and update with a buffer
+static inline uint32_t yahdlc_fcs_init(uint8_t fcs32) {
+    return fcs32 ? FCS32_INIT_VALUE : FCS16_INIT_VALUE;
+}
+
+static inline size_t yahdlc_fcs_len(uint8_t fcs32) {
+    return fcs32 ? 4 : 2;
+}
+
+static inline uint32_t yahdlc_fcs_buf(uint8_t fcs32, uint32_t fcs, const uint8_t *buf,
+                                      size_t len) {
+    return fcs32 ? fcs32_buf(fcs, buf, len) : fcs16_buf(fcs, buf, len);
+}
+
+
+/**
+ * Returns index of the first flag sequence or control escape byte in `buf`, `len` if there is
+ * none
+ */
+static size_t yahdlc_scan_control_bytes(const uint8_t *buf, size_t len) {
+    size_t i = 0;
+#if defined(YAHDLC_SCAN_AVX2)
+    const __m256i flag = _mm256_set1_epi8(YAHDLC_FLAG_SEQUENCE);
+    const __m256i escape = _mm256_set1_epi8(YAHDLC_CONTROL_ESCAPE);
+    for (; i + 32 <= len; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(buf + i));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, flag),
+                                                             _mm256_cmpeq_epi8(block, escape)));
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#elif defined(YAHDLC_SCAN_SSE2)
+    const __m128i flag = _mm_set1_epi8(YAHDLC_FLAG_SEQUENCE);
+    const __m128i escape = _mm_set1_epi8(YAHDLC_CONTROL_ESCAPE);
+    for (; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(buf + i));
+        uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, flag),
+                                                       _mm_cmpeq_epi8(block, escape)));
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#elif defined(YAHDLC_SCAN_NEON)
+    const uint8x16_t flag = vdupq_n_u8(YAHDLC_FLAG_SEQUENCE);
+    const uint8x16_t escape = vdupq_n_u8(YAHDLC_CONTROL_ESCAPE);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t block = vld1q_u8(buf + i);
+        uint8x16_t match = vorrq_u8(vceqq_u8(block, flag), vceqq_u8(block, escape));
+        // Narrow each byte of the comparison result to a nibble, so that it fits 64 bits
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+            vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+        if (mask) {
+            return i + (__builtin_ctzll(mask) >> 2);
+        }
+    }
+#endif
+    for (; i < len; i++) {
+        if (buf[i] == YAHDLC_FLAG_SEQUENCE || buf[i] == YAHDLC_CONTROL_ESCAPE) {
+            break;
+        }
+    }
+    return i;
+}
+
 
-void yahdlc_escape_value(uint8_t value, uint8_t *dest, ptrdiff_t *dest_index) {
-    // Check and escape the value if needed
+/**
+ * Stores `value` at `dest`, escaped if needed. Returns position after the stored bytes.
+ */
+static inline uint8_t *yahdlc_put_escaped(uint8_t *dest, uint8_t value) {
     if ((value == YAHDLC_FLAG_SEQUENCE) || (value == YAHDLC_CONTROL_ESCAPE)) {
-        if (dest) {
-            dest[(*dest_index)++] = YAHDLC_CONTROL_ESCAPE;
-            value ^= 0x20;
-        } else {
-            (*dest_index)++;
+        *dest++ = YAHDLC_CONTROL_ESCAPE;
+        value ^= 0x20;
+    }
+    *dest++ = value;
+    return dest;
+}
+
+
+/**
+ * Number of bytes `value` takes in the frame after escaping
+ */
+static inline size_t yahdlc_escaped_len(uint8_t value) {
+    return ((value == YAHDLC_FLAG_SEQUENCE) || (value == YAHDLC_CONTROL_ESCAPE)) ? 2 : 1;
+}
+
+
+/**
+ * Stores `len` bytes of `src` at `dest`, escaped where needed. Runs of bytes which need no
+ * escaping are copied at once. Returns position after the stored bytes.
+ */
+static uint8_t *yahdlc_put_escaped_buf(uint8_t *dest, const uint8_t *src, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        size_t run = yahdlc_scan_control_bytes(src + i, len - i);
+        memcpy(dest, src + i, run);
+        dest += run;
+        i += run;
+        if (i < len) {
+            dest = yahdlc_put_escaped(dest, src[i]);
+            i++;
         }
     }
+    return dest;
+}
+
+
+/**
+ * Number of bytes `len` bytes of `src` take in the frame after escaping
+ */
+static size_t yahdlc_escaped_buf_len(const uint8_t *src, size_t len) {
+    size_t i = 0, escaped_len = len;
+    while ((i += yahdlc_scan_control_bytes(src + i, len - i)) < len) {
+        escaped_len++;
+        i++;
+    }
+    return escaped_len;
+}
 
-    // Add the value to the destination buffer and increment destination index
-    if (dest) {
-        dest[(*dest_index)++] = value;
-    } else {
-        (*dest_index)++;
+
+/**
+ * Stores inverted FCS (2 or 4 bytes, least significant first) at `dest`, escaped where needed.
+ * Returns position after the stored bytes.
+ */
+static uint8_t *yahdlc_put_fcs(uint8_t *dest, uint8_t fcs32, uint32_t fcs) {
+    fcs = ~fcs;
+    for (size_t i = 0; i < yahdlc_fcs_len(fcs32); i++) {
+        dest = yahdlc_put_escaped(dest, fcs >> (8 * i));
     }
+    return dest;
 }
 
 
-yahdlc_control_t yahdlc_get_control_type(uint8_t control) {
+yahdlc_control_t yahdlc_get_control_type(uint8_t control, uint8_t control_ext, uint8_t extended) {
     yahdlc_control_t value = {};
 
     // Check if the frame is a S-frame (or U-frame)
     if (control & (1 << YAHDLC_CONTROL_S_OR_U_FRAME_BIT)) {
         // Check if only U-frame type
         if (control & (1 << YAHDLC_CONTROL_U_ONLY_FRAME_BIT)) {
-            if ((control >> YAHDLC_CONTROL_CONN_SPECIAL_BIT) == YAHDLC_U_FRAME_CONN_CHECK) {
+            // SABME and UA share upper bits, they differ in bits 2 and 3
+            if ((control >> YAHDLC_CONTROL_CONN_SPECIAL_BIT) == YAHDLC_U_FRAME_CONN_EXT_CHECK &&
+                ((control >> YAHDLC_CONTROL_CONN_OR_DISC) & YAHDLC_CONTROL_U_TYPE_ADDED_BITS)
+                    == YAHDLC_CONTROL_U_TYPE_ADDED_BITS) {
+                value.frame = YAHDLC_FRAME_CONN;
+                value.extended = 1;
+            } else if ((control >> YAHDLC_CONTROL_CONN_SPECIAL_BIT) == YAHDLC_U_FRAME_CONN_CHECK) {
                 value.frame = YAHDLC_FRAME_CONN;
             } else if ((control >> YAHDLC_CONTROL_CONN_SPECIAL_BIT) == YAHDLC_U_FRAME_CONN_ACK_CHECK) {
                 value.frame = YAHDLC_FRAME_CONN_ACK;
             }
         } else {
-            // Check if S-frame type is a Receive Ready (ACK)
-            if (((control >> YAHDLC_CONTROL_S_FRAME_TYPE_BIT) & 0x3)
-            == YAHDLC_CONTROL_TYPE_RECEIVE_READY) {
+            // Check if S-frame type is a Receive Ready (ACK), Receive Not Ready (RNR), Reject
+            // (NACK) or Selective Reject (SREJ)
+            uint8_t s_type = (control >> YAHDLC_CONTROL_S_FRAME_TYPE_BIT) & 0x3;
+            if (s_type == YAHDLC_CONTROL_TYPE_RECEIVE_READY) {
                 value.frame = YAHDLC_FRAME_ACK;
+            } else if (s_type == YAHDLC_CONTROL_TYPE_RECEIVE_NOT_READY) {
+                value.frame = YAHDLC_FRAME_RNR;
+            } else if (s_type == YAHDLC_CONTROL_TYPE_SELECTIVE_REJECT) {
+                value.frame = YAHDLC_FRAME_SREJ;
             } else {
-                // Assume it is an NACK since Receive Not Ready, Selective Reject and U-frames are
-                // not supported
                 value.frame = YAHDLC_FRAME_NACK;
             }
             // Add the receive sequence number from the S-frame
-            value.recv_seq_no = (control >> YAHDLC_CONTROL_RECV_SEQ_NO_BIT) & 0x7;
+            if (extended) {
+                value.extended = 1;
+                value.recv_seq_no = (control_ext >> YAHDLC_CONTROL_EXT_RECV_SEQ_NO_BIT) & 0x7F;
+            } else {
+                value.recv_seq_no = (control >> YAHDLC_CONTROL_RECV_SEQ_NO_BIT) & 0x7;
+            }
         }
     } else {
         // It must be an I-frame so add the send sequence number
         value.frame = YAHDLC_FRAME_DATA;
-        value.send_seq_no = (control >> YAHDLC_CONTROL_SEND_SEQ_NO_BIT) & 0x7;
-        value.recv_seq_no = (control >> YAHDLC_CONTROL_RECV_SEQ_NO_BIT) & 0x7;
+        if (extended) {
+            value.extended = 1;
+            value.send_seq_no = (control >> YAHDLC_CONTROL_EXT_SEND_SEQ_NO_BIT) & 0x7F;
+            value.recv_seq_no = (control_ext >> YAHDLC_CONTROL_EXT_RECV_SEQ_NO_BIT) & 0x7F;
+            value.more = !(control_ext & (1 << YAHDLC_CONTROL_EXT_POLL_BIT));
+        } else {
+            value.send_seq_no = (control >> YAHDLC_CONTROL_SEND_SEQ_NO_BIT) & 0x7;
+            value.recv_seq_no = (control >> YAHDLC_CONTROL_RECV_SEQ_NO_BIT) & 0x7;
+            value.more = !(control & (1 << YAHDLC_CONTROL_POLL_BIT));
+        }
     }
 
     return value;
@@ -168,32 +761,64 @@ uint8_t yahdlc_frame_control_type(yahdlc_control_t *control) {
     // For details see: https://en.wikipedia.org/wiki/High-Level_Data_Link_Control
     switch (control->frame) {
         case YAHDLC_FRAME_DATA:
-            // Create the HDLC I-frame control byte with Poll bit set
+            if (control->extended) {
+                // First byte of the extended I-frame control field, the rest is in the second byte
+                value |= (control->send_seq_no << YAHDLC_CONTROL_EXT_SEND_SEQ_NO_BIT);
+                break;
+            }
+            // Create the HDLC I-frame control byte with Poll bit set, unless more fragments follow
             value |= (control->send_seq_no << YAHDLC_CONTROL_SEND_SEQ_NO_BIT);
             value |= (control->recv_seq_no << YAHDLC_CONTROL_RECV_SEQ_NO_BIT);
-            value |= (1 << YAHDLC_CONTROL_POLL_BIT);
+            if (!control->more) {
+                value |= (1 << YAHDLC_CONTROL_POLL_BIT);
+            }
             break;
 
         case YAHDLC_FRAME_ACK:
             // Create the HDLC Receive Ready S-frame control byte with Poll bit cleared
-            value |= (control->recv_seq_no << YAHDLC_CONTROL_RECV_SEQ_NO_BIT);
+            if (!control->extended) {
+                value |= (control->recv_seq_no << YAHDLC_CONTROL_RECV_SEQ_NO_BIT);
+            }
             value |= (1 << YAHDLC_CONTROL_S_OR_U_FRAME_BIT);
             break;
 
         case YAHDLC_FRAME_NACK:
             // Create the HDLC Receive Ready S-frame control byte with Poll bit cleared
-            value |= (control->recv_seq_no << YAHDLC_CONTROL_RECV_SEQ_NO_BIT);
+            if (!control->extended) {
+                value |= (control->recv_seq_no << YAHDLC_CONTROL_RECV_SEQ_NO_BIT);
+            }
             value |= (YAHDLC_CONTROL_TYPE_REJECT << YAHDLC_CONTROL_S_FRAME_TYPE_BIT);
             value |= (1 << YAHDLC_CONTROL_S_OR_U_FRAME_BIT);
             break;
 
+        case YAHDLC_FRAME_RNR:
+            // Create the HDLC Receive Not Ready S-frame control byte with Poll bit cleared
+            if (!control->extended) {
+                value |= (control->recv_seq_no << YAHDLC_CONTROL_RECV_SEQ_NO_BIT);
+            }
+            value |= (YAHDLC_CONTROL_TYPE_RECEIVE_NOT_READY << YAHDLC_CONTROL_S_FRAME_TYPE_BIT);
+            value |= (1 << YAHDLC_CONTROL_S_OR_U_FRAME_BIT);
+            break;
+
+        case YAHDLC_FRAME_SREJ:
+            // Create the HDLC Selective Reject S-frame control byte with Poll bit cleared
+            if (!control->extended) {
+                value |= (control->recv_seq_no << YAHDLC_CONTROL_RECV_SEQ_NO_BIT);
+            }
+            value |= (YAHDLC_CONTROL_TYPE_SELECTIVE_REJECT << YAHDLC_CONTROL_S_FRAME_TYPE_BIT);
+            value |= (1 << YAHDLC_CONTROL_S_OR_U_FRAME_BIT);
+            break;
+
         case YAHDLC_FRAME_CONN:
-            // Create the HDLC SABM U-frame control byte with Poll bit set
+            // Create the HDLC SABM (or SABME) U-frame control byte with Poll bit set
             value |= (1 << YAHDLC_CONTROL_S_OR_U_FRAME_BIT);
             value |= (1 << YAHDLC_CONTROL_U_ONLY_FRAME_BIT);
             value |= (1 << YAHDLC_CONTROL_POLL_BIT);
             value |= (YAHDLC_CONTROL_U_TYPE_ADDED_BITS << YAHDLC_CONTROL_CONN_OR_DISC);
             value |= (1 << YAHDLC_CONTROL_CONN_SPECIAL_BIT);
+            if (control->extended) {
+                value |= (1 << YAHDLC_CONTROL_CONN_EXT_BIT);
+            }
             break;
 
         case YAHDLC_FRAME_CONN_ACK:
@@ -207,14 +832,63 @@ uint8_t yahdlc_frame_control_type(yahdlc_control_t *control) {
 }
 
 
-void yahdlc_reset_state(yahdlc_state_t *state, size_t max_frame_len) {
-    state->fcs = FCS16_INIT_VALUE;
+/**
+ * Returns true if the control field of this frame has the second byte
+ */
+static int yahdlc_has_control_ext(yahdlc_frame_t frame, uint8_t extended) {
+    return extended && (frame == YAHDLC_FRAME_DATA || frame == YAHDLC_FRAME_ACK ||
+                        frame == YAHDLC_FRAME_NACK || frame == YAHDLC_FRAME_SREJ ||
+                        frame == YAHDLC_FRAME_RNR);
+}
+
+
+uint8_t yahdlc_frame_control_ext(yahdlc_control_t *control) {
+    // Second byte of the extended I and S frame control field. Poll bit is set in I-frames only,
+    // unless more fragments follow
+    uint8_t value = (control->recv_seq_no << YAHDLC_CONTROL_EXT_RECV_SEQ_NO_BIT);
+    if (control->frame == YAHDLC_FRAME_DATA && !control->more) {
+        value |= (1 << YAHDLC_CONTROL_EXT_POLL_BIT);
+    }
+    return value;
+}
+
+
+/**
+ * Stores address and control field of the frame (unescaped) in `header`, which must have room for
+ * 3 bytes. Returns their count.
+ */
+static size_t yahdlc_frame_header(yahdlc_control_t *control, uint8_t *header) {
+    size_t len = 0;
+    header[len++] = YAHDLC_ALL_STATION_ADDR;
+    header[len++] = yahdlc_frame_control_type(control);
+    if (yahdlc_has_control_ext(control->frame, control->extended)) {
+        header[len++] = yahdlc_frame_control_ext(control);
+    }
+    return len;
+}
+
+static int yahdlc_is_u_frame(uint8_t control) {
+    return (control & (1 << YAHDLC_CONTROL_S_OR_U_FRAME_BIT)) &&
+           (control & (1 << YAHDLC_CONTROL_U_ONLY_FRAME_BIT));
+}
+
+
+static void yahdlc_reset_frame_state(yahdlc_state_t *state) {
+    state->fcs = yahdlc_fcs_init(state->fcs32);
     state->start_index = state->end_index = -1;
     state->src_index = state->dest_index = 0;
     state->control_escape = 0;
     state->frame_byte_index = 0;
     state->frame_control = 0;
+    state->frame_control_ext = 0;
+}
+
+
+void yahdlc_reset_state(yahdlc_state_t *state, size_t max_frame_len) {
+    state->fcs32 = 0;
+    yahdlc_reset_frame_state(state);
     state->max_frame_len = max_frame_len;
+    state->extended = 0;
 }
 
 
@@ -241,8 +915,31 @@ int yahdlc_get_data(yahdlc_state_t *state, yahdlc_control_t *control, const uint
                 }
 
                 state->start_index = state->src_index;
+                // FCS kind may have been switched since the frame state was reset
+                state->fcs = yahdlc_fcs_init(state->fcs32);
             }
         } else {
+            // Data bytes up to the next flag sequence or control escape need no unescaping, copy
+            // them at once (but only as many as fit) and continue with the byte that follows. Data
+            // received byte by byte is left to the code below.
+            if (!state->control_escape && state->frame_byte_index > 2 && src_len - i > 1) {
+                size_t run = yahdlc_scan_control_bytes(src + i, src_len - i);
+                size_t room = ((size_t)state->dest_index + 1 < state->max_frame_len) ?
+                              state->max_frame_len - 1 - state->dest_index : 0;
+                if (run > room) {
+                    run = room;
+                }
+                memcpy(dest + state->dest_index, src + i, run);
+                state->fcs = yahdlc_fcs_buf(state->fcs32, state->fcs, src + i, run);
+                state->dest_index += run;
+                state->frame_byte_index += run;
+                state->src_index += run;
+                i += run;
+                if (i == src_len) {
+                    break;
+                }
+            }
+
             // Check for end flag sequence
             if (src[i] == YAHDLC_FLAG_SEQUENCE) {
                 // Check if an additional flag sequence byte is present or earlier received
@@ -266,11 +963,16 @@ int yahdlc_get_data(yahdlc_state_t *state, yahdlc_control_t *control, const uint
                 }
 
                 // Now update the FCS value
-                state->fcs = fcs16(state->fcs, value);
+                state->fcs = state->fcs32 ? yahdlc_fcs32(state->fcs, value)
+                                          : yahdlc_fcs16(state->fcs, value);
 
                 if (state->frame_byte_index == 1) {
                     // Control field is the second byte after the start flag sequence
                     state->frame_control = value;
+                } else if (state->frame_byte_index == 2 && state->extended &&
+                           !yahdlc_is_u_frame(state->frame_control)) {
+                    // I and S frames have two-byte control field in extended mode
+                    state->frame_control_ext = value;
                 } else if (state->frame_byte_index > 1) {
                     // Start adding the data values after the Control field to the buffer
                     if ((size_t)state->dest_index+1 >= state->max_frame_len) {
@@ -279,7 +981,7 @@ int yahdlc_get_data(yahdlc_state_t *state, yahdlc_control_t *control, const uint
                         // be discarded since no start flag will be found
                         *dest_len = i;
                         ret = -EIO;
-                        yahdlc_reset_state(state, state->max_frame_len);
+                        yahdlc_reset_frame_state(state);
                         return ret;
                     }
                     dest[state->dest_index++] = value;
@@ -298,80 +1000,377 @@ int yahdlc_get_data(yahdlc_state_t *state, yahdlc_control_t *control, const uint
     } else {
         // A frame is at least 4 bytes in size and has a valid FCS value
         if ((state->end_index < (state->start_index + 4))
-        || (state->fcs != FCS16_GOOD_VALUE)) {
+        || ((size_t)state->dest_index < yahdlc_fcs_len(state->fcs32))
+        || (state->fcs != (state->fcs32 ? FCS32_GOOD_VALUE : FCS16_GOOD_VALUE))) {
             // Return FCS error and indicate that data up to end flag sequence in buffer should
             // be discarded
             *dest_len = i;
             ret = -EIO;
         } else {
             // Good frame. Decode control byte
-            *control = yahdlc_get_control_type(state->frame_control);
+            *control = yahdlc_get_control_type(state->frame_control, state->frame_control_ext,
+                                               state->extended);
             // Return success and indicate that data up to end flag sequence in buffer should be
             // discarded
-            *dest_len = state->dest_index - sizeof(state->fcs);
+            *dest_len = state->dest_index - yahdlc_fcs_len(state->fcs32);
             ret = i;
         }
 
         // Reset values for next frame
-        yahdlc_reset_state(state, state->max_frame_len);
+        yahdlc_reset_frame_state(state);
     }
 
     return ret;
 }
 
+
 int yahdlc_frame_data(yahdlc_control_t *control, const uint8_t *src,
                       size_t src_len, uint8_t *dest, size_t *dest_len) {
-    size_t i;
-    ptrdiff_t dest_index = 0;
-    uint8_t value = 0;
-    uint16_t fcs = FCS16_INIT_VALUE;
+    uint8_t header[3];
+    size_t header_len, i;
+    uint32_t fcs;
 
     // Make sure that all parameters are valid
     if (!control || (!src && (src_len > 0)) || !dest_len) {
         return -EINVAL;
     }
+    header_len = yahdlc_frame_header(control, header);
 
-    // Start by adding the start flag sequence
-    if (dest) {
-        dest[dest_index++] = YAHDLC_FLAG_SEQUENCE;
-    } else {
-        dest_index++;
+    // Only DATA frames should contain data
+    if (control->frame != YAHDLC_FRAME_DATA) {
+        src_len = 0;
     }
+    fcs = yahdlc_fcs_buf(control->fcs32, yahdlc_fcs_init(control->fcs32), header, header_len);
+    fcs = yahdlc_fcs_buf(control->fcs32, fcs, src, src_len);
 
-    // Add the all-station address from HDLC (broadcast)
-    fcs = fcs16(fcs, YAHDLC_ALL_STATION_ADDR);
-    yahdlc_escape_value(YAHDLC_ALL_STATION_ADDR, dest, &dest_index);
+    if (!dest) {
+        // Only compute the frame length: start and end flag sequence, escaped header, data and FCS
+        uint8_t escaped_fcs[8];
+        size_t len = 2;
+        for (i = 0; i < header_len; i++) {
+            len += yahdlc_escaped_len(header[i]);
+        }
+        len += yahdlc_escaped_buf_len(src, src_len);
+        *dest_len = len + (yahdlc_put_fcs(escaped_fcs, control->fcs32, fcs) - escaped_fcs);
+        return 0;
+    }
 
-    // Add the framed control field value
-    value = yahdlc_frame_control_type(control);
-    fcs = fcs16(fcs, value);
-    yahdlc_escape_value(value, dest, &dest_index);
+    // Build the frame in a single pass, escaping the bytes
+    uint8_t *p = dest;
+    *p++ = YAHDLC_FLAG_SEQUENCE;
+    for (i = 0; i < header_len; i++) {
+        p = yahdlc_put_escaped(p, header[i]);
+    }
+    p = yahdlc_put_escaped_buf(p, src, src_len);
 
-    // Only DATA frames should contain data
-    if (control->frame == YAHDLC_FRAME_DATA) {
-        // Calculate FCS and escape data
-        for (i = 0; i < src_len; i++) {
-            fcs = fcs16(fcs, src[i]);
-            yahdlc_escape_value(src[i], dest, &dest_index);
+    // Invert the FCS value accordingly to the specification, low byte goes first
+    p = yahdlc_put_fcs(p, control->fcs32, fcs);
+
+    *p++ = YAHDLC_FLAG_SEQUENCE;
+    *dest_len = p - dest;
+    return 0;
+}
+
+
+// Frames without data, encoded in advance by yahdlc_frame_data. Frames of basic mode: ACK, NACK
+// and SREJ indexed by N(R), followed by CONN, CONN in extended mode and CONN_ACK.
+typedef struct {
+    uint8_t len;
+    uint8_t bytes[8];
+} yahdlc_encoded_frame_t;
+
+static const yahdlc_encoded_frame_t yahdlc_basic_frames[] = {
+    {6, {0x7E, 0xFF, 0x01, 0x0E, 0xE1, 0x7E}}, // ACK N(R)=0
+    {6, {0x7E, 0xFF, 0x21, 0x0C, 0xC0, 0x7E}}, // ACK N(R)=1
+    {6, {0x7E, 0xFF, 0x41, 0x0A, 0xA3, 0x7E}}, // ACK N(R)=2
+    {6, {0x7E, 0xFF, 0x61, 0x08, 0x82, 0x7E}}, // ACK N(R)=3
+    {6, {0x7E, 0xFF, 0x81, 0x06, 0x65, 0x7E}}, // ACK N(R)=4
+    {6, {0x7E, 0xFF, 0xA1, 0x04, 0x44, 0x7E}}, // ACK N(R)=5
+    {6, {0x7E, 0xFF, 0xC1, 0x02, 0x27, 0x7E}}, // ACK N(R)=6
+    {6, {0x7E, 0xFF, 0xE1, 0x00, 0x06, 0x7E}}, // ACK N(R)=7
+    {6, {0x7E, 0xFF, 0x09, 0x46, 0x6D, 0x7E}}, // NACK N(R)=0
+    {6, {0x7E, 0xFF, 0x29, 0x44, 0x4C, 0x7E}}, // NACK N(R)=1
+    {6, {0x7E, 0xFF, 0x49, 0x42, 0x2F, 0x7E}}, // NACK N(R)=2
+    {6, {0x7E, 0xFF, 0x69, 0x40, 0x0E, 0x7E}}, // NACK N(R)=3
+    {6, {0x7E, 0xFF, 0x89, 0x4E, 0xE9, 0x7E}}, // NACK N(R)=4
+    {6, {0x7E, 0xFF, 0xA9, 0x4C, 0xC8, 0x7E}}, // NACK N(R)=5
+    {6, {0x7E, 0xFF, 0xC9, 0x4A, 0xAB, 0x7E}}, // NACK N(R)=6
+    {6, {0x7E, 0xFF, 0xE9, 0x48, 0x8A, 0x7E}}, // NACK N(R)=7
+    {6, {0x7E, 0xFF, 0x0D, 0x62, 0x2B, 0x7E}}, // SREJ N(R)=0
+    {6, {0x7E, 0xFF, 0x2D, 0x60, 0x0A, 0x7E}}, // SREJ N(R)=1
+    {6, {0x7E, 0xFF, 0x4D, 0x66, 0x69, 0x7E}}, // SREJ N(R)=2
+    {6, {0x7E, 0xFF, 0x6D, 0x64, 0x48, 0x7E}}, // SREJ N(R)=3
+    {6, {0x7E, 0xFF, 0x8D, 0x6A, 0xAF, 0x7E}}, // SREJ N(R)=4
+    {6, {0x7E, 0xFF, 0xAD, 0x68, 0x8E, 0x7E}}, // SREJ N(R)=5
+    {6, {0x7E, 0xFF, 0xCD, 0x6E, 0xED, 0x7E}}, // SREJ N(R)=6
+    {6, {0x7E, 0xFF, 0xED, 0x6C, 0xCC, 0x7E}}, // SREJ N(R)=7
+    {6, {0x7E, 0xFF, 0x3F, 0xF3, 0x39, 0x7E}}, // CONN
+    {6, {0x7E, 0xFF, 0x7F, 0xF7, 0x7B, 0x7E}}, // CONN (extended mode)
+    {6, {0x7E, 0xFF, 0x63, 0x1A, 0xA1, 0x7E}}, // CONN_ACK
+};
+
+// ACK frames of extended mode, indexed by N(R)
+static const yahdlc_encoded_frame_t yahdlc_extended_ack_frames[128] = {
+    {7, {0x7E, 0xFF, 0x01, 0x00, 0xE7, 0x19, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x02, 0xF5, 0x3A, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x04, 0xC3, 0x5F, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x06, 0xD1, 0x7C, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x08, 0xAF, 0x95, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x0A, 0xBD, 0xB6, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x0C, 0x8B, 0xD3, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x0E, 0x99, 0xF0, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x10, 0x66, 0x09, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x12, 0x74, 0x2A, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x14, 0x42, 0x4F, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x16, 0x50, 0x6C, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x18, 0x2E, 0x85, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x1A, 0x3C, 0xA6, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x1C, 0x0A, 0xC3, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x1E, 0x18, 0xE0, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x20, 0xE5, 0x38, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x22, 0xF7, 0x1B, 0x7E}},
+    {8, {0x7E, 0xFF, 0x01, 0x24, 0xC1, 0x7D, 0x5E, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x26, 0xD3, 0x5D, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x28, 0xAD, 0xB4, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x2A, 0xBF, 0x97, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x2C, 0x89, 0xF2, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x2E, 0x9B, 0xD1, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x30, 0x64, 0x28, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x32, 0x76, 0x0B, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x34, 0x40, 0x6E, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x36, 0x52, 0x4D, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x38, 0x2C, 0xA4, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x3A, 0x3E, 0x87, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x3C, 0x08, 0xE2, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x3E, 0x1A, 0xC1, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x40, 0xE3, 0x5B, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x42, 0xF1, 0x78, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x44, 0xC7, 0x1D, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x46, 0xD5, 0x3E, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x48, 0xAB, 0xD7, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x4A, 0xB9, 0xF4, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x4C, 0x8F, 0x91, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x4E, 0x9D, 0xB2, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x50, 0x62, 0x4B, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x52, 0x70, 0x68, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x54, 0x46, 0x0D, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x56, 0x54, 0x2E, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x58, 0x2A, 0xC7, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x5A, 0x38, 0xE4, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x5C, 0x0E, 0x81, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x5E, 0x1C, 0xA2, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x60, 0xE1, 0x7A, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x62, 0xF3, 0x59, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x64, 0xC5, 0x3C, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x66, 0xD7, 0x1F, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x68, 0xA9, 0xF6, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x6A, 0xBB, 0xD5, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x6C, 0x8D, 0xB0, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x6E, 0x9F, 0x93, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x70, 0x60, 0x6A, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x72, 0x72, 0x49, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x74, 0x44, 0x2C, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x76, 0x56, 0x0F, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x78, 0x28, 0xE6, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x7A, 0x3A, 0xC5, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x7C, 0x0C, 0xA0, 0x7E}},
+    {8, {0x7E, 0xFF, 0x01, 0x7D, 0x5E, 0x1E, 0x83, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x80, 0xEF, 0x9D, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x82, 0xFD, 0xBE, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x84, 0xCB, 0xDB, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x86, 0xD9, 0xF8, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x88, 0xA7, 0x11, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x8A, 0xB5, 0x32, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x8C, 0x83, 0x57, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x8E, 0x91, 0x74, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x90, 0x6E, 0x8D, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x92, 0x7C, 0xAE, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x94, 0x4A, 0xCB, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x96, 0x58, 0xE8, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x98, 0x26, 0x01, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x9A, 0x34, 0x22, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x9C, 0x02, 0x47, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0x9E, 0x10, 0x64, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xA0, 0xED, 0xBC, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xA2, 0xFF, 0x9F, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xA4, 0xC9, 0xFA, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xA6, 0xDB, 0xD9, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xA8, 0xA5, 0x30, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xAA, 0xB7, 0x13, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xAC, 0x81, 0x76, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xAE, 0x93, 0x55, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xB0, 0x6C, 0xAC, 0x7E}},
+    {8, {0x7E, 0xFF, 0x01, 0xB2, 0x7D, 0x5E, 0x8F, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xB4, 0x48, 0xEA, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xB6, 0x5A, 0xC9, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xB8, 0x24, 0x20, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xBA, 0x36, 0x03, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xBC, 0x00, 0x66, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xBE, 0x12, 0x45, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xC0, 0xEB, 0xDF, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xC2, 0xF9, 0xFC, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xC4, 0xCF, 0x99, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xC6, 0xDD, 0xBA, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xC8, 0xA3, 0x53, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xCA, 0xB1, 0x70, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xCC, 0x87, 0x15, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xCE, 0x95, 0x36, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xD0, 0x6A, 0xCF, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xD2, 0x78, 0xEC, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xD4, 0x4E, 0x89, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xD6, 0x5C, 0xAA, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xD8, 0x22, 0x43, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xDA, 0x30, 0x60, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xDC, 0x06, 0x05, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xDE, 0x14, 0x26, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xE0, 0xE9, 0xFE, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xE2, 0xFB, 0xDD, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xE4, 0xCD, 0xB8, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xE6, 0xDF, 0x9B, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xE8, 0xA1, 0x72, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xEA, 0xB3, 0x51, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xEC, 0x85, 0x34, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xEE, 0x97, 0x17, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xF0, 0x68, 0xEE, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xF2, 0x7A, 0xCD, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xF4, 0x4C, 0xA8, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xF6, 0x5E, 0x8B, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xF8, 0x20, 0x62, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xFA, 0x32, 0x41, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xFC, 0x04, 0x24, 0x7E}},
+    {7, {0x7E, 0xFF, 0x01, 0xFE, 0x16, 0x07, 0x7E}},
+};
+
+
+int yahdlc_frame_lookup(const yahdlc_control_t *control, const uint8_t **frame,
+                        size_t *frame_len) {
+    const yahdlc_encoded_frame_t *f = NULL;
+
+    if (!control || !frame || !frame_len) {
+        return -EINVAL;
+    }
+    if (control->fcs32) {
+        return -ENOENT;
+    }
+
+    if (control->extended && control->frame == YAHDLC_FRAME_ACK) {
+        f = &yahdlc_extended_ack_frames[control->recv_seq_no];
+    } else if (!control->extended && control->recv_seq_no < 8) {
+        switch (control->frame) {
+            case YAHDLC_FRAME_ACK:
+                f = &yahdlc_basic_frames[control->recv_seq_no];
+                break;
+            case YAHDLC_FRAME_NACK:
+                f = &yahdlc_basic_frames[8 + control->recv_seq_no];
+                break;
+            case YAHDLC_FRAME_SREJ:
+                f = &yahdlc_basic_frames[16 + control->recv_seq_no];
+                break;
+            default:
+                break;
         }
     }
+    // U frames look the same in both modes, except that CONN becomes SABME in extended mode
+    if (control->frame == YAHDLC_FRAME_CONN) {
+        f = &yahdlc_basic_frames[control->extended ? 25 : 24];
+    } else if (control->frame == YAHDLC_FRAME_CONN_ACK) {
+        f = &yahdlc_basic_frames[26];
+    }
+
+    if (f == NULL) {
+        return -ENOENT;
+    }
+    *frame = f->bytes;
+    *frame_len = f->len;
+    return 0;
+}
 
-    // Invert the FCS value accordingly to the specification
-    fcs ^= 0xFFFF;
 
-    // Run through the FCS bytes and escape the values
-    for (i = 0; i < sizeof(fcs); i++) {
-        value = ((fcs >> (8 * i)) & 0xFF);
-        yahdlc_escape_value(value, dest, &dest_index);
+// Escaped forms of the flag sequence and control escape bytes, used as segments of frames created
+// by yahdlc_frame_data_vec
+static const uint8_t yahdlc_escaped_flag[2] = {YAHDLC_CONTROL_ESCAPE, YAHDLC_FLAG_SEQUENCE ^ 0x20};
+static const uint8_t yahdlc_escaped_escape[2] = {YAHDLC_CONTROL_ESCAPE,
+                                                 YAHDLC_CONTROL_ESCAPE ^ 0x20};
+
+
+/**
+ * Appends a segment to `iov`, transmitting the segments collected so far first if it is full
+ */
+static int yahdlc_push_segment(yahdlc_iovec_t *iov, size_t *iov_count, const uint8_t *base,
+                               size_t len, bool (*transmit)(const yahdlc_iovec_t*, size_t, void*),
+                               void *context) {
+    if (len == 0) {
+        return 0;
+    }
+    if (*iov_count == YAHDLC_IOV_MAX) {
+        if (!transmit(iov, *iov_count, context)) {
+            return -EIO;
+        }
+        *iov_count = 0;
     }
+    iov[*iov_count].base = base;
+    iov[*iov_count].len = len;
+    (*iov_count)++;
+    return 0;
+}
 
-    // Add end flag sequence and update length of frame
-    if (dest) {
-        dest[dest_index++] = YAHDLC_FLAG_SEQUENCE;
-    } else {
-        dest_index++;
+
+int yahdlc_frame_data_vec(yahdlc_control_t *control, const uint8_t *src, size_t src_len,
+                          bool (*transmit)(const yahdlc_iovec_t*, size_t, void*), void *context) {
+    // Start flag, address and up to two control field bytes, each of them possibly escaped
+    uint8_t header[3], head[7];
+    // Up to four FCS bytes, each of them possibly escaped, and end flag
+    uint8_t tail[9];
+    uint8_t *p;
+    yahdlc_iovec_t iov[YAHDLC_IOV_MAX];
+    size_t iov_count = 0, header_len;
+    uint32_t fcs;
+
+    // Make sure that all parameters are valid
+    if (!control || (!src && (src_len > 0)) || !transmit) {
+        return -EINVAL;
     }
-    *dest_len = dest_index;
 
+    header_len = yahdlc_frame_header(control, header);
+    fcs = yahdlc_fcs_buf(control->fcs32, yahdlc_fcs_init(control->fcs32), header, header_len);
+    p = head;
+    *p++ = YAHDLC_FLAG_SEQUENCE;
+    for (size_t i = 0; i < header_len; i++) {
+        p = yahdlc_put_escaped(p, header[i]);
+    }
+    iov[iov_count].base = head;
+    iov[iov_count].len = p - head;
+    iov_count++;
+
+    // Only DATA frames should contain data. Runs of bytes which need no escaping are passed as they
+    // are, each escaped byte is a segment of its own.
+    if (control->frame == YAHDLC_FRAME_DATA) {
+        size_t run_start = 0, i;
+        fcs = yahdlc_fcs_buf(control->fcs32, fcs, src, src_len);
+        while ((i = run_start + yahdlc_scan_control_bytes(src + run_start,
+                                                           src_len - run_start)) < src_len) {
+            const uint8_t *escaped = (src[i] == YAHDLC_FLAG_SEQUENCE) ? yahdlc_escaped_flag
+                                                                      : yahdlc_escaped_escape;
+            if (yahdlc_push_segment(iov, &iov_count, src + run_start, i - run_start, transmit,
+                                    context) != 0 ||
+                yahdlc_push_segment(iov, &iov_count, escaped, 2, transmit, context) != 0) {
+                return -EIO;
+            }
+            run_start = i + 1;
+        }
+        if (yahdlc_push_segment(iov, &iov_count, src + run_start, src_len - run_start, transmit,
+                                context) != 0) {
+            return -EIO;
+        }
+    }
+
+    // Invert the FCS value accordingly to the specification and escape its bytes
+    p = yahdlc_put_fcs(tail, control->fcs32, fcs);
+    *p++ = YAHDLC_FLAG_SEQUENCE;
+
+    if (yahdlc_push_segment(iov, &iov_count, tail, p - tail, transmit, context) != 0 ||
+        !transmit(iov, iov_count, context)) {
+        return -EIO;
+    }
     return 0;
 }
@@ -83,8 +83,12 @@ static int Dc_Py_InitDeadcomL2(Dc_Py_ObjDeadcomL2 *self, PyObject *args, PyObjec
     Dc_Py_Helper_InitAssignArgIfAny(self->tvmt_condvarWait, tvmt_condvarWait);
     Dc_Py_Helper_InitAssignArgIfAny(self->tvmt_condvarSignal, tvmt_condvarSignal);
 
+    DeadcomL2Config config;
+    dcDefaultConfig(&config);
+    config.storage = self->storage;
+    config.storage_len = sizeof(self->storage);
     DeadcomL2Result r = dcInit(&(self->dcl2), self, self, &Dc_Py_BridgeThreadingMethods,
-                               Dc_Py_BridgeTransmit, self);
+                               Dc_Py_BridgeTransmit, self, &config);
     if (r == DC_FAILURE && PyErr_Occurred()) {
         return -1;
     }
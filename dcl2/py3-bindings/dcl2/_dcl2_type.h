@@ -6,6 +6,7 @@
 typedef struct {
     PyObject_HEAD
     DeadcomL2 dcl2;
+    uint8_t storage[DEADCOM_DEFAULT_STORAGE_SIZE];
     PyObject *mutex;
     PyObject *condvar;
     PyObject *transmitFunction;
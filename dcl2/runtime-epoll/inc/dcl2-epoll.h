@@ -0,0 +1,77 @@
+/**
+ * @file    dcl2-epoll.h
+ * @brief   DeadCom Layer 2 event loop runtime for Linux
+ *
+ * This is a small runtime which serves many DeadCom links over file descriptors (such as serial
+ * ports or pseudoterminals) from a single thread. The thread waits on all descriptors with `epoll`,
+ * feeds received bytes to dcProcessData and drives timers of all links (see dcTick) from a
+ * `timerfd`. Received messages are passed to a callback, either right from the event loop or from
+ * a pool of worker threads. Links are initialized with the pthreads helper (see dcl2-pthreads.h).
+ *
+ * Messages are sent by dcSendMessageAsync, which never blocks, so no thread is needed per link for
+ * transmission either.
+ */
+
+#ifndef __DEADCOML2_EPOLL_H
+#define __DEADCOML2_EPOLL_H
+
+#include "dcl2.h"
+
+
+typedef struct dcl2_epoll dcl2_epoll_t;
+
+
+/**
+ * Create the runtime and start its event loop thread (and worker threads, if any).
+ *
+ * @param onMessage  Function called for every received message with the link it was received on,
+ *                   the message, its length and the context given to dcEpollAddLink. If there are
+ *                   no workers, it is called from the event loop thread with the link locked and
+ *                   the message points into the link's internal buffer (see dcSetMessageCallback),
+ *                   so it must not block and it must not call any function of the library. Worker
+ *                   threads get a copy of the message and may call the library (e.g. to send a
+ *                   response), but messages of one link may then be handled by several workers at
+ *                   once, out of order.
+ * @param workers  Number of worker threads calling `onMessage`, 0 to call it from the event loop
+ * @param tick_ms  Period of dcTick calls in milliseconds, it limits the precision of
+ *                 retransmission timeouts
+ *
+ * @return The runtime, or NULL if it could not be created
+ */
+dcl2_epoll_t* dcEpollCreate(void (*onMessage)(DeadcomL2*, const uint8_t*, size_t, void*),
+                            unsigned int workers, uint32_t tick_ms);
+
+
+/**
+ * Initialize a DeadCom link communicating over file descriptor `fd` and add it to the runtime.
+ *
+ * The link is initialized by dcPthreadsInitConfig with configuration `config` (NULL means the
+ * default configuration) and transmits by writing to `fd`. If `fd` is blocking, transmission blocks
+ * the calling thread (which may be the event loop) while the output buffer of the descriptor is
+ * full. The event loop reads from `fd` only once it is readable.
+ *
+ * The link stays in the runtime until it is destroyed, the descriptor is left open and it must not
+ * be closed before that. If the descriptor is hung up or fails, it is removed from the event loop
+ * and the link is disconnected.
+ *
+ * @param rt  The runtime
+ * @param fd  Descriptor the link communicates over
+ * @param config  Configuration of the link, or NULL
+ * @param context  Context passed to `onMessage` with messages of this link
+ *
+ * @return The link, or NULL if it could not be created. Use it with the usual functions of the
+ *         library, e.g. dcConnect and dcSendMessageAsync.
+ */
+DeadcomL2* dcEpollAddLink(dcl2_epoll_t *rt, int fd, const DeadcomL2Config *config, void *context);
+
+
+/**
+ * Stop the runtime and free it together with all its links.
+ *
+ * The event loop and worker threads are stopped first, messages still waiting for a worker are
+ * discarded. Must not be called from `onMessage`.
+ */
+void dcEpollDestroy(dcl2_epoll_t *rt);
+
+
+#endif
@@ -0,0 +1,355 @@
+#define _GNU_SOURCE
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "dcl2-pthreads.h"
+#include "dcl2-epoll.h"
+
+
+// Size of the buffer received bytes are read into, one read per readiness of a descriptor
+#define DCL2_EPOLL_READ_LEN 512
+// Number of events taken from epoll at once
+#define DCL2_EPOLL_MAX_EVENTS 64
+
+
+typedef struct dcl2_epoll_link dcl2_epoll_link_t;
+
+struct dcl2_epoll_link {
+    DeadcomL2 deadcom;
+    dcl2_epoll_t *rt;
+    int fd;
+    void *context;
+    dcl2_epoll_link_t *next;
+};
+
+// Copy of a received message waiting for a worker
+typedef struct dcl2_epoll_job dcl2_epoll_job_t;
+
+struct dcl2_epoll_job {
+    dcl2_epoll_link_t *link;
+    dcl2_epoll_job_t *next;
+    size_t len;
+    uint8_t message[];
+};
+
+struct dcl2_epoll {
+    void (*onMessage)(DeadcomL2*, const uint8_t*, size_t, void*);
+    int epoll_fd;
+    int timer_fd;
+    int stop_fd;
+    pthread_t loop;
+
+    // All links, swept by every tick
+    pthread_mutex_t links_mutx;
+    dcl2_epoll_link_t *links;
+
+    // Worker pool and its FIFO of messages
+    unsigned int worker_count;
+    pthread_t *workers;
+    pthread_mutex_t jobs_mutx;
+    pthread_cond_t jobs_cond;
+    dcl2_epoll_job_t *jobs_head;
+    dcl2_epoll_job_t *jobs_tail;
+    bool stopping;
+};
+
+
+static uint32_t nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+
+/**
+ * Message callback of all links. Either hands the message to the application right away or queues
+ * its copy for the worker pool (the message is dropped if it can't be copied).
+ */
+static void dcl_epoll_onMessage(const uint8_t *message, size_t len, void *link_p) {
+    dcl2_epoll_link_t *link = (dcl2_epoll_link_t*) link_p;
+    dcl2_epoll_t *rt = link->rt;
+
+    if (rt->worker_count == 0) {
+        rt->onMessage(&link->deadcom, message, len, link->context);
+        return;
+    }
+
+    dcl2_epoll_job_t *job = malloc(sizeof(dcl2_epoll_job_t) + len);
+    if (job == NULL) {
+        return;
+    }
+    job->link = link;
+    job->next = NULL;
+    job->len = len;
+    memcpy(job->message, message, len);
+
+    pthread_mutex_lock(&rt->jobs_mutx);
+    if (rt->jobs_tail == NULL) {
+        rt->jobs_head = job;
+    } else {
+        rt->jobs_tail->next = job;
+    }
+    rt->jobs_tail = job;
+    pthread_cond_signal(&rt->jobs_cond);
+    pthread_mutex_unlock(&rt->jobs_mutx);
+}
+
+
+static void* dcl_epoll_worker(void *rt_p) {
+    dcl2_epoll_t *rt = (dcl2_epoll_t*) rt_p;
+
+    pthread_mutex_lock(&rt->jobs_mutx);
+    while (true) {
+        while (rt->jobs_head == NULL && !rt->stopping) {
+            pthread_cond_wait(&rt->jobs_cond, &rt->jobs_mutx);
+        }
+        if (rt->stopping) {
+            break;
+        }
+        dcl2_epoll_job_t *job = rt->jobs_head;
+        rt->jobs_head = job->next;
+        if (rt->jobs_head == NULL) {
+            rt->jobs_tail = NULL;
+        }
+        pthread_mutex_unlock(&rt->jobs_mutx);
+
+        rt->onMessage(&job->link->deadcom, job->message, job->len, job->link->context);
+        free(job);
+
+        pthread_mutex_lock(&rt->jobs_mutx);
+    }
+    pthread_mutex_unlock(&rt->jobs_mutx);
+    return NULL;
+}
+
+
+/**
+ * Read whatever the descriptor of the link has to offer and process it. If the descriptor is hung
+ * up or fails, stop watching it and disconnect the link.
+ */
+static void serveLink(dcl2_epoll_t *rt, dcl2_epoll_link_t *link, uint32_t events) {
+    uint8_t buffer[DCL2_EPOLL_READ_LEN];
+
+    if (events & EPOLLIN) {
+        ssize_t len = read(link->fd, buffer, sizeof(buffer));
+        if (len > 0) {
+            dcProcessData(&link->deadcom, buffer, len);
+            return;
+        }
+        if (len < 0 && (errno == EAGAIN || errno == EINTR)) {
+            return;
+        }
+    }
+    // End of file, read error, hang up or error condition
+    epoll_ctl(rt->epoll_fd, EPOLL_CTL_DEL, link->fd, NULL);
+    dcDisconnect(&link->deadcom);
+}
+
+
+static void tickLinks(dcl2_epoll_t *rt) {
+    uint64_t expirations;
+    if (read(rt->timer_fd, &expirations, sizeof(expirations)) < 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&rt->links_mutx);
+    uint32_t now = nowMs();
+    for (dcl2_epoll_link_t *link = rt->links; link != NULL; link = link->next) {
+        dcTick(&link->deadcom, now);
+    }
+    pthread_mutex_unlock(&rt->links_mutx);
+}
+
+
+static void* dcl_epoll_loop(void *rt_p) {
+    dcl2_epoll_t *rt = (dcl2_epoll_t*) rt_p;
+    struct epoll_event events[DCL2_EPOLL_MAX_EVENTS];
+
+    while (true) {
+        int count = epoll_wait(rt->epoll_fd, events, DCL2_EPOLL_MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return NULL;
+        }
+        for (int i = 0; i < count; i++) {
+            void *source = events[i].data.ptr;
+            if (source == &rt->stop_fd) {
+                return NULL;
+            } else if (source == &rt->timer_fd) {
+                tickLinks(rt);
+            } else {
+                serveLink(rt, (dcl2_epoll_link_t*) source, events[i].events);
+            }
+        }
+    }
+}
+
+
+/**
+ * Watch descriptor `fd` for input, reporting `ptr` with its events. Returns false if epoll has
+ * failed.
+ */
+static bool watchFd(dcl2_epoll_t *rt, int fd, void *ptr) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = ptr;
+    return epoll_ctl(rt->epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+
+/**
+ * Stop worker threads started so far and discard messages waiting for them.
+ */
+static void stopWorkers(dcl2_epoll_t *rt, unsigned int started) {
+    pthread_mutex_lock(&rt->jobs_mutx);
+    rt->stopping = true;
+    pthread_cond_broadcast(&rt->jobs_cond);
+    pthread_mutex_unlock(&rt->jobs_mutx);
+
+    for (unsigned int i = 0; i < started; i++) {
+        pthread_join(rt->workers[i], NULL);
+    }
+
+    while (rt->jobs_head != NULL) {
+        dcl2_epoll_job_t *job = rt->jobs_head;
+        rt->jobs_head = job->next;
+        free(job);
+    }
+    rt->jobs_tail = NULL;
+}
+
+
+static void freeRuntime(dcl2_epoll_t *rt) {
+    if (rt->epoll_fd >= 0) {
+        close(rt->epoll_fd);
+    }
+    if (rt->timer_fd >= 0) {
+        close(rt->timer_fd);
+    }
+    if (rt->stop_fd >= 0) {
+        close(rt->stop_fd);
+    }
+    pthread_mutex_destroy(&rt->links_mutx);
+    pthread_mutex_destroy(&rt->jobs_mutx);
+    pthread_cond_destroy(&rt->jobs_cond);
+    free(rt->workers);
+    free(rt);
+}
+
+
+dcl2_epoll_t* dcEpollCreate(void (*onMessage)(DeadcomL2*, const uint8_t*, size_t, void*),
+                            unsigned int workers, uint32_t tick_ms) {
+    if (onMessage == NULL || tick_ms == 0) {
+        return NULL;
+    }
+
+    dcl2_epoll_t *rt = calloc(1, sizeof(dcl2_epoll_t));
+    if (rt == NULL) {
+        return NULL;
+    }
+    rt->onMessage = onMessage;
+    rt->worker_count = workers;
+    pthread_mutex_init(&rt->links_mutx, NULL);
+    pthread_mutex_init(&rt->jobs_mutx, NULL);
+    pthread_cond_init(&rt->jobs_cond, NULL);
+
+    rt->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    rt->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    rt->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    rt->workers = calloc(workers ? workers : 1, sizeof(pthread_t));
+    if (rt->epoll_fd < 0 || rt->timer_fd < 0 || rt->stop_fd < 0 || rt->workers == NULL) {
+        freeRuntime(rt);
+        return NULL;
+    }
+
+    struct itimerspec period;
+    period.it_interval.tv_sec = tick_ms / 1000;
+    period.it_interval.tv_nsec = (tick_ms % 1000) * 1000000;
+    period.it_value = period.it_interval;
+    if (timerfd_settime(rt->timer_fd, 0, &period, NULL) != 0 ||
+        !watchFd(rt, rt->timer_fd, &rt->timer_fd) || !watchFd(rt, rt->stop_fd, &rt->stop_fd)) {
+        freeRuntime(rt);
+        return NULL;
+    }
+
+    for (unsigned int i = 0; i < workers; i++) {
+        if (pthread_create(&rt->workers[i], NULL, &dcl_epoll_worker, rt) != 0) {
+            stopWorkers(rt, i);
+            freeRuntime(rt);
+            return NULL;
+        }
+    }
+    if (pthread_create(&rt->loop, NULL, &dcl_epoll_loop, rt) != 0) {
+        stopWorkers(rt, workers);
+        freeRuntime(rt);
+        return NULL;
+    }
+    return rt;
+}
+
+
+DeadcomL2* dcEpollAddLink(dcl2_epoll_t *rt, int fd, const DeadcomL2Config *config, void *context) {
+    if (rt == NULL || fd < 0) {
+        return NULL;
+    }
+
+    dcl2_epoll_link_t *link = calloc(1, sizeof(dcl2_epoll_link_t));
+    if (link == NULL) {
+        return NULL;
+    }
+    link->rt = rt;
+    link->fd = fd;
+    link->context = context;
+
+    if (dcPthreadsInitConfig(&link->deadcom, config, &dcPthreadsWriteFd, &link->fd) != DC_OK) {
+        free(link);
+        return NULL;
+    }
+    if (dcSetMessageCallback(&link->deadcom, &dcl_epoll_onMessage, link) != DC_OK) {
+        dcPthreadsFree(&link->deadcom);
+        free(link);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&rt->links_mutx);
+    if (!watchFd(rt, fd, link)) {
+        pthread_mutex_unlock(&rt->links_mutx);
+        dcPthreadsFree(&link->deadcom);
+        free(link);
+        return NULL;
+    }
+    link->next = rt->links;
+    rt->links = link;
+    pthread_mutex_unlock(&rt->links_mutx);
+    return &link->deadcom;
+}
+
+
+void dcEpollDestroy(dcl2_epoll_t *rt) {
+    if (rt == NULL) {
+        return;
+    }
+
+    uint64_t one = 1;
+    ssize_t written = write(rt->stop_fd, &one, sizeof(one));
+    (void) written;
+    pthread_join(rt->loop, NULL);
+    stopWorkers(rt, rt->worker_count);
+
+    while (rt->links != NULL) {
+        dcl2_epoll_link_t *link = rt->links;
+        rt->links = link->next;
+        dcPthreadsFree(&link->deadcom);
+        free(link);
+    }
+    freeRuntime(rt);
+}
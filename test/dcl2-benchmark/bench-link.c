@@ -0,0 +1,201 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "leaky-pipe.h"
+#include "dcl2.h"
+#include "dcl2-pthreads.h"
+#include "bench-link.h"
+
+/*
+ * Emulated serial line used by benchmarks. Each direction consists of:
+ *
+ *  - transmit callback, which blocks for as long as the bytes would take to be clocked out at the
+ *    configured baud rate and then queues them with a delivery timestamp,
+ *  - delay thread, which pushes queued bytes into a leaky pipe once their delivery time comes,
+ *  - receive thread, which feeds bytes from the leaky pipe to the receiving station.
+ */
+
+typedef struct chunk {
+    struct chunk *next;
+    uint64_t deliver_at;
+    size_t len;
+    uint8_t bytes[];
+} chunk_t;
+
+typedef struct {
+    leaky_pipe_t pipe;
+    DeadcomL2 *destination;
+    pthread_mutex_t mtx;
+    pthread_cond_t cnd;
+    chunk_t *head, *tail;
+    uint64_t busy_until;
+    uint64_t bytes_sent;
+    bool stop;
+    pthread_t delay_thread;
+    pthread_t rx_thread;
+} line_t;
+
+static bench_link_args_t link_args;
+static line_t lines[2];
+static DeadcomL2 *stations[2];
+
+
+uint64_t benchNowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sleepUntilUs(uint64_t t) {
+    struct timespec ts;
+    ts.tv_sec = t / 1000000;
+    ts.tv_nsec = (t % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0);
+}
+
+static bool line_tx(const uint8_t *bytes, size_t b_l, void *context) {
+    line_t *line = (line_t*) context;
+    chunk_t *c = malloc(sizeof(chunk_t) + b_l);
+    memcpy(c->bytes, bytes, b_l);
+    c->len = b_l;
+    c->next = NULL;
+
+    pthread_mutex_lock(&line->mtx);
+    uint64_t now = benchNowUs();
+    uint64_t start = (line->busy_until > now) ? line->busy_until : now;
+    line->busy_until = start + (link_args.baud ? (b_l * 10 * 1000000ULL) / link_args.baud : 0);
+    line->bytes_sent += b_l;
+    c->deliver_at = line->busy_until + link_args.latency_us;
+    uint64_t done = line->busy_until;
+    if (line->tail) {
+        line->tail->next = c;
+    } else {
+        line->head = c;
+    }
+    line->tail = c;
+    pthread_cond_signal(&line->cnd);
+    pthread_mutex_unlock(&line->mtx);
+
+    // Like a blocking UART write, return only after the bytes were clocked out
+    sleepUntilUs(done);
+    return true;
+}
+
+static void* delay_thread(void *p) {
+    line_t *line = (line_t*) p;
+    pthread_mutex_lock(&line->mtx);
+    while (true) {
+        while (!line->stop && line->head == NULL) {
+            pthread_cond_wait(&line->cnd, &line->mtx);
+        }
+        if (line->stop) {
+            break;
+        }
+        chunk_t *c = line->head;
+        line->head = c->next;
+        if (line->head == NULL) {
+            line->tail = NULL;
+        }
+        pthread_mutex_unlock(&line->mtx);
+
+        sleepUntilUs(c->deliver_at);
+        for (size_t i = 0; i < c->len; i++) {
+            lp_transmit(&line->pipe, c->bytes[i]);
+        }
+        free(c);
+
+        pthread_mutex_lock(&line->mtx);
+    }
+    pthread_mutex_unlock(&line->mtx);
+    return NULL;
+}
+
+static void* rx_thread(void *p) {
+    line_t *line = (line_t*) p;
+    uint8_t b[1];
+    // lp_receive blocks until the whole buffer is filled, therefore we go byte-by-byte
+    while (lp_receive(&line->pipe, b, 1)) {
+        dcProcessData(line->destination, b, 1);
+    }
+    return NULL;
+}
+
+void benchLinkCreate(bench_link_args_t *args, DeadcomL2 *c, DeadcomL2 *r,
+                     const DeadcomL2Config *r_config) {
+    benchLinkCreateConfig(args, c, NULL, r, r_config);
+}
+
+void benchLinkCreateConfig(bench_link_args_t *args, DeadcomL2 *c, const DeadcomL2Config *c_config,
+                           DeadcomL2 *r, const DeadcomL2Config *r_config) {
+    link_args = *args;
+    stations[0] = c;
+    stations[1] = r;
+
+    for (int i = 0; i < 2; i++) {
+        line_t *line = &lines[i];
+        memset(line, 0, sizeof(line_t));
+        lp_args_t faults = link_args.faults;
+        faults.seed += i;
+        lp_init(&line->pipe, &faults);
+        pthread_mutex_init(&line->mtx, NULL);
+        pthread_cond_init(&line->cnd, NULL);
+        // line 0 carries data from station c to r, line 1 from r to c
+        line->destination = stations[1 - i];
+        dcPthreadsInitConfig(stations[i], (i == 1) ? r_config : c_config, &line_tx, line);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&lines[i].delay_thread, NULL, &delay_thread, &lines[i]);
+        pthread_create(&lines[i].rx_thread, NULL, &rx_thread, &lines[i]);
+    }
+}
+
+void benchLinkDestroy() {
+    for (int i = 0; i < 2; i++) {
+        line_t *line = &lines[i];
+        pthread_mutex_lock(&line->mtx);
+        line->stop = true;
+        pthread_cond_signal(&line->cnd);
+        pthread_mutex_unlock(&line->mtx);
+        pthread_join(line->delay_thread, NULL);
+        lp_cutoff(&line->pipe);
+        pthread_join(line->rx_thread, NULL);
+        while (line->head) {
+            chunk_t *c = line->head;
+            line->head = c->next;
+            free(c);
+        }
+        pthread_mutex_destroy(&line->mtx);
+        pthread_cond_destroy(&line->cnd);
+    }
+    for (int i = 0; i < 2; i++) {
+        dcPthreadsFree(stations[i]);
+    }
+}
+
+uint64_t benchLinkBytesSent(DeadcomL2 *station) {
+    line_t *line = &lines[(station == stations[0]) ? 0 : 1];
+    pthread_mutex_lock(&line->mtx);
+    uint64_t bytes = line->bytes_sent;
+    pthread_mutex_unlock(&line->mtx);
+    return bytes;
+}
+
+unsigned int benchReceive(DeadcomL2 *r, unsigned int count) {
+    uint8_t message[DEADCOM_PAYLOAD_MAX_LEN];
+    unsigned int received = 0;
+    while (received < count) {
+        size_t msg_len;
+        if (dcGetReceivedMsg(r, message, &msg_len) != DC_OK) {
+            break;
+        }
+        if (msg_len == 0) {
+            struct timespec t = {0, 100000};
+            nanosleep(&t, NULL);
+        } else {
+            received++;
+        }
+    }
+    return received;
+}
@@ -0,0 +1,58 @@
+#ifndef __BENCH_LINK_H
+#define __BENCH_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "leaky-pipe.h"
+#include "dcl2.h"
+
+/**
+ * Parameters of an emulated serial line between two stations.
+ */
+typedef struct {
+    /** Line speed in bauds (10 bauds per byte). 0 means infinitely fast line. */
+    unsigned long baud;
+    /** One-way propagation delay of each transmitted frame */
+    unsigned long latency_us;
+    /** Faults introduced in both directions */
+    lp_args_t faults;
+} bench_link_args_t;
+
+
+/**
+ * Connects stations `c` and `r` with an emulated line. Both stations are initialized with
+ * dcPthreadsInitConfig and receive threads feeding dcProcessData are started. Station `c` uses the
+ * default configuration, station `r` uses `r_config` (NULL means the default configuration).
+ */
+void benchLinkCreate(bench_link_args_t *args, DeadcomL2 *c, DeadcomL2 *r,
+                     const DeadcomL2Config *r_config);
+
+/**
+ * Same as benchLinkCreate, station `c` uses `c_config` (NULL means the default configuration).
+ */
+void benchLinkCreateConfig(bench_link_args_t *args, DeadcomL2 *c, const DeadcomL2Config *c_config,
+                           DeadcomL2 *r, const DeadcomL2Config *r_config);
+
+/**
+ * Cuts the emulated line, stops receive threads and frees both stations.
+ */
+void benchLinkDestroy();
+
+/**
+ * Number of bytes transmitted so far by `station` (one of the stations passed to benchLinkCreate),
+ * including bytes which were then dropped by the line.
+ */
+uint64_t benchLinkBytesSent(DeadcomL2 *station);
+
+/**
+ * Receives `count` messages on station `r`, polling dcGetReceivedMsg. Returns number of messages
+ * actually received before the link was reset.
+ */
+unsigned int benchReceive(DeadcomL2 *r, unsigned int count);
+
+/**
+ * Monotonic time in microseconds.
+ */
+uint64_t benchNowUs();
+
+#endif
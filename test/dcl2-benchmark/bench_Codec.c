@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "yahdlc.h"
+#include "dcl2.h"
+#include "bench-link.h"
+
+/*
+ * CPU time spent framing DATA frames, depending on the payload length. "two-pass" is computing the
+ * frame length first and encoding it afterwards, "one-pass" is encoding into a buffer large enough
+ * for any frame. ACK frames are either encoded the same way or looked up in the table of frames
+ * encoded in advance. FCS is computed byte by byte, with fcs16_buf, or as CRC-32C. Decoding is
+ * measured on a stream of DATA frames fed in large chunks, the way dcProcessData processes it.
+ *
+ * Usage: bench_Codec.out [iterations]
+ */
+
+static unsigned long iterations = 200000;
+
+static uint8_t payload[DEADCOM_PAYLOAD_MAX_LEN];
+static uint8_t frame[DEADCOM_MAX_FRAME_LEN];
+
+// Prevents the compiler from optimizing the encoded frames away
+static volatile uint8_t sink;
+
+static double bench_encode(size_t len, int two_pass) {
+    yahdlc_control_t control = {.frame = YAHDLC_FRAME_DATA, .send_seq_no = 3, .recv_seq_no = 5};
+    size_t frame_len;
+    uint64_t start = benchNowUs();
+    for (unsigned long i = 0; i < iterations; i++) {
+        if (two_pass) {
+            yahdlc_frame_data(&control, payload, len, NULL, &frame_len);
+        }
+        yahdlc_frame_data(&control, payload, len, frame, &frame_len);
+        sink = frame[frame_len / 2];
+    }
+    return (benchNowUs() - start) * 1000.0 / iterations;
+}
+
+static double bench_ack(int lookup) {
+    yahdlc_control_t control = {.frame = YAHDLC_FRAME_ACK};
+    const uint8_t *encoded;
+    size_t frame_len;
+    uint64_t start = benchNowUs();
+    for (unsigned long i = 0; i < iterations; i++) {
+        control.recv_seq_no = i % 8;
+        if (lookup) {
+            yahdlc_frame_lookup(&control, &encoded, &frame_len);
+        } else {
+            yahdlc_frame_data(&control, NULL, 0, frame, &frame_len);
+            encoded = frame;
+        }
+        sink = encoded[frame_len / 2];
+    }
+    return (benchNowUs() - start) * 1000.0 / iterations;
+}
+
+static double bench_fcs(size_t len, int bulk) {
+    uint32_t fcs = FCS16_INIT_VALUE;
+    uint64_t start = benchNowUs();
+    for (unsigned long i = 0; i < iterations; i++) {
+        if (bulk == 2) {
+            fcs = fcs32_buf(fcs, payload, len);
+        } else if (bulk) {
+            fcs = fcs16_buf(fcs, payload, len);
+        } else {
+            for (size_t j = 0; j < len; j++) {
+                fcs = fcs16(fcs, payload[j]);
+            }
+        }
+    }
+    sink = fcs;
+    return (benchNowUs() - start) * 1000.0 / iterations;
+}
+
+static double bench_decode(size_t len, size_t chunk_len) {
+    const size_t frames = 64;
+    uint8_t *stream = malloc(frames * DEADCOM_MAX_FRAME_LEN);
+    size_t stream_len = 0;
+    yahdlc_control_t control = {.frame = YAHDLC_FRAME_DATA};
+    for (size_t f = 0; f < frames; f++) {
+        size_t frame_len;
+        control.send_seq_no = f % 8;
+        yahdlc_frame_data(&control, payload, len, stream + stream_len, &frame_len);
+        stream_len += frame_len;
+    }
+
+    yahdlc_state_t state;
+    yahdlc_reset_state(&state, DEADCOM_PAYLOAD_MAX_LEN + 3);
+    uint8_t dest[DEADCOM_PAYLOAD_MAX_LEN + 3];
+    unsigned long decoded = 0;
+    unsigned long rounds = iterations / frames + 1;
+    uint64_t start = benchNowUs();
+    for (unsigned long r = 0; r < rounds; r++) {
+        for (size_t offset = 0; offset < stream_len; offset += chunk_len) {
+            size_t chunk = (stream_len - offset < chunk_len) ? stream_len - offset : chunk_len;
+            size_t processed = 0;
+            while (processed < chunk) {
+                size_t dest_len;
+                int ret = yahdlc_get_data(&state, &control, stream + offset + processed,
+                                          chunk - processed, dest, &dest_len);
+                if (ret == -ENOMSG) {
+                    break;
+                } else if (ret < 0) {
+                    processed += dest_len;
+                } else {
+                    processed += ret;
+                    decoded++;
+                }
+            }
+        }
+    }
+    uint64_t elapsed = benchNowUs() - start;
+    free(stream);
+    if (decoded != rounds * frames) {
+        fprintf(stderr, "Decoded %lu frames instead of %lu\n", decoded, rounds * frames);
+        exit(1);
+    }
+    // Input MB/s
+    return (double)stream_len * rounds / elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) iterations = strtoul(argv[1], NULL, 10);
+    if (iterations == 0) {
+        fprintf(stderr, "Number of iterations must be positive\n");
+        return 1;
+    }
+
+    unsigned int seed = 1;
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = rand_r(&seed) % 256;
+    }
+
+    const size_t lengths[] = {16, 120, DEADCOM_PAYLOAD_MAX_LEN};
+    printf("%lu iterations, random payload\n", iterations);
+    printf("%-10s %8s %12s %12s\n", "encoder", "payload", "ns/frame", "MB/s");
+    for (int two_pass = 1; two_pass >= 0; two_pass--) {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            double ns = bench_encode(lengths[l], two_pass);
+            printf("%-10s %8zu %12.1f %12.1f\n", two_pass ? "two-pass" : "one-pass", lengths[l],
+                   ns, lengths[l] * 1000.0 / ns);
+        }
+    }
+    printf("%-10s %8s %12.1f\n", "ack", "encode", bench_ack(0));
+    printf("%-10s %8s %12.1f\n", "ack", "lookup", bench_ack(1));
+
+    const char *fcs_names[] = {"fcs-byte", "fcs-buf", "fcs32-buf"};
+    for (int bulk = 0; bulk <= 2; bulk++) {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            double ns = bench_fcs(lengths[l], bulk);
+            printf("%-10s %8zu %12.1f %12.1f\n", fcs_names[bulk], lengths[l], ns,
+                   lengths[l] * 1000.0 / ns);
+        }
+    }
+
+    printf("%-10s %8s %12s %12s\n", "decoder", "payload", "chunk", "MB/s");
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        const size_t chunks[] = {1, 4096};
+        for (size_t c = 0; c < 2; c++) {
+            printf("%-10s %8zu %12zu %12.1f\n", "decode", lengths[l], chunks[c],
+                   bench_decode(lengths[l], chunks[c]));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+#define _GNU_SOURCE
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "dcl2.h"
+#include "dcl2-epoll.h"
+#include "bench-link.h"
+
+/*
+ * CPU cost of links served by the epoll runtime, depending on the number of links.
+ *
+ * The controller (this process) serves one end of every link by a single runtime, the devices
+ * (a child process) serve the other ends and echo every message back. Links run over
+ * pseudoterminal pairs. CPU time of the controller is measured while the links are idle (just
+ * timers are driven) and while the controller sends a message over every link each period.
+ *
+ * Usage: bench_EpollLinks.out [duration_s] [period_ms]
+ */
+
+#define MESSAGE_LEN 16
+#define TICK_MS 10
+
+static const unsigned int link_counts[] = {100, 500, 1000};
+
+static volatile unsigned long echoed;
+
+static void count_echo(DeadcomL2 *link, const uint8_t *message, size_t len, void *context) {
+    (void)link; (void)message; (void)len; (void)context;
+    __atomic_add_fetch(&echoed, 1, __ATOMIC_RELAXED);
+}
+
+static void ignore_completion(DeadcomL2Result result, void *context) {
+    (void)result; (void)context;
+}
+
+static void echo(DeadcomL2 *link, const uint8_t *message, size_t len, void *context) {
+    (void)context;
+    dcSendMessageAsync(link, message, len, &ignore_completion, NULL);
+}
+
+static bool open_pty_pair(int *master, int *slave) {
+    struct termios tio;
+    *master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (*master < 0 || grantpt(*master) != 0 || unlockpt(*master) != 0) {
+        return false;
+    }
+    *slave = open(ptsname(*master), O_RDWR | O_NOCTTY);
+    if (*slave < 0) {
+        return false;
+    }
+    for (int i = 0; i < 2; i++) {
+        int fd = i ? *slave : *master;
+        tcgetattr(fd, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return true;
+}
+
+/**
+ * Serves the slave ends of all links, echoing messages from a worker. Signals `ready_fd` once the
+ * links are served and runs until killed.
+ */
+static void run_devices(int *slaves, unsigned int count, int ready_fd) {
+    dcl2_epoll_t *rt = dcEpollCreate(&echo, 1, TICK_MS);
+    for (unsigned int i = 0; rt != NULL && i < count; i++) {
+        if (dcEpollAddLink(rt, slaves[i], NULL, NULL) == NULL) {
+            exit(1);
+        }
+    }
+    if (rt == NULL || write(ready_fd, "", 1) != 1) {
+        exit(1);
+    }
+    while (true) {
+        pause();
+    }
+}
+
+static uint64_t cpu_us() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ULL +
+        usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static void sleep_until_us(uint64_t deadline) {
+    struct timespec ts;
+    ts.tv_sec = deadline / 1000000;
+    ts.tv_nsec = (deadline % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {}
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long duration_s = 5;
+    unsigned long period_ms = 100;
+
+    if (argc > 1) duration_s = strtoul(argv[1], NULL, 10);
+    if (argc > 2) period_ms = strtoul(argv[2], NULL, 10);
+
+    if (duration_s == 0 || period_ms == 0) {
+        fprintf(stderr, "Duration and period must be positive\n");
+        return 1;
+    }
+
+    // Every link takes two descriptors before the devices are forked
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    printf("%lu s per measurement, message every %lu ms per link, %u ms tick\n",
+           duration_s, period_ms, TICK_MS);
+    printf("%6s %12s %16s %12s %16s\n",
+           "links", "connect [ms]", "idle CPU/link", "echoes/s", "busy CPU/link");
+
+    uint8_t message[MESSAGE_LEN];
+    for (size_t i = 0; i < MESSAGE_LEN; i++) {
+        message[i] = i;
+    }
+
+    for (size_t n = 0; n < sizeof(link_counts) / sizeof(link_counts[0]); n++) {
+        unsigned int count = link_counts[n];
+        int *masters = calloc(count, sizeof(int));
+        int *slaves = calloc(count, sizeof(int));
+        for (unsigned int i = 0; i < count; i++) {
+            if (!open_pty_pair(&masters[i], &slaves[i])) {
+                fprintf(stderr, "Failed to open pty pair %u, raise the limit of descriptors\n", i);
+                return 1;
+            }
+        }
+
+        int ready[2];
+        if (pipe(ready) != 0) {
+            return 1;
+        }
+        pid_t devices = fork();
+        if (devices == 0) {
+            for (unsigned int i = 0; i < count; i++) {
+                close(masters[i]);
+            }
+            run_devices(slaves, count, ready[1]);
+        }
+        for (unsigned int i = 0; i < count; i++) {
+            close(slaves[i]);
+        }
+        char c;
+        if (devices < 0 || read(ready[0], &c, 1) != 1) {
+            fprintf(stderr, "Failed to start devices\n");
+            return 1;
+        }
+        close(ready[0]);
+        close(ready[1]);
+
+        dcl2_epoll_t *rt = dcEpollCreate(&count_echo, 0, TICK_MS);
+        DeadcomL2 **links = calloc(count, sizeof(DeadcomL2*));
+        uint64_t start = benchNowUs();
+        for (unsigned int i = 0; i < count; i++) {
+            links[i] = dcEpollAddLink(rt, masters[i], NULL, NULL);
+            if (links[i] == NULL || dcConnect(links[i]) != DC_OK) {
+                fprintf(stderr, "Failed to connect link %u\n", i);
+                return 1;
+            }
+        }
+        uint64_t connect_us = benchNowUs() - start;
+
+        start = benchNowUs();
+        uint64_t cpu = cpu_us();
+        sleep_until_us(start + duration_s * 1000000);
+        double idle = (double)(cpu_us() - cpu) / duration_s / count;
+
+        echoed = 0;
+        start = benchNowUs();
+        cpu = cpu_us();
+        for (uint64_t next = start; next < start + duration_s * 1000000; next += period_ms * 1000) {
+            sleep_until_us(next);
+            for (unsigned int i = 0; i < count; i++) {
+                dcSendMessageAsync(links[i], message, MESSAGE_LEN, &ignore_completion, NULL);
+            }
+        }
+        sleep_until_us(start + duration_s * 1000000);
+        double busy = (double)(cpu_us() - cpu) / duration_s / count;
+        double rate = (double)echoed / duration_s;
+
+        dcEpollDestroy(rt);
+        kill(devices, SIGKILL);
+        waitpid(devices, NULL, 0);
+        for (unsigned int i = 0; i < count; i++) {
+            close(masters[i]);
+        }
+        free(links);
+        free(masters);
+        free(slaves);
+
+        // CPU per link is in microseconds of CPU time per second
+        printf("%6u %12.1f %13.1f us %12.1f %13.1f us\n",
+               count, connect_us / 1e3, idle, rate, busy);
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "leaky-pipe.h"
+#include "dcl2.h"
+#include "bench-link.h"
+
+/*
+ * Transfer time of one large message, which is fragmented into DATA frames, depending on the
+ * transmit window size.
+ *
+ * Usage: bench_Fragmentation.out [message_len] [baud] [latency_us] [drop_prob]
+ */
+
+static DeadcomL2 dc, dr;
+static uint8_t *received_msg;
+static size_t message_len = 16384;
+
+static void* receiver_thread(void *p) {
+    (void)p;
+    size_t *received_len = malloc(sizeof(size_t));
+    *received_len = 0;
+    while (dcGetReceivedMsg(&dr, received_msg, received_len) == DC_OK && *received_len == 0) {
+        struct timespec t = {0, 100000};
+        nanosleep(&t, NULL);
+    }
+    return received_len;
+}
+
+int main(int argc, char *argv[]) {
+    bench_link_args_t args;
+    args.baud = 115200;
+    args.latency_us = 2000;
+    lp_init_args(&args.faults);
+
+    if (argc > 1) message_len = strtoul(argv[1], NULL, 10);
+    if (argc > 2) args.baud = strtoul(argv[2], NULL, 10);
+    if (argc > 3) args.latency_us = strtoul(argv[3], NULL, 10);
+    if (argc > 4) args.faults.drop_prob = strtof(argv[4], NULL);
+
+    if (message_len == 0) {
+        fprintf(stderr, "Message length must be positive\n");
+        return 1;
+    }
+
+    printf("%zu B message, %lu Bd, %lu us latency, drop probability %g\n",
+           message_len, args.baud, args.latency_us, args.faults.drop_prob);
+    printf("%6s %10s %12s %10s\n", "window", "time [ms]", "payload B/s", "line rate");
+
+    uint8_t *message = malloc(message_len);
+    received_msg = malloc(message_len);
+    for (size_t i = 0; i < message_len; i++) {
+        message[i] = i;
+    }
+
+    DeadcomL2Config config;
+    dcDefaultConfig(&config);
+    config.reassembly_buffer = received_msg;
+    config.reassembly_buffer_len = message_len;
+
+    for (uint8_t window = 1; window <= DEADCOM_MAX_WINDOW_SIZE; window++) {
+        benchLinkCreate(&args, &dc, &dr, &config);
+        dcSetWindowSize(&dc, window);
+
+        DeadcomL2Result res = DC_FAILURE;
+        for (int attempt = 0; attempt < 3 && res != DC_OK; attempt++) {
+            res = dcConnect(&dc);
+        }
+        if (res != DC_OK) {
+            fprintf(stderr, "Failed to connect\n");
+            return 1;
+        }
+
+        pthread_t receiver;
+        pthread_create(&receiver, NULL, &receiver_thread, NULL);
+
+        uint64_t start = benchNowUs();
+        res = dcSendMessage(&dc, message, message_len);
+        if (res == DC_OK) {
+            res = dcFlush(&dc);
+        }
+
+        size_t *received_len;
+        pthread_join(receiver, (void**)&received_len);
+        uint64_t elapsed = benchNowUs() - start;
+        benchLinkDestroy();
+
+        if (res != DC_OK || *received_len != message_len) {
+            printf("%6u link reset\n", window);
+        } else {
+            double secs = elapsed / 1e6;
+            double rate = message_len / secs;
+            printf("%6u %10.1f %12.0f %9.1f%%\n", window, elapsed / 1e3, rate,
+                   args.baud ? rate * 1000 / args.baud : 0);
+        }
+        free(received_len);
+    }
+
+    free(message);
+    free(received_msg);
+    return 0;
+}
@@ -0,0 +1,127 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "leaky-pipe.h"
+#include "dcl2.h"
+#include "bench-link.h"
+
+/*
+ * Transfer time of one large message, fragmented into frames of the default size with CRC-16 FCS,
+ * or into long frames with CRC-32C FCS. Both stations use the same frames and the same window.
+ *
+ * Usage: bench_Jumbo.out [message_len] [baud] [latency_us] [corrupt_prob]
+ */
+
+static DeadcomL2 dc, dr;
+static uint8_t *received_msg;
+static size_t message_len = 65536;
+
+typedef struct {
+    uint16_t max_payload_len;
+    bool fcs32;
+} frames_t;
+
+static const frames_t frames[] = {
+    {DEADCOM_PAYLOAD_MAX_LEN, false},
+    {1024, true},
+    {DEADCOM_JUMBO_PAYLOAD_MAX_LEN, true},
+};
+
+static void* receiver_thread(void *p) {
+    (void)p;
+    size_t *received_len = malloc(sizeof(size_t));
+    *received_len = 0;
+    while (dcGetReceivedMsg(&dr, received_msg, received_len) == DC_OK && *received_len == 0) {
+        struct timespec t = {0, 100000};
+        nanosleep(&t, NULL);
+    }
+    return received_len;
+}
+
+int main(int argc, char *argv[]) {
+    bench_link_args_t args;
+    args.baud = 115200;
+    args.latency_us = 2000;
+    lp_init_args(&args.faults);
+
+    if (argc > 1) message_len = strtoul(argv[1], NULL, 10);
+    if (argc > 2) args.baud = strtoul(argv[2], NULL, 10);
+    if (argc > 3) args.latency_us = strtoul(argv[3], NULL, 10);
+    if (argc > 4) args.faults.corrupt_prob = strtof(argv[4], NULL);
+
+    if (message_len == 0) {
+        fprintf(stderr, "Message length must be positive\n");
+        return 1;
+    }
+
+    uint8_t window = (DEADCOM_MAX_WINDOW_SIZE < 4) ? DEADCOM_MAX_WINDOW_SIZE : 4;
+    printf("%zu B message, %lu Bd, %lu us latency, corrupt probability %g, window %u\n",
+           message_len, args.baud, args.latency_us, args.faults.corrupt_prob, window);
+    printf("%8s %6s %10s %12s %10s %12s\n", "payload", "FCS", "time [ms]", "payload B/s",
+           "line rate", "sent B/msg B");
+
+    uint8_t *message = malloc(message_len);
+    received_msg = malloc(message_len);
+    for (size_t i = 0; i < message_len; i++) {
+        message[i] = i;
+    }
+
+    for (size_t f = 0; f < sizeof(frames) / sizeof(frames[0]); f++) {
+        DeadcomL2Config c_config, r_config;
+        dcDefaultConfig(&c_config);
+        c_config.max_payload_len = frames[f].max_payload_len;
+        c_config.fcs32 = frames[f].fcs32;
+        r_config = c_config;
+        r_config.reassembly_buffer = received_msg;
+        r_config.reassembly_buffer_len = message_len;
+
+        benchLinkCreateConfig(&args, &dc, &c_config, &dr, &r_config);
+        dcSetWindowSize(&dc, window);
+
+        DeadcomL2Result res = DC_FAILURE;
+        for (int attempt = 0; attempt < 3 && res != DC_OK; attempt++) {
+            res = dcConnect(&dc);
+        }
+        if (res != DC_OK) {
+            fprintf(stderr, "Failed to connect\n");
+            return 1;
+        }
+
+        pthread_t receiver;
+        pthread_create(&receiver, NULL, &receiver_thread, NULL);
+
+        uint64_t start = benchNowUs();
+        res = dcSendMessage(&dc, message, message_len);
+        if (res == DC_OK) {
+            res = dcFlush(&dc);
+        }
+        if (res != DC_OK) {
+            // Receiving station may still consider the link up, wake the receiver thread
+            dcDisconnect(&dr);
+        }
+
+        size_t *received_len;
+        pthread_join(receiver, (void**)&received_len);
+        uint64_t elapsed = benchNowUs() - start;
+        uint64_t bytes = benchLinkBytesSent(&dc);
+        benchLinkDestroy();
+
+        const char *fcs = frames[f].fcs32 ? "32" : "16";
+        if (res != DC_OK || *received_len != message_len) {
+            printf("%8u %6s link reset\n", frames[f].max_payload_len, fcs);
+        } else {
+            double secs = elapsed / 1e6;
+            double rate = message_len / secs;
+            printf("%8u %6s %10.1f %12.0f %9.1f%% %12.3f\n", frames[f].max_payload_len, fcs,
+                   elapsed / 1e3, rate, args.baud ? rate * 1000 / args.baud : 0,
+                   (double)bytes / message_len);
+        }
+        free(received_len);
+    }
+
+    free(message);
+    free(received_msg);
+    return 0;
+}
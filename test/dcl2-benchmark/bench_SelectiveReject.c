@@ -0,0 +1,128 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "leaky-pipe.h"
+#include "dcl2.h"
+#include "bench-link.h"
+
+/*
+ * Go-back-N compared with selective reject over lossy lines. Both stations use extended mode and
+ * the largest window allowed with selective reject.
+ *
+ * Usage: bench_SelectiveReject.out [messages] [payload_len] [baud] [latency_us]
+ */
+
+static DeadcomL2 dc, dr;
+static unsigned int messages = 500;
+
+typedef struct {
+    const char *name;
+    float drop_prob;
+    float corrupt_prob;
+    float add_prob;
+} profile_t;
+
+static const profile_t profiles[] = {
+    {"drop 0.0005",       0.0005, 0,      0},
+    {"drop 0.002",        0.002,  0,      0},
+    {"noisy 0.0002",      0.0002, 0.0002, 0.0002},
+    {"noisy 0.0005",      0.0005, 0.0005, 0.0005},
+};
+
+static void* receiver_thread(void *p) {
+    (void)p;
+    unsigned int *received = malloc(sizeof(unsigned int));
+    *received = benchReceive(&dr, messages);
+    return received;
+}
+
+int main(int argc, char *argv[]) {
+    size_t payload_len = 120;
+    bench_link_args_t args;
+    args.baud = 115200;
+    args.latency_us = 2000;
+
+    if (argc > 1) messages = strtoul(argv[1], NULL, 10);
+    if (argc > 2) payload_len = strtoul(argv[2], NULL, 10);
+    if (argc > 3) args.baud = strtoul(argv[3], NULL, 10);
+    if (argc > 4) args.latency_us = strtoul(argv[4], NULL, 10);
+
+    if (payload_len == 0 || payload_len > DEADCOM_PAYLOAD_MAX_LEN) {
+        fprintf(stderr, "Payload length must be between 1 and %d\n", DEADCOM_PAYLOAD_MAX_LEN);
+        return 1;
+    }
+
+    uint8_t window = (DEADCOM_MAX_WINDOW_SIZE < 64) ? DEADCOM_MAX_WINDOW_SIZE : 64;
+    printf("%u messages, %zu B payload, %lu Bd, %lu us latency, window %u\n",
+           messages, payload_len, args.baud, args.latency_us, window);
+    printf("%-14s %-10s %10s %12s %12s\n", "line", "mode", "time [ms]", "payload B/s",
+           "sent B/msg");
+
+    uint8_t message[DEADCOM_PAYLOAD_MAX_LEN];
+    for (size_t i = 0; i < payload_len; i++) {
+        message[i] = i;
+    }
+
+    for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        for (int selective = 0; selective <= 1; selective++) {
+            lp_init_args(&args.faults);
+            args.faults.drop_prob = profiles[p].drop_prob;
+            args.faults.corrupt_prob = profiles[p].corrupt_prob;
+            args.faults.add_prob = profiles[p].add_prob;
+
+            benchLinkCreate(&args, &dc, &dr, NULL);
+            dcSetExtendedMode(&dc, true);
+            dcSetExtendedMode(&dr, true);
+            dcSetSelectiveReject(&dc, selective);
+            dcSetSelectiveReject(&dr, selective);
+            dcSetWindowSize(&dc, window);
+
+            DeadcomL2Result res = DC_FAILURE;
+            for (int attempt = 0; attempt < 3 && res != DC_OK; attempt++) {
+                res = dcConnect(&dc);
+            }
+            if (res != DC_OK) {
+                fprintf(stderr, "Failed to connect\n");
+                return 1;
+            }
+
+            pthread_t receiver;
+            pthread_create(&receiver, NULL, &receiver_thread, NULL);
+
+            uint64_t start = benchNowUs();
+            unsigned int sent;
+            for (sent = 0; sent < messages; sent++) {
+                if (dcSendMessage(&dc, message, payload_len) != DC_OK) {
+                    break;
+                }
+            }
+            if (sent == messages && dcFlush(&dc) != DC_OK) {
+                sent--;
+            }
+            if (sent != messages) {
+                // Receiving station may still consider the link up, wake the receiver thread
+                dcDisconnect(&dr);
+            }
+
+            unsigned int *received;
+            pthread_join(receiver, (void**)&received);
+            uint64_t elapsed = benchNowUs() - start;
+            uint64_t bytes = benchLinkBytesSent(&dc);
+            benchLinkDestroy();
+
+            const char *mode = selective ? "selective" : "go-back-N";
+            if (sent != messages || *received != messages) {
+                printf("%-14s %-10s link reset after %u messages\n", profiles[p].name, mode,
+                       *received);
+            } else {
+                double secs = elapsed / 1e6;
+                printf("%-14s %-10s %10.1f %12.0f %12.1f\n", profiles[p].name, mode,
+                       elapsed / 1e3, messages * payload_len / secs, (double)bytes / messages);
+            }
+            free(received);
+        }
+    }
+
+    return 0;
+}
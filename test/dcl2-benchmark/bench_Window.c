@@ -0,0 +1,95 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "leaky-pipe.h"
+#include "dcl2.h"
+#include "bench-link.h"
+
+/*
+ * Throughput of DATA frame exchange depending on the transmit window size.
+ *
+ * Usage: bench_Window.out [messages] [payload_len] [baud] [latency_us] [drop_prob]
+ */
+
+static DeadcomL2 dc, dr;
+static unsigned int messages = 500;
+
+static void* receiver_thread(void *p) {
+    (void)p;
+    unsigned int *received = malloc(sizeof(unsigned int));
+    *received = benchReceive(&dr, messages);
+    return received;
+}
+
+int main(int argc, char *argv[]) {
+    size_t payload_len = 120;
+    bench_link_args_t args;
+    args.baud = 115200;
+    args.latency_us = 2000;
+    lp_init_args(&args.faults);
+
+    if (argc > 1) messages = strtoul(argv[1], NULL, 10);
+    if (argc > 2) payload_len = strtoul(argv[2], NULL, 10);
+    if (argc > 3) args.baud = strtoul(argv[3], NULL, 10);
+    if (argc > 4) args.latency_us = strtoul(argv[4], NULL, 10);
+    if (argc > 5) args.faults.drop_prob = strtof(argv[5], NULL);
+
+    if (payload_len == 0 || payload_len > DEADCOM_PAYLOAD_MAX_LEN) {
+        fprintf(stderr, "Payload length must be between 1 and %d\n", DEADCOM_PAYLOAD_MAX_LEN);
+        return 1;
+    }
+
+    printf("%u messages, %zu B payload, %lu Bd, %lu us latency, drop probability %g\n",
+           messages, payload_len, args.baud, args.latency_us, args.faults.drop_prob);
+    printf("%6s %10s %12s %12s\n", "window", "time [ms]", "msgs/s", "payload B/s");
+
+    uint8_t message[DEADCOM_PAYLOAD_MAX_LEN];
+    for (size_t i = 0; i < payload_len; i++) {
+        message[i] = i;
+    }
+
+    for (uint8_t window = 1; window <= DEADCOM_MAX_WINDOW_SIZE; window++) {
+        benchLinkCreate(&args, &dc, &dr, NULL);
+        dcSetWindowSize(&dc, window);
+
+        DeadcomL2Result res = DC_FAILURE;
+        for (int attempt = 0; attempt < 3 && res != DC_OK; attempt++) {
+            res = dcConnect(&dc);
+        }
+        if (res != DC_OK) {
+            fprintf(stderr, "Failed to connect\n");
+            return 1;
+        }
+
+        pthread_t receiver;
+        pthread_create(&receiver, NULL, &receiver_thread, NULL);
+
+        uint64_t start = benchNowUs();
+        unsigned int sent;
+        for (sent = 0; sent < messages; sent++) {
+            if (dcSendMessage(&dc, message, payload_len) != DC_OK) {
+                break;
+            }
+        }
+        if (sent == messages && dcFlush(&dc) != DC_OK) {
+            sent--;
+        }
+
+        unsigned int *received;
+        pthread_join(receiver, (void**)&received);
+        uint64_t elapsed = benchNowUs() - start;
+        benchLinkDestroy();
+
+        if (sent != messages || *received != messages) {
+            printf("%6u link reset after %u messages\n", window, *received);
+        } else {
+            double secs = elapsed / 1e6;
+            printf("%6u %10.1f %12.1f %12.0f\n", window, elapsed / 1e3, messages / secs,
+                   messages * payload_len / secs);
+        }
+        free(received);
+    }
+
+    return 0;
+}
@@ -80,6 +80,7 @@ void waitForThreadsAndAssert(long milliseconds) {
 pthread_t threads[TEST_THREADS];
 leaky_pipe_t *c_tx_pipe;
 leaky_pipe_t *r_tx_pipe;
+volatile unsigned int frames_transmitted;
 
 typedef struct {
     DeadcomL2 *station;
@@ -93,7 +94,29 @@ void* rx_handle_thread(void *p) {
     while (lp_receive(rp->rx_pipe, b, 1)) {
         // Uncomment this if you want to see bytes exchanged between simulated stations
         // printf("Station %c received %02x\n", rp->station_char, b[0]);
-        dcProcessData(rp->station, b, 1);
+        if (rp->station->config.rx_ring != NULL) {
+            // Like an interrupt handler, leave the processing to rx_drain_thread
+            dcRxPush(rp->station, b, 1);
+        } else {
+            dcProcessData(rp->station, b, 1);
+        }
+        pthread_testcancel();
+    }
+    return NULL;
+}
+
+void* rx_drain_thread(void *p) {
+    UNUSED_PARAM(p);
+    while (true) {
+        dcRxDrain(dc);
+        dcRxDrain(dr);
+        // Let the received bytes pile up a bit, so that they are processed in batches
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+        struct timespec t;
+        t.tv_sec = 0;
+        t.tv_nsec = 500000;
+        nanosleep(&t, &t);
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
         pthread_testcancel();
     }
     return NULL;
@@ -101,6 +124,7 @@ void* rx_handle_thread(void *p) {
 
 bool station_c_tx(const uint8_t *bytes, size_t b_l, void *context) {
     UNUSED_PARAM(context);
+    __sync_fetch_and_add(&frames_transmitted, 1);
     for (unsigned int i = 0; i < b_l; i++) {
         lp_transmit(c_tx_pipe, bytes[i]);
     }
@@ -109,19 +133,50 @@ bool station_c_tx(const uint8_t *bytes, size_t b_l, void *context) {
 
 bool station_r_tx(const uint8_t *bytes, size_t b_l, void *context) {
     UNUSED_PARAM(context);
+    __sync_fetch_and_add(&frames_transmitted, 1);
     for (unsigned int i = 0; i < b_l; i++) {
         lp_transmit(r_tx_pipe, bytes[i]);
     }
     return true;
 }
 
+static bool station_c_txv(const yahdlc_iovec_t *iov, size_t iov_count, void *context) {
+    UNUSED_PARAM(context);
+    __sync_fetch_and_add(&frames_transmitted, 1);
+    for (size_t i = 0; i < iov_count; i++) {
+        for (size_t j = 0; j < iov[i].len; j++) {
+            lp_transmit(c_tx_pipe, iov[i].base[j]);
+        }
+    }
+    return true;
+}
+
+static bool station_r_txv(const yahdlc_iovec_t *iov, size_t iov_count, void *context) {
+    UNUSED_PARAM(context);
+    __sync_fetch_and_add(&frames_transmitted, 1);
+    for (size_t i = 0; i < iov_count; i++) {
+        for (size_t j = 0; j < iov[i].len; j++) {
+            lp_transmit(r_tx_pipe, iov[i].base[j]);
+        }
+    }
+    return true;
+}
+
 void createLinksAndReceiveThreads(lp_args_t *c_tx_args, lp_args_t *r_tx_args, DeadcomL2 *station_c,
                                   DeadcomL2 *station_r) {
+    createLinksAndReceiveThreadsConfig(c_tx_args, r_tx_args, station_c, station_r, NULL, NULL);
+}
+
+void createLinksAndReceiveThreadsConfig(lp_args_t *c_tx_args, lp_args_t *r_tx_args,
+                                        DeadcomL2 *station_c, DeadcomL2 *station_r,
+                                        const DeadcomL2Config *config_c,
+                                        const DeadcomL2Config *config_r) {
     lp_init(c_tx_pipe, c_tx_args);
     lp_init(r_tx_pipe, r_tx_args);
+    frames_transmitted = 0;
 
-    TEST_ASSERT_EQUAL(DC_OK, dcPthreadsInit(station_c, &station_c_tx, (void*)1));
-    TEST_ASSERT_EQUAL(DC_OK, dcPthreadsInit(station_r, &station_r_tx, (void*)1));
+    TEST_ASSERT_EQUAL(DC_OK, dcPthreadsInitConfig(station_c, config_c, &station_c_tx, (void*)1));
+    TEST_ASSERT_EQUAL(DC_OK, dcPthreadsInitConfig(station_r, config_r, &station_r_tx, (void*)1));
 
     rx_set_t *c = malloc(sizeof(rx_set_t)), *r = malloc(sizeof(rx_set_t));
     c->station = station_c; c->rx_pipe = r_tx_pipe; c->station_char = 'C';
@@ -221,6 +276,8 @@ static void* sender_1000msg_thread(void *p) {
         THREADED_ASSERT(DC_OK == dcSendMessage(dc, message, sizeof(message)));
         pthread_testcancel();
     }
+    // Wait until the rest of the window is acknowledged
+    THREADED_ASSERT(DC_OK == dcFlush(dc));
     THREAD_EXIT_OK();
 }
 
@@ -256,12 +313,201 @@ static void* receiver_1000msg_thread(void *p) {
     THREAD_EXIT_OK();
 }
 
+static void* waiting_receiver_1000msg_thread(void *p) {
+    UNUSED_PARAM(p);
+    unsigned int r2 = 1;
+    for (unsigned int i = 0; i < 1000; i++) {
+        uint8_t rcvdMessage[120];
+        size_t msgLen = 0;
+        while (msgLen == 0) {
+            // Waiting on a condvar is a cancellation point, but the link would stay locked if the
+            // thread was cancelled there
+            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+            DeadcomL2Result res = dcWaitMessage(dr, rcvdMessage, sizeof(rcvdMessage), &msgLen, 100);
+            if (res == DC_NOT_CONNECTED && i == 0) {
+                // The other station did not connect yet, there is nothing to wait on
+                struct timespec t;
+                t.tv_sec = 0;
+                t.tv_nsec = 2000000;
+                nanosleep(&t, &t);
+            } else {
+                THREADED_ASSERT(DC_OK == res);
+            }
+            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+            pthread_testcancel();
+        }
+        THREADED_ASSERT(120 == msgLen);
+        for (size_t j = 0; j < msgLen; j++) {
+            THREADED_ASSERT((rand_r(&r2) % 256) == rcvdMessage[j]);
+        }
+    }
+    THREAD_EXIT_OK();
+}
+
 void run_1000msg_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx) {
-    createLinksAndReceiveThreads(args_c_tx, args_r_tx, dc, dr);
+    run_1000msg_windowed_test(args_c_tx, args_r_tx, 1, false);
+}
+
+// Holds a whole transmit window of the other station with room to spare, otherwise bytes of every
+// retransmitted window would be discarded as well
+#define RX_RING_LEN  4096
+
+// Options of run_1000msg
+#define RUN_SELECTIVE  0x01
+#define RUN_VECTORED   0x02
+#define RUN_RX_RING    0x04
+#define RUN_TX_QUEUE   0x08
+#define RUN_EARLY_ACK  0x10
+#define RUN_WAIT       0x20
+
+static void run_1000msg(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                        bool extended, unsigned int options) {
+    bool selective = options & RUN_SELECTIVE;
+    if (options & RUN_RX_RING) {
+        // Received bytes are pushed to the ring by the receive threads and processed by another one
+        static uint8_t ring_c[RX_RING_LEN], ring_r[RX_RING_LEN];
+        DeadcomL2Config config_c, config_r;
+        dcDefaultConfig(&config_c);
+        config_c.rx_ring = ring_c;
+        config_c.rx_ring_len = sizeof(ring_c);
+        config_r = config_c;
+        config_r.rx_ring = ring_r;
+        createLinksAndReceiveThreadsConfig(args_c_tx, args_r_tx, dc, dr, &config_c, &config_r);
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[RX_DRAIN], NULL, &rx_drain_thread, NULL));
+    } else {
+        createLinksAndReceiveThreads(args_c_tx, args_r_tx, dc, dr);
+    }
+    if (options & RUN_VECTORED) {
+        TEST_ASSERT_EQUAL(DC_OK, dcSetTransmitVec(dc, &station_c_txv));
+        TEST_ASSERT_EQUAL(DC_OK, dcSetTransmitVec(dr, &station_r_txv));
+    }
+    if (options & RUN_TX_QUEUE) {
+        TEST_ASSERT_EQUAL(DC_OK, dcPthreadsStartTxWorker(dc));
+        TEST_ASSERT_EQUAL(DC_OK, dcPthreadsStartTxWorker(dr));
+    }
+    TEST_ASSERT_EQUAL(DC_OK, dcSetEarlyAck(dr, options & RUN_EARLY_ACK));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(dc, window_size));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetExtendedMode(dc, extended));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetSelectiveReject(dc, selective));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetSelectiveReject(dr, selective));
     declareAssertingThreads(2);
 
     TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_C_TX], NULL, &sender_1000msg_thread, NULL));
-    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_R_TX], NULL, &receiver_1000msg_thread, NULL));
+    void *(*receiver)(void*) = (options & RUN_WAIT) ? &waiting_receiver_1000msg_thread
+                                                     : &receiver_1000msg_thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_R_TX], NULL, receiver, NULL));
+
+    long timeout = DEADCOM_CONN_TIMEOUT_MS * (DEADCOM_MAX_FAILURE_COUNT + 1) * 1000;
+    waitForThreadsAndAssert(timeout);
+    cutLinksAndJoinReceiveThreads();
+
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dc->state);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dr->state);
+    TEST_ASSERT_EQUAL(extended, dc->extended_mode);
+    TEST_ASSERT_EQUAL(extended, dr->extended_mode);
+    if (options & RUN_TX_QUEUE) {
+        // Transmit threads must not outlive the links
+        dcPthreadsFree(dc);
+        dcPthreadsFree(dr);
+    }
+}
+
+void run_1000msg_windowed_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                               bool extended) {
+    run_1000msg(args_c_tx, args_r_tx, window_size, extended, 0);
+}
+
+void run_1000msg_selective_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                                bool extended) {
+    run_1000msg(args_c_tx, args_r_tx, window_size, extended, RUN_SELECTIVE);
+}
+
+void run_1000msg_vectored_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size) {
+    run_1000msg(args_c_tx, args_r_tx, window_size, false, RUN_VECTORED);
+}
+
+void run_1000msg_rx_ring_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size) {
+    run_1000msg(args_c_tx, args_r_tx, window_size, false, RUN_RX_RING);
+}
+
+void run_1000msg_tx_queue_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                               bool selective) {
+    run_1000msg(args_c_tx, args_r_tx, window_size, false,
+                RUN_TX_QUEUE | (selective ? RUN_SELECTIVE : 0));
+}
+
+void run_1000msg_early_ack_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                                bool selective) {
+    run_1000msg(args_c_tx, args_r_tx, window_size, false,
+                RUN_EARLY_ACK | (selective ? RUN_SELECTIVE : 0));
+}
+
+void run_1000msg_wait_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size) {
+    run_1000msg(args_c_tx, args_r_tx, window_size, false, RUN_WAIT);
+}
+
+#define JUMBO_MESSAGES  50
+
+static void* sender_jumbo_thread(void *p) {
+    UNUSED_PARAM(p);
+    unsigned int r1 = 1;
+    unsigned int conn_attempt;
+    // multiple connection attempts, since we are working over lossy link
+    for (conn_attempt = 3; conn_attempt > 0; conn_attempt--) {
+        if (dcConnect(dc) == DC_OK) {
+            break;
+        }
+    }
+    THREADED_ASSERT(DC_OK == dcConnect(dc)); // No-op if connected, just a check. Disaster if not.
+    static uint8_t message[DEADCOM_JUMBO_PAYLOAD_MAX_LEN];
+    for (unsigned int i = 0; i < JUMBO_MESSAGES; i++) {
+        for (unsigned int j = 0; j < sizeof(message); j++) {
+            message[j] = rand_r(&r1) % 256;
+        }
+        THREADED_ASSERT(DC_OK == dcSendMessage(dc, message, sizeof(message)));
+        pthread_testcancel();
+    }
+    THREADED_ASSERT(DC_OK == dcFlush(dc));
+    THREAD_EXIT_OK();
+}
+
+static void* receiver_jumbo_thread(void *p) {
+    UNUSED_PARAM(p);
+    unsigned int r2 = 1;
+    static uint8_t rcvdMessage[DEADCOM_JUMBO_PAYLOAD_MAX_LEN];
+    for (unsigned int i = 0; i < JUMBO_MESSAGES; i++) {
+        size_t msgLen;
+        dcGetReceivedMsg(dr, NULL, &msgLen);
+        while (msgLen == 0) {
+            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+            struct timespec t;
+            t.tv_sec = 0;
+            t.tv_nsec = 2000000;
+            nanosleep(&t, &t);
+            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+            pthread_testcancel();
+            dcGetReceivedMsg(dr, NULL, &msgLen);
+        }
+        THREADED_ASSERT(sizeof(rcvdMessage) == msgLen);
+        THREADED_ASSERT(DC_OK == dcGetReceivedMsg(dr, rcvdMessage, &msgLen));
+        for (size_t j = 0; j < msgLen; j++) {
+            THREADED_ASSERT((rand_r(&r2) % 256) == rcvdMessage[j]);
+        }
+        pthread_testcancel();
+    }
+    THREAD_EXIT_OK();
+}
+
+void run_jumbo_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx) {
+    DeadcomL2Config config;
+    dcDefaultConfig(&config);
+    config.max_payload_len = DEADCOM_JUMBO_PAYLOAD_MAX_LEN;
+    config.fcs32 = true;
+    createLinksAndReceiveThreadsConfig(args_c_tx, args_r_tx, dc, dr, &config, &config);
+    declareAssertingThreads(2);
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_C_TX], NULL, &sender_jumbo_thread, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_R_TX], NULL, &receiver_jumbo_thread, NULL));
 
     long timeout = DEADCOM_CONN_TIMEOUT_MS * (DEADCOM_MAX_FAILURE_COUNT + 1) * 1000;
     waitForThreadsAndAssert(timeout);
@@ -333,5 +579,276 @@ void run_1msg_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx) {
     TEST_ASSERT_EQUAL(DC_CONNECTED, dr->state);
 }
 
+#define REQRESP_EXCHANGES  100
+
+static void poll_sleep() {
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    struct timespec t;
+    t.tv_sec = 0;
+    t.tv_nsec = 2000000;
+    nanosleep(&t, &t);
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+    pthread_testcancel();
+}
+
+static void* requester_thread(void *p) {
+    UNUSED_PARAM(p);
+    unsigned int conn_attempt;
+    for (conn_attempt = 3; conn_attempt > 0; conn_attempt--) {
+        if (dcConnect(dc) == DC_OK) {
+            break;
+        }
+    }
+    THREADED_ASSERT(DC_OK == dcConnect(dc));
+    for (unsigned int i = 0; i < REQRESP_EXCHANGES; i++) {
+        uint8_t request[2] = {i, 0x42};
+        THREADED_ASSERT(DC_OK == dcSendMessage(dc, request, sizeof(request)));
+
+        size_t msgLen;
+        dcGetReceivedMsg(dc, NULL, &msgLen);
+        while (msgLen == 0) {
+            poll_sleep();
+            dcGetReceivedMsg(dc, NULL, &msgLen);
+        }
+        uint8_t response[msgLen];
+        THREADED_ASSERT(DC_OK == dcGetReceivedMsg(dc, response, &msgLen));
+        THREADED_ASSERT(3 == msgLen);
+        THREADED_ASSERT(i == response[0] && 0x43 == response[2]);
+    }
+    // Acknowledgment of the last response has nothing to ride on, poll once more to send it
+    size_t msgLen;
+    THREADED_ASSERT(DC_OK == dcGetReceivedMsg(dc, NULL, &msgLen));
+    THREAD_EXIT_OK();
+}
+
+static void* responder_thread(void *p) {
+    UNUSED_PARAM(p);
+    for (unsigned int i = 0; i < REQRESP_EXCHANGES; i++) {
+        size_t msgLen;
+        dcGetReceivedMsg(dr, NULL, &msgLen);
+        while (msgLen == 0) {
+            poll_sleep();
+            dcGetReceivedMsg(dr, NULL, &msgLen);
+        }
+        uint8_t request[msgLen];
+        THREADED_ASSERT(DC_OK == dcGetReceivedMsg(dr, request, &msgLen));
+        THREADED_ASSERT(2 == msgLen);
+        uint8_t response[3] = {request[0], request[1], request[1] + 1};
+        THREADED_ASSERT(DC_OK == dcSendMessage(dr, response, sizeof(response)));
+    }
+    THREAD_EXIT_OK();
+}
+
+void run_request_response_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, bool delayed_ack) {
+    createLinksAndReceiveThreads(args_c_tx, args_r_tx, dc, dr);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetDelayedAck(dc, delayed_ack));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetDelayedAck(dr, delayed_ack));
+    declareAssertingThreads(2);
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_C_TX], NULL, &requester_thread, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_R_TX], NULL, &responder_thread, NULL));
+
+    long timeout = DEADCOM_CONN_TIMEOUT_MS * (DEADCOM_MAX_FAILURE_COUNT + 1) * 100;
+    waitForThreadsAndAssert(timeout);
+    cutLinksAndJoinReceiveThreads();
+
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dc->state);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dr->state);
+    if (delayed_ack) {
+        // Every acknowledgment but the last one should have ridden on a DATA frame: 2 frames for
+        // link establishment, 2 DATA frames per exchange and the final acknowledgment
+        TEST_ASSERT_EQUAL(2 + 2 * REQRESP_EXCHANGES + 1, frames_transmitted);
+    } else {
+        TEST_ASSERT_EQUAL(2 + 4 * REQRESP_EXCHANGES, frames_transmitted);
+    }
+}
+
+static volatile unsigned int callback_received;
+static volatile bool callback_corrupted;
+static unsigned int callback_seed;
+
+static void on_message_1000msg(const uint8_t *payload, size_t len, void *context) {
+    UNUSED_PARAM(context);
+    if (len != 120) {
+        callback_corrupted = true;
+    }
+    for (size_t j = 0; j < len; j++) {
+        if ((rand_r(&callback_seed) % 256) != payload[j]) {
+            callback_corrupted = true;
+        }
+    }
+    callback_received++;
+}
+
+static void* callback_receiver_1000msg_thread(void *p) {
+    UNUSED_PARAM(p);
+    while (callback_received < 1000) {
+        poll_sleep();
+    }
+    THREADED_ASSERT(!callback_corrupted);
+    THREAD_EXIT_OK();
+}
+
+void run_1000msg_callback_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size) {
+    callback_received = 0;
+    callback_corrupted = false;
+    callback_seed = 1;
+    createLinksAndReceiveThreads(args_c_tx, args_r_tx, dc, dr);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(dc, window_size));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetMessageCallback(dr, &on_message_1000msg, NULL));
+    declareAssertingThreads(2);
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_C_TX], NULL, &sender_1000msg_thread, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_R_TX], NULL,
+                                        &callback_receiver_1000msg_thread, NULL));
+
+    long timeout = DEADCOM_CONN_TIMEOUT_MS * (DEADCOM_MAX_FAILURE_COUNT + 1) * 1000;
+    waitForThreadsAndAssert(timeout);
+    cutLinksAndJoinReceiveThreads();
+
+    TEST_ASSERT_EQUAL(1000, callback_received);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dc->state);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dr->state);
+}
+
 /* End test threads and elements */
 /**************************************************************************************************/
+
+
+/* == Asynchronous transmission ==================================================================*/
+
+static volatile unsigned int async_acknowledged;
+static volatile bool async_failed;
+
+static uint32_t now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void on_async_complete(DeadcomL2Result result, void *context) {
+    UNUSED_PARAM(context);
+    if (result == DC_OK) {
+        async_acknowledged++;
+    } else {
+        async_failed = true;
+    }
+}
+
+static void* async_sender_1000msg_thread(void *p) {
+    UNUSED_PARAM(p);
+    unsigned int r1 = 1;
+    unsigned int conn_attempt;
+    for (conn_attempt = 3; conn_attempt > 0; conn_attempt--) {
+        if (dcConnect(dc) == DC_OK) {
+            break;
+        }
+    }
+    THREADED_ASSERT(DC_OK == dcConnect(dc));
+    THREADED_ASSERT(DC_OK == dcTick(dc, now_ms()));
+    uint8_t message[120];
+    unsigned int sent = 0;
+    bool pending = false;
+    while (async_acknowledged < 1000) {
+        if (sent < 1000 && !pending) {
+            for (unsigned int j = 0; j < sizeof(message); j++) {
+                message[j] = rand_r(&r1) % 256;
+            }
+            pending = true;
+        }
+        if (pending) {
+            DeadcomL2Result res = dcSendMessageAsync(dc, message, sizeof(message),
+                                                     &on_async_complete, NULL);
+            THREADED_ASSERT(res == DC_OK || res == DC_BUSY);
+            if (res == DC_OK) {
+                pending = false;
+                sent++;
+                continue;
+            }
+        }
+        THREADED_ASSERT(DC_OK == dcTick(dc, now_ms()));
+        THREADED_ASSERT(!async_failed);
+        poll_sleep();
+        pthread_testcancel();
+    }
+    THREAD_EXIT_OK();
+}
+
+void run_1000msg_async_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size) {
+    async_acknowledged = 0;
+    async_failed = false;
+    createLinksAndReceiveThreads(args_c_tx, args_r_tx, dc, dr);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(dc, window_size));
+    declareAssertingThreads(2);
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_C_TX], NULL,
+                                        &async_sender_1000msg_thread, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_R_TX], NULL, &receiver_1000msg_thread,
+                                        NULL));
+
+    long timeout = DEADCOM_CONN_TIMEOUT_MS * (DEADCOM_MAX_FAILURE_COUNT + 1) * 1000;
+    waitForThreadsAndAssert(timeout);
+    cutLinksAndJoinReceiveThreads();
+
+    TEST_ASSERT_EQUAL(1000, async_acknowledged);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dc->state);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dr->state);
+}
+
+#define SLOW_CONSUMER_MESSAGES  30
+
+static void* slow_consumer_sender_thread(void *p) {
+    UNUSED_PARAM(p);
+    THREADED_ASSERT(DC_OK == dcConnect(dc));
+    for (unsigned int i = 0; i < SLOW_CONSUMER_MESSAGES; i++) {
+        uint8_t message[120];
+        memset(message, i, sizeof(message));
+        // Link reset would be reported here
+        THREADED_ASSERT(DC_OK == dcSendMessage(dc, message, sizeof(message)));
+    }
+    THREADED_ASSERT(DC_OK == dcFlush(dc));
+    THREAD_EXIT_OK();
+}
+
+static void* slow_consumer_thread(void *p) {
+    UNUSED_PARAM(p);
+    for (unsigned int i = 0; i < SLOW_CONSUMER_MESSAGES; i++) {
+        if (i % 10 == 5) {
+            // Much longer than all retransmission timeouts before the link would be reset
+            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+            sleep(1);
+            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        }
+        size_t msgLen;
+        dcGetReceivedMsg(dr, NULL, &msgLen);
+        while (msgLen == 0) {
+            poll_sleep();
+            dcGetReceivedMsg(dr, NULL, &msgLen);
+        }
+        uint8_t message[msgLen];
+        THREADED_ASSERT(DC_OK == dcGetReceivedMsg(dr, message, &msgLen));
+        THREADED_ASSERT(120 == msgLen);
+        THREADED_ASSERT(i == message[0] && i == message[msgLen - 1]);
+    }
+    THREAD_EXIT_OK();
+}
+
+void run_slow_consumer_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                            bool early_ack) {
+    createLinksAndReceiveThreads(args_c_tx, args_r_tx, dc, dr);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(dc, window_size));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetEarlyAck(dr, early_ack));
+    declareAssertingThreads(2);
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_C_TX], NULL,
+                                        &slow_consumer_sender_thread, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[STATION_R_TX], NULL, &slow_consumer_thread,
+                                        NULL));
+
+    long timeout = DEADCOM_CONN_TIMEOUT_MS * (DEADCOM_MAX_FAILURE_COUNT + 1) * 100;
+    waitForThreadsAndAssert(timeout);
+    cutLinksAndJoinReceiveThreads();
+
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dc->state);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, dr->state);
+}
@@ -1,12 +1,13 @@
 #ifndef __TEST_COMMON_H
 #define __TEST_COMMON_H
 
-#define TEST_THREADS  4
+#define TEST_THREADS  5
 
 #define STATION_C_TX  0
 #define STATION_C_RX  1
 #define STATION_R_TX  2
 #define STATION_R_RX  3
+#define RX_DRAIN      4
 
 
 extern pthread_t threads[TEST_THREADS];
@@ -41,6 +42,10 @@ void pthread_reltimedjoin_assert_notimeout(pthread_t *thread, long milliseconds)
 
 void createLinksAndReceiveThreads(lp_args_t *c_tx_args, lp_args_t *r_tx_args, DeadcomL2 *station_c,
                                   DeadcomL2 *station_r);
+void createLinksAndReceiveThreadsConfig(lp_args_t *c_tx_args, lp_args_t *r_tx_args,
+                                        DeadcomL2 *station_c, DeadcomL2 *station_r,
+                                        const DeadcomL2Config *config_c,
+                                        const DeadcomL2Config *config_r);
 void cutLinksAndJoinReceiveThreads();
 void cutLinks();
 
@@ -48,6 +53,23 @@ void setUp();
 void tearDown();
 
 void run_1000msg_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx);
+void run_1000msg_windowed_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                               bool extended);
+void run_1000msg_selective_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                                bool extended);
+void run_1000msg_vectored_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size);
+void run_1000msg_rx_ring_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size);
+void run_1000msg_tx_queue_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                               bool selective);
+void run_1000msg_early_ack_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                                bool selective);
+void run_1000msg_wait_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size);
+void run_jumbo_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx);
 void run_1msg_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx);
+void run_1000msg_callback_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size);
+void run_request_response_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, bool delayed_ack);
+void run_1000msg_async_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size);
+void run_slow_consumer_test(lp_args_t *args_c_tx, lp_args_t *args_r_tx, uint8_t window_size,
+                            bool early_ack);
 
 #endif
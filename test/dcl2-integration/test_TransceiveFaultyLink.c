@@ -75,3 +75,148 @@ void test_Send1000HugeMessagesOverNoisyCorruptingDroppyRx() {
 
     run_1000msg_test(&args_c_tx, &args_r_tx);
 }
+
+
+void test_Send1000MessagesWindowedOverNoisyCorruptingDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    args_c_tx.drop_prob = 0.0002;
+    args_c_tx.corrupt_prob = 0.0002;
+    args_c_tx.add_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0005;
+    args_r_tx.corrupt_prob = 0.0005;
+    args_r_tx.add_prob = 0.0005;
+
+    run_1000msg_windowed_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE, false);
+}
+
+
+void test_Send1000MessagesVectoredOverDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    args_c_tx.drop_prob = 0.0005;
+    args_r_tx.drop_prob = 0.0005;
+
+    run_1000msg_vectored_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+
+void test_Send1000MessagesWaitingForThemOverDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    // Messages are picked up as soon as they are received, so the sender keeps its whole window in
+    // flight all the time. Drop fewer bytes, like with the receive ring.
+    args_c_tx.drop_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0002;
+
+    run_1000msg_wait_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+
+void test_Send1000MessagesThroughRxRingOverDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    // Received bytes are processed in batches, so rejects arrive after the whole window was sent
+    // and each go-back-N retransmission is a long burst. Drop fewer bytes than the tests which
+    // process every byte right away.
+    args_c_tx.drop_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0002;
+
+    run_1000msg_rx_ring_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+
+void test_Send1000MessagesThroughTxQueueOverDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    args_c_tx.drop_prob = 0.0005;
+    args_r_tx.drop_prob = 0.0005;
+
+    run_1000msg_tx_queue_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE, true);
+}
+
+
+void test_Send1000MessagesWithEarlyAckOverDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    // Nothing but the receive queue holds the sender back, frames in flight when it fills up are
+    // discarded and retransmitted over and over. Drop fewer bytes, like with the receive ring.
+    args_c_tx.drop_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0002;
+
+    run_1000msg_early_ack_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE, false);
+}
+
+
+void test_Send1000MessagesWithEarlyAckSelectiveOverDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    args_c_tx.drop_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0002;
+
+    run_1000msg_early_ack_test(&args_c_tx, &args_r_tx, 4, true);
+}
+
+
+void test_SendJumboMessagesWithCrc32OverCorruptingTx() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    // Single-bit errors inside a few of the long frames, which CRC-32C has to catch
+    lp_corrupt_def_t cl[] = {{10000, 0x01}, {50000, 0x10}, {100000, 0x80}, {150000, 0x04}};
+    args_c_tx.corrupt_list = cl;
+    args_c_tx.corrupt_list_len = sizeof(cl) / sizeof(cl[0]);
+
+    run_jumbo_test(&args_c_tx, &args_r_tx);
+}
+
+
+void test_Send1000MessagesSelectiveRejectOverNoisyCorruptingDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    args_c_tx.drop_prob = 0.0002;
+    args_c_tx.corrupt_prob = 0.0002;
+    args_c_tx.add_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0005;
+    args_r_tx.corrupt_prob = 0.0005;
+    args_r_tx.add_prob = 0.0005;
+
+    run_1000msg_selective_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE, true);
+}
+
+
+void test_Send1000MessagesToCallbackOverNoisyCorruptingDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    args_c_tx.drop_prob = 0.0002;
+    args_c_tx.corrupt_prob = 0.0002;
+    args_c_tx.add_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0005;
+    args_r_tx.corrupt_prob = 0.0005;
+    args_r_tx.add_prob = 0.0005;
+
+    run_1000msg_callback_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+void test_Send1000MessagesAsyncOverNoisyCorruptingDroppyLink() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+    args_c_tx.drop_prob = 0.0002;
+    args_c_tx.corrupt_prob = 0.0002;
+    args_c_tx.add_prob = 0.0002;
+    args_r_tx.drop_prob = 0.0005;
+    args_r_tx.corrupt_prob = 0.0005;
+    args_r_tx.add_prob = 0.0005;
+
+    run_1000msg_async_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE);
+}
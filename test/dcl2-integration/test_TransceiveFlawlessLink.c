@@ -1,9 +1,13 @@
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include "unity.h"
 #include "fff.h"
 #include "leaky-pipe.h"
 
 #include "dcl2.h"
 #include "dcl2-pthreads.h"
+#include "dcl2-epoll.h"
 
 #include "common.h"
 
@@ -22,3 +26,273 @@ void test_Send1000HugeMessagesUnidirectional() {
 
     run_1000msg_test(&args, &args);
 }
+
+
+void test_Send1000HugeMessagesWindowed() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_1000msg_windowed_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE, false);
+}
+
+void test_Send1000HugeMessagesWindowedExtended() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    // 1000 messages wrap the modulo 128 sequence numbers several times
+    run_1000msg_windowed_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE, true);
+}
+
+
+void test_Send1000HugeMessagesVectored() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_1000msg_vectored_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+
+void test_Send1000HugeMessagesThroughRxRing() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_1000msg_rx_ring_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+
+void test_Send1000HugeMessagesThroughTxQueue() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_1000msg_tx_queue_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE, false);
+}
+
+
+void test_SlowConsumerDoesNotResetLink() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    // Receive queue fills up and stays full for a while
+    run_slow_consumer_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE, false);
+}
+
+
+void test_SlowConsumerWithEarlyAckDoesNotResetLink() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_slow_consumer_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE, true);
+}
+
+
+void test_Send1000HugeMessagesWithEarlyAck() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_1000msg_early_ack_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE, false);
+}
+
+
+void test_Send1000HugeMessagesWaitingForThem() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_1000msg_wait_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+
+void test_SendJumboMessagesWithCrc32() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_jumbo_test(&args, &args);
+}
+
+
+void test_WritevFdWritesAllSegments() {
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+
+    // More segments than fit in one writev batch of the helper
+    uint8_t bytes[2 * YAHDLC_IOV_MAX + 1];
+    yahdlc_iovec_t iov[sizeof(bytes)];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = i;
+        iov[i].base = &bytes[i];
+        iov[i].len = 1;
+    }
+    TEST_ASSERT_TRUE(dcPthreadsWritevFd(iov, sizeof(bytes), &fds[1]));
+    TEST_ASSERT_TRUE(dcPthreadsWriteFd(bytes, sizeof(bytes), &fds[1]));
+
+    uint8_t read_bytes[2 * sizeof(bytes)];
+    size_t read_len = 0;
+    while (read_len < sizeof(read_bytes)) {
+        ssize_t r = read(fds[0], read_bytes + read_len, sizeof(read_bytes) - read_len);
+        TEST_ASSERT_TRUE(r > 0);
+        read_len += r;
+    }
+    TEST_ASSERT_EQUAL_MEMORY(bytes, read_bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_MEMORY(bytes, read_bytes + sizeof(bytes), sizeof(bytes));
+
+    // Errors are reported
+    close(fds[0]);
+    TEST_ASSERT_FALSE(dcPthreadsWritevFd(iov, sizeof(bytes), &fds[0]));
+    close(fds[1]);
+}
+
+
+/* Wait for a link registered in `ep` to become readable and clear its event descriptor */
+static DeadcomL2* waitForLinkEvent(int ep) {
+    struct epoll_event event;
+    if (epoll_wait(ep, &event, 1, 1000) != 1) {
+        return NULL;
+    }
+    DeadcomL2 *link = event.data.ptr;
+    TEST_ASSERT_TRUE(dcPthreadsClearEventFd(link));
+    return link;
+}
+
+
+void test_EventFdSignalsLinkEvents() {
+    lp_args_t args;
+    lp_init_args(&args);
+    createLinksAndReceiveThreads(&args, &args, dc, dr);
+
+    int ep = epoll_create1(0);
+    TEST_ASSERT_TRUE(ep >= 0);
+    DeadcomL2 *links[] = {dc, dr};
+    for (unsigned int i = 0; i < 2; i++) {
+        int fd = dcPthreadsEventFd(links[i]);
+        TEST_ASSERT_TRUE(fd >= 0);
+        TEST_ASSERT_EQUAL(fd, dcPthreadsEventFd(links[i]));
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = links[i]};
+        TEST_ASSERT_EQUAL(0, epoll_ctl(ep, EPOLL_CTL_ADD, fd, &event));
+    }
+
+    // Both descriptors are readable right away, and not any more once cleared
+    DeadcomL2 *first = waitForLinkEvent(ep);
+    DeadcomL2 *second = waitForLinkEvent(ep);
+    TEST_ASSERT_TRUE((first == dc && second == dr) || (first == dr && second == dc));
+    struct epoll_event event;
+    TEST_ASSERT_EQUAL(0, epoll_wait(ep, &event, 1, 0));
+
+    // Connection is an event for both stations
+    TEST_ASSERT_EQUAL(DC_OK, dcConnect(dc));
+    first = waitForLinkEvent(ep);
+    second = waitForLinkEvent(ep);
+    TEST_ASSERT_TRUE((first == dc && second == dr) || (first == dr && second == dc));
+
+    // So are the reception of a message and, once it is picked up, its acknowledgment
+    volatile DeadcomL2Result sent = DC_FAILURE;
+    void onComplete(DeadcomL2Result result, void *context) {
+        (void) context;
+        sent = result;
+    }
+    const uint8_t message[] = {0x42, 0x47};
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(dc, message, sizeof(message), &onComplete, NULL));
+    TEST_ASSERT_EQUAL(dr, waitForLinkEvent(ep));
+    uint8_t received[sizeof(message)];
+    size_t received_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(dr, received, &received_len));
+    TEST_ASSERT_EQUAL(sizeof(message), received_len);
+    TEST_ASSERT_EQUAL(dc, waitForLinkEvent(ep));
+    TEST_ASSERT_EQUAL(DC_OK, sent);
+
+    TEST_ASSERT_EQUAL(DC_OK, dcDisconnect(dc));
+    TEST_ASSERT_EQUAL(dc, waitForLinkEvent(ep));
+
+    cutLinksAndJoinReceiveThreads();
+    dcPthreadsFree(dc);
+    dcPthreadsFree(dr);
+    close(ep);
+}
+
+
+void test_EpollRuntimeServesLinks() {
+    volatile unsigned int echoes = 0;
+    volatile size_t echo_len = 0;
+    int fds[2];
+    void onEcho(DeadcomL2 *link, const uint8_t *message, size_t len, void *context) {
+        (void) link; (void) message;
+        echo_len = (context == &fds[0]) ? len : 0;
+        echoes++;
+    }
+    void onComplete(DeadcomL2Result result, void *context) {
+        (void) result; (void) context;
+    }
+    void echo(DeadcomL2 *link, const uint8_t *message, size_t len, void *context) {
+        (void) context;
+        dcSendMessageAsync(link, message, len, &onComplete, NULL);
+    }
+
+    TEST_ASSERT_NULL(dcEpollCreate(NULL, 0, 10));
+    TEST_ASSERT_NULL(dcEpollCreate(&onEcho, 0, 0));
+    TEST_ASSERT_NULL(dcEpollAddLink(NULL, 0, NULL, NULL));
+
+    // Controller delivers messages from the event loop, device echoes them from workers
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    dcl2_epoll_t *controller = dcEpollCreate(&onEcho, 0, 10);
+    dcl2_epoll_t *device = dcEpollCreate(&echo, 2, 10);
+    TEST_ASSERT_NOT_NULL(controller);
+    TEST_ASSERT_NOT_NULL(device);
+    TEST_ASSERT_NULL(dcEpollAddLink(controller, -1, NULL, NULL));
+    DeadcomL2 *c = dcEpollAddLink(controller, fds[0], NULL, &fds[0]);
+    TEST_ASSERT_NOT_NULL(c);
+    TEST_ASSERT_NOT_NULL(dcEpollAddLink(device, fds[1], NULL, NULL));
+    TEST_ASSERT_EQUAL(DC_OK, dcConnect(c));
+
+    uint8_t message[] = {0x00, 0x42, 0x47};
+    for (unsigned int i = 0; i < 100; i++) {
+        message[0] = i;
+        TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(c, message, sizeof(message), &onComplete,
+                                                    NULL));
+        for (unsigned int wait = 0; wait < 1000 && echoes == i; wait++) {
+            usleep(1000);
+        }
+        TEST_ASSERT_EQUAL(i + 1, echoes);
+        TEST_ASSERT_EQUAL(sizeof(message), echo_len);
+    }
+
+    // Controller disconnects the link once the device hangs up
+    dcEpollDestroy(device);
+    close(fds[1]);
+    DeadcomL2Result res = DC_OK;
+    for (unsigned int wait = 0; wait < 1000 && res != DC_NOT_CONNECTED; wait++) {
+        usleep(1000);
+        res = dcSendMessageAsync(c, message, sizeof(message), &onComplete, NULL);
+    }
+    TEST_ASSERT_EQUAL(DC_NOT_CONNECTED, res);
+
+    dcEpollDestroy(controller);
+    close(fds[0]);
+}
+
+
+void test_Send1000HugeMessagesToCallback() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_1000msg_callback_test(&args, &args, DEADCOM_MAX_WINDOW_SIZE);
+}
+
+void test_RequestResponse() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_request_response_test(&args, &args, false);
+}
+
+void test_RequestResponsePiggybackedAcks() {
+    lp_args_t args;
+    lp_init_args(&args);
+
+    run_request_response_test(&args, &args, true);
+}
+
+void test_Send1000MessagesAsync() {
+    lp_args_t args_c_tx, args_r_tx;
+    lp_init_args(&args_c_tx);
+    lp_init_args(&args_r_tx);
+
+    run_1000msg_async_test(&args_c_tx, &args_r_tx, DEADCOM_MAX_WINDOW_SIZE);
+}
@@ -1,28 +1,39 @@
 DEFINE_FFF_GLOBALS;
 
+typedef bool (*transmitVec_t)(const yahdlc_iovec_t*, size_t, void*);
+
 FAKE_VALUE_FUNC(bool, transmitBytes, const uint8_t*, size_t, void*);
+FAKE_VALUE_FUNC(bool, transmitVec, const yahdlc_iovec_t*, size_t, void*);
 FAKE_VALUE_FUNC(bool, mutexInit, void*);
 FAKE_VALUE_FUNC(bool, mutexLock, void*);
 FAKE_VALUE_FUNC(bool, mutexUnlock, void*);
 FAKE_VALUE_FUNC(bool, condvarInit,  void*);
 FAKE_VALUE_FUNC(bool, condvarWait, void*, uint32_t, bool*);
 FAKE_VALUE_FUNC(bool, condvarSignal, void*);
+FAKE_VALUE_FUNC(uint32_t, getTimeMs);
 FAKE_VOID_FUNC(yahdlc_reset_state, yahdlc_state_t*, size_t);
 FAKE_VALUE_FUNC(int, yahdlc_frame_data, yahdlc_control_t*, const uint8_t*, size_t, uint8_t*,
                 size_t*);
+FAKE_VALUE_FUNC(int, yahdlc_frame_lookup, const yahdlc_control_t*, const uint8_t**, size_t*);
+FAKE_VALUE_FUNC(int, yahdlc_frame_data_vec, yahdlc_control_t*, const uint8_t*, size_t,
+                transmitVec_t, void*);
 FAKE_VALUE_FUNC(int, yahdlc_get_data, yahdlc_state_t*, yahdlc_control_t*, const uint8_t*, size_t,
                 uint8_t*, size_t*);
 
 #define FFF_FAKES_LIST(FAKE)        \
     FAKE(transmitBytes)             \
+    FAKE(transmitVec)               \
     FAKE(mutexInit)                 \
     FAKE(mutexLock)                 \
     FAKE(mutexUnlock)               \
     FAKE(condvarInit)               \
     FAKE(condvarWait)               \
     FAKE(condvarSignal)             \
+    FAKE(getTimeMs)                 \
     FAKE(yahdlc_reset_state)        \
     FAKE(yahdlc_frame_data)         \
+    FAKE(yahdlc_frame_data_vec)     \
+    FAKE(yahdlc_frame_lookup)       \
     FAKE(yahdlc_get_data)
 
 
@@ -32,9 +43,32 @@ DeadcomL2ThreadingMethods t = {
     &mutexUnlock,
     &condvarInit,
     &condvarWait,
-    &condvarSignal
+    &condvarSignal,
+    NULL
+};
+
+// Same as above, with a clock to measure round-trip time
+DeadcomL2ThreadingMethods t_clock = {
+    &mutexInit,
+    &mutexLock,
+    &mutexUnlock,
+    &condvarInit,
+    &condvarWait,
+    &condvarSignal,
+    &getTimeMs
 };
 
+// Default configuration with static storage for the link under test
+uint8_t config_storage[DEADCOM_DEFAULT_STORAGE_SIZE];
+DeadcomL2Config config;
+
+DeadcomL2Config* defaultConfig() {
+    dcDefaultConfig(&config);
+    config.storage = config_storage;
+    config.storage_len = sizeof(config_storage);
+    return &config;
+}
+
 /* A fake framing implementation that produces inspectable frames in the following format:
  *
  * +-----------------------------+-------------+--------------------------------------------+
@@ -71,3 +105,20 @@ int frame_data_fake_impl(yahdlc_control_t *control, const uint8_t *data, size_t
 
     return 0;
 }
+
+/* Segmented variant of the fake framing implementation above. It passes the same frame to
+ * `transmit` as three segments: the control structure, message length and the message itself,
+ * which points directly to `data`.
+ */
+int frame_data_vec_fake_impl(yahdlc_control_t *control, const uint8_t *data, size_t data_len,
+                             transmitVec_t transmit, void *context) {
+    uint8_t len_bytes[4] = {
+        (data_len >> 24) & 0xFF, (data_len >> 16) & 0xFF, (data_len >> 8) & 0xFF, data_len & 0xFF
+    };
+    yahdlc_iovec_t iov[3] = {
+        {(const uint8_t*)control, sizeof(yahdlc_control_t)},
+        {len_bytes, sizeof(len_bytes)},
+        {data, data_len}
+    };
+    return transmit(iov, (data_len != 0) ? 3 : 1, context) ? 0 : -EIO;
+}
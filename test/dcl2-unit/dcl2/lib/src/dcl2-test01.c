@@ -21,13 +21,15 @@ void setUp(void) {
     condvarInit_fake.return_val =  true;
     condvarWait_fake.return_val =  true;
     condvarSignal_fake.return_val =  true;
+    // Frame all control frames with the inspectable fake framing implementation
+    yahdlc_frame_lookup_fake.return_val = -ENOENT;
 }
 
 /* == Library initialization =====================================================================*/
 
 void test_ValidInit() {
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, (void*)3);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, (void*)3, defaultConfig());
 
     TEST_ASSERT_EQUAL(DC_OK, res);
     TEST_ASSERT_EQUAL(DC_DISCONNECTED, d.state);
@@ -44,11 +46,125 @@ void test_ValidInit() {
 
 
 void test_InvalidInit() {
-    DeadcomL2Result res = dcInit(NULL, NULL, NULL, NULL, NULL, NULL);
+    DeadcomL2Result res = dcInit(NULL, NULL, NULL, NULL, NULL, NULL, NULL);
     TEST_ASSERT_EQUAL(DC_FAILURE, res);
 }
 
 
+void test_InitInvalidConfig() {
+    DeadcomL2 d;
+    DeadcomL2Config c;
+
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, NULL));
+
+    // No storage, or not enough of it
+    dcDefaultConfig(&c);
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+    c.storage = config_storage;
+    c.storage_len = DEADCOM_DEFAULT_STORAGE_SIZE - 1;
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+    c.storage_len = DEADCOM_DEFAULT_STORAGE_SIZE;
+    TEST_ASSERT_EQUAL(DC_OK, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+
+    // Invalid parameters
+    DeadcomL2Config invalid[7];
+    for (unsigned int i = 0; i < 7; i++) {
+        invalid[i] = c;
+    }
+    invalid[0].max_payload_len = 0;
+    invalid[1].window_slots = 0;
+    invalid[2].window_slots = 128;
+    invalid[3].rx_queue_slots = 0;
+    invalid[4].max_failure_count = 0;
+    invalid[5].rto_min_ms = 100;
+    invalid[5].rto_max_ms = 99;
+    invalid[6].conn_timeout_ms = 0;
+    for (unsigned int i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL(DC_FAILURE, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL,
+                                             &invalid[i]));
+    }
+}
+
+
+void test_InitCustomConfig() {
+    DeadcomL2 d;
+    DeadcomL2Config c;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    uint8_t storage[DEADCOM_STORAGE_SIZE(16, 1, 1) + 1];
+    dcDefaultConfig(&c);
+    c.max_payload_len = 16;
+    c.window_slots = 1;
+    c.rx_queue_slots = 1;
+    c.max_failure_count = 1;
+    c.conn_timeout_ms = 1000;
+    // Storage does not have to be aligned
+    c.storage = storage + 1;
+    c.storage_len = DEADCOM_STORAGE_SIZE(16, 1, 1);
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c);
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(16 + 2 + 1, yahdlc_reset_state_fake.arg1_val);
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetWindowSize(&d, 2));
+
+    // Configured connection timeout is used
+    condvarWait_fake.return_val = true;
+    dcConnect(&d);
+    TEST_ASSERT_EQUAL(1000, condvarWait_fake.arg1_val);
+
+    // Messages longer than configured maximum can't be sent in one frame
+    d.state = DC_CONNECTED;
+    uint8_t message[17] = {0};
+    void onComplete(DeadcomL2Result result, void *context) {
+        UNUSED_PARAM(result);
+        UNUSED_PARAM(context);
+    }
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSendMessageAsync(&d, message, 17, &onComplete, NULL));
+
+    // A single timeout resets the link
+    bool condvarWait_fakeimpl(void* condvar, uint32_t timeout, bool *timed_out) {
+        UNUSED_PARAM(condvar);
+        UNUSED_PARAM(timeout);
+        *timed_out = true;
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
+    TEST_ASSERT_EQUAL(DC_LINK_RESET, dcSendMessage(&d, message, 16));
+    TEST_ASSERT_EQUAL(2, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_DISCONNECTED, d.state);
+}
+
+
+void test_InitCrc32Config() {
+    DeadcomL2 d;
+    DeadcomL2Config c;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    uint8_t storage[DEADCOM_STORAGE_SIZE(16, 1, 1)];
+    dcDefaultConfig(&c);
+    TEST_ASSERT_FALSE(c.fcs32);
+    c.max_payload_len = 16;
+    c.window_slots = 1;
+    c.rx_queue_slots = 1;
+    c.fcs32 = true;
+    c.storage = storage;
+    c.storage_len = sizeof(storage);
+
+    TEST_ASSERT_EQUAL(DC_OK, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+    // Decoder expects CRC-32C and has room for its 4 bytes
+    TEST_ASSERT_EQUAL(16 + 4 + 1, yahdlc_reset_state_fake.arg1_val);
+    TEST_ASSERT_EQUAL(1, d.yahdlc_state.fcs32);
+
+    // Transmitted frames use CRC-32C
+    condvarWait_fake.return_val = true;
+    dcConnect(&d);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    yahdlc_control_t *control = (yahdlc_control_t*)transmitBytes_fake.arg0_val;
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_CONN, control->frame);
+    TEST_ASSERT_EQUAL(1, control->fcs32);
+}
+
+
 /* == Connection establishment ===================================================================*/
 
 void test_InvalidConnectionParams() {
@@ -88,7 +204,7 @@ void test_ValidConnection() {
     transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, (void*)3);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, (void*)3, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // The condvarWait should return `true`, thereby simulating reception of connection ack
@@ -118,7 +234,7 @@ void test_ConnectionNoResponse() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     bool condvarWait_fake_impl(void *condvar_p, uint32_t millis, bool *timed_out) {
@@ -150,7 +266,7 @@ void test_ConnectionNoOpWhenConnected() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // The condvarWait should return `true`, thereby simulating reception of connection ack
@@ -176,7 +292,7 @@ void test_ConnectionFailWhenAlreadyConnecting() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Simulate DC_CONNECTING state
@@ -201,7 +317,7 @@ void test_disconnectWhenDisconnected() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Attempt to disconnect already disconnected link
@@ -221,7 +337,7 @@ void test_disconnectWhenConnecting() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Simulate connecting link
@@ -244,7 +360,7 @@ void test_disconnectWhenConnected() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Simulate connected link
@@ -272,7 +388,7 @@ void test_SendMessageInvalidParams() {
     const uint8_t message[] = {0x42, 0x47};
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     res = dcSendMessage(NULL, message, sizeof(message));
@@ -311,7 +427,7 @@ void test_SendMessageInvalidState() {
     const uint8_t message[] = {0x42, 0x47};
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Disconnected state
@@ -387,13 +503,14 @@ void test_SendMessageWithAcknowledgment() {
 
                 // The other station acknowledged
                 d.last_response = DC_RESP_OK;
+                d.next_expected_ack = d.send_number;
                 *timed_out = false;
                 return true;
             }
             condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
 
             // Initialize the lib
-            DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+            DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
             TEST_ASSERT_EQUAL(DC_OK, res);
 
             // Simulate connected state
@@ -457,6 +574,7 @@ void test_SendMessageWhenNacked() {
 
             if (nacked_times == nack_number) {
                 d.last_response = DC_RESP_OK;
+                d.next_expected_ack = d.send_number;
             } else {
                 d.last_response = DC_RESP_REJECT;
                 nacked_times++;
@@ -467,7 +585,7 @@ void test_SendMessageWhenNacked() {
         condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
 
         // Initialize the lib
-        DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+        DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
         TEST_ASSERT_EQUAL(DC_OK, res);
 
         // Simulate connected state
@@ -487,6 +605,55 @@ void test_SendMessageWhenNacked() {
 }
 
 
+void test_SendMessageScatterGather() {
+    DeadcomL2 d;
+    yahdlc_frame_data_vec_fake.custom_fake = &frame_data_vec_fake_impl;
+
+    const uint8_t message[] = {0x42, 0x7E, 0x47};
+
+    bool transmitVec_fakeimpl(const yahdlc_iovec_t *iov, size_t iov_count, void *context) {
+        TEST_ASSERT_EQUAL(3, context);
+        TEST_ASSERT_EQUAL(3, iov_count);
+        // DATA frame with the message pointing directly into the transmit window, not copied
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA, ((yahdlc_control_t*)iov[0].base)->frame);
+        TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)iov[0].base)->send_seq_no);
+        TEST_ASSERT_EQUAL_PTR(d.txWindow, iov[2].base);
+        TEST_ASSERT_EQUAL(sizeof(message), iov[2].len);
+        TEST_ASSERT_EQUAL_MEMORY(message, iov[2].base, sizeof(message));
+        return true;
+    }
+    transmitVec_fake.custom_fake = &transmitVec_fakeimpl;
+
+    bool condvarWait_fakeimpl(void* condvar, unsigned int timeout, bool *timed_out) {
+        UNUSED_PARAM(condvar);
+        UNUSED_PARAM(timeout);
+        // Reject the first transmission, the retransmission is passed by segments as well
+        if (condvarWait_fake.call_count == 1) {
+            d.last_response = DC_RESP_REJECT;
+        } else {
+            d.last_response = DC_RESP_OK;
+            d.next_expected_ack = d.send_number;
+        }
+        *timed_out = false;
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, (void*)3, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetTransmitVec(&d, &transmitVec));
+    d.state = DC_CONNECTED;
+
+    res = dcSendMessage(&d, message, sizeof(message));
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(2, transmitVec_fake.call_count);
+    TEST_ASSERT_EQUAL(2, yahdlc_frame_data_vec_fake.call_count);
+    // Frames were never assembled in memory
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(0, yahdlc_frame_data_fake.call_count);
+}
+
+
 void test_SendMessageWhenTimeout() {
     DeadcomL2 d;
 
@@ -527,6 +694,7 @@ void test_SendMessageWhenTimeout() {
 
             if (timeout_times == timeout_number) {
                 d.last_response = DC_RESP_OK;
+                d.next_expected_ack = d.send_number;
                 *timed_out = false;
                 return true;
             } else {
@@ -538,7 +706,7 @@ void test_SendMessageWhenTimeout() {
         condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
 
         // Initialize the lib
-        DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+        DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
         TEST_ASSERT_EQUAL(DC_OK, res);
 
         // Simulate connected state
@@ -593,7 +761,7 @@ void test_SendMessageFailTooManyNacks() {
     condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Simulate connected state
@@ -647,7 +815,7 @@ void test_SendMessageFailTooManyTimeouts() {
     condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Simulate connected state
@@ -692,7 +860,7 @@ void test_SendMessageOtherStationDropsLink() {
     condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     // Simulate connected state
@@ -710,13 +878,209 @@ void test_SendMessageOtherStationDropsLink() {
 }
 
 
+/* == Windowed transmission =======================================================================*/
+
+void test_SetWindowSizeInvalidParams() {
+    DeadcomL2 d;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetWindowSize(NULL, 1));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetWindowSize(&d, 0));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetWindowSize(&d, DEADCOM_MAX_WINDOW_SIZE + 1));
+    TEST_ASSERT_EQUAL(1, d.window_size);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, DEADCOM_MAX_WINDOW_SIZE));
+    TEST_ASSERT_EQUAL(DEADCOM_MAX_WINDOW_SIZE, d.window_size);
+}
+
+
+void test_SendMessageWindowed() {
+    DeadcomL2 d;
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    const uint8_t message[] = {0x42, 0x47};
+
+    bool condvarWait_fakeimpl(void* condvar, unsigned int timeout, bool *timed_out) {
+        UNUSED_PARAM(condvar);
+        UNUSED_PARAM(timeout);
+        TEST_ASSERT_EQUAL(DC_TRANSMITTING, d.state);
+        // The other station acknowledges the oldest frame
+        d.next_expected_ack = (d.next_expected_ack + 1) % 8;
+        d.txWindowStart = (d.txWindowStart + 1) % DEADCOM_MAX_WINDOW_SIZE;
+        d.last_response = DC_RESP_OK;
+        *timed_out = false;
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 3));
+
+    // Simulate connected state
+    d.state = DC_CONNECTED;
+
+    // First three messages should be transmitted right away
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+        TEST_ASSERT_EQUAL(i+1, transmitBytes_fake.call_count);
+        TEST_ASSERT_EQUAL(i, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->send_seq_no);
+        TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+    }
+    TEST_ASSERT_EQUAL(0, condvarWait_fake.call_count);
+
+    // The window is full, the fourth message has to wait for an acknowledgment
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(1, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+    TEST_ASSERT_EQUAL(4, d.send_number);
+    TEST_ASSERT_EQUAL(1, d.next_expected_ack);
+
+    // Flush waits for all frames to be acknowledged
+    TEST_ASSERT_EQUAL(DC_OK, dcFlush(&d));
+    TEST_ASSERT_EQUAL(4, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(4, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_SendMessageFragmented() {
+    DeadcomL2 d;
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    // Two full fragments and the rest
+    uint8_t message[2*DEADCOM_PAYLOAD_MAX_LEN + 10];
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = i;
+    }
+
+    bool transmitBytes_fakeimpl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        unsigned int fragment = transmitBytes_fake.call_count - 1;
+        yahdlc_control_t *control = (yahdlc_control_t*)data;
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA, control->frame);
+        TEST_ASSERT_EQUAL(fragment, control->send_seq_no);
+        TEST_ASSERT_EQUAL(fragment < 2, control->more);
+        const uint8_t *p = data + sizeof(yahdlc_control_t);
+        size_t data_len = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+        TEST_ASSERT_EQUAL(fragment < 2 ? DEADCOM_PAYLOAD_MAX_LEN : 10, data_len);
+        TEST_ASSERT_EQUAL_MEMORY(message + fragment*DEADCOM_PAYLOAD_MAX_LEN, p + 4, data_len);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fakeimpl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 3));
+    d.state = DC_CONNECTED;
+
+    // All fragments fit into the window, they are pipelined without waiting
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(3, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(0, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(3, d.send_number);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_FlushRetransmitsWholeWindowOnTimeout() {
+    DeadcomL2 d;
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    const uint8_t message1[] = {0x42, 0x47};
+    const uint8_t message2[] = {0x47, 0x42, 0x42};
+
+    unsigned int waits = 0;
+    bool condvarWait_fakeimpl(void* condvar, unsigned int timeout, bool *timed_out) {
+        UNUSED_PARAM(condvar);
+        UNUSED_PARAM(timeout);
+        if (waits++ == 0) {
+            *timed_out = true;
+        } else {
+            // Both frames should have been retransmitted, in order
+            TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+            TEST_ASSERT_EQUAL(1, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->send_seq_no);
+            TEST_ASSERT_EQUAL(3, transmitBytes_fake.arg1_val - sizeof(yahdlc_control_t) - 4);
+            d.next_expected_ack = d.send_number;
+            d.last_response = DC_RESP_OK;
+            *timed_out = false;
+        }
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 3));
+
+    // Simulate connected state
+    d.state = DC_CONNECTED;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message1, sizeof(message1)));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message2, sizeof(message2)));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+
+    TEST_ASSERT_EQUAL(DC_OK, dcFlush(&d));
+    TEST_ASSERT_EQUAL(2, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+}
+
+
+void test_FlushWhenNotConnected() {
+    DeadcomL2 d;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcFlush(NULL));
+    TEST_ASSERT_EQUAL(DC_NOT_CONNECTED, dcFlush(&d));
+    TEST_ASSERT_EQUAL(0, condvarWait_fake.call_count);
+}
+
+
+
+void test_SelectiveRejectLimitsWindow() {
+    DeadcomL2 d;
+    const uint8_t message[] = {0x42, 0x47};
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    void onComplete(DeadcomL2Result result, void *context) {
+        UNUSED_PARAM(result);
+        UNUSED_PARAM(context);
+    }
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetSelectiveReject(NULL, true));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetSelectiveReject(&d, true));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 7));
+    d.state = DC_CONNECTED;
+
+    // Only half of the modulo 8 sequence number space may be awaiting acknowledgment
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &onComplete, NULL));
+    }
+    TEST_ASSERT_EQUAL(DC_BUSY, dcSendMessageAsync(&d, message, 2, &onComplete, NULL));
+    TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
 /* == Getting previously received message ========================================================*/
 
 void test_GetMessageDisconnectedLink() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     size_t msg_len;
@@ -732,7 +1096,7 @@ void test_GetMessageNoMessagePending() {
     DeadcomL2 d = {};
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
     d.state = DC_CONNECTED;
 
@@ -750,7 +1114,7 @@ void test_GetMessageInvalidParams() {
     DeadcomL2 d;
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     uint8_t buffer[47];
@@ -773,7 +1137,7 @@ void test_GetMessage() {
         yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
 
         // Initialize the lib
-        DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+        DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
         TEST_ASSERT_EQUAL(DC_OK, res);
         d.state = DC_CONNECTED;
 
@@ -788,10 +1152,10 @@ void test_GetMessage() {
         transmitBytes_fake.custom_fake = &transmit_bytes_fake_impl;
 
         // Simulate that we've received a message
-        d.extractionBufferSize = 2;
-        d.extractionComplete = true;
+        d.rxQueueLen[0] = 2;
+        d.rxQueueCount = 1;
         uint8_t orig_message[] = {0x42, 0x47};
-        memcpy(d.extractionBuffer, orig_message, 2);
+        memcpy(d.rxQueue, orig_message, 2);
         d.recv_number = (recv+1)%8;
 
         size_t received_msg_size;
@@ -802,7 +1166,7 @@ void test_GetMessage() {
         TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, received_msg, &received_msg_size));
 
         TEST_ASSERT_EQUAL(2, received_msg_size);
-        TEST_ASSERT_EQUAL_MEMORY(d.extractionBuffer, orig_message, 2);
+        TEST_ASSERT_EQUAL_MEMORY(received_msg, orig_message, 2);
 
         // Mutex should have been locked and unlocked twice
         TEST_ASSERT_EQUAL(2, mutexLock_fake.call_count);
@@ -812,3 +1176,615 @@ void test_GetMessage() {
         TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
     }
 }
+
+
+void test_GetMessageDelayedAck() {
+    DeadcomL2 d = {};
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetDelayedAck(&d, true));
+    d.state = DC_CONNECTED;
+
+    bool transmit_bytes_fake_impl(const uint8_t *data, size_t data_len, void *context) {
+        UNUSED_PARAM(data_len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(4, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmit_bytes_fake_impl;
+
+    // Simulate that we've received a message
+    d.rxQueueLen[0] = 2;
+    d.rxQueueCount = 1;
+    d.recv_number = 5;
+
+    // Picking the message up does not transmit the acknowledgment right away
+    uint8_t received_msg[DEADCOM_PAYLOAD_MAX_LEN];
+    size_t received_msg_size;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, received_msg, &received_msg_size));
+    TEST_ASSERT_EQUAL(2, received_msg_size);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    TEST_ASSERT_TRUE(d.ackPending);
+
+    // Nothing was transmitted in the meantime, so the next poll sends the acknowledgment
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &received_msg_size));
+    TEST_ASSERT_EQUAL(0, received_msg_size);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_FALSE(d.ackPending);
+
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &received_msg_size));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+}
+
+
+void test_SendMessagePiggybacksPendingAck() {
+    DeadcomL2 d;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 2));
+    d.state = DC_CONNECTED;
+
+    bool transmit_bytes_fake_impl(const uint8_t *data, size_t data_len, void *context) {
+        UNUSED_PARAM(data_len);
+        UNUSED_PARAM(context);
+        // The acknowledgment rides on the DATA frame, no separate ACK frame is sent
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(3, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmit_bytes_fake_impl;
+
+    // Frame 2 was picked up, but its acknowledgment is held back
+    d.recv_number = 3;
+    d.ackPending = true;
+
+    const uint8_t message[] = {0x42, 0x47};
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_FALSE(d.ackPending);
+
+    // Message which was not picked up yet is not acknowledged
+    d.recv_number = 4;
+    d.rxQueueLen[0] = 2;
+    d.rxQueueCount = 1;
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+}
+
+
+/* == Waiting for a message ======================================================================*/
+
+void test_WaitMessageInvalidParams() {
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    d.state = DC_CONNECTED;
+
+    uint8_t buffer[47];
+    size_t msg_len;
+
+    // The receive condvar must differ from the one passed to dcInit
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetReceiveCondvar(NULL, (void*)3));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetReceiveCondvar(&d, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetReceiveCondvar(&d, (void*)2));
+
+    // Nothing to wait on yet
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcWaitMessage(&d, buffer, sizeof(buffer), &msg_len, 10));
+
+    TEST_ASSERT_EQUAL(DC_OK, dcSetReceiveCondvar(&d, (void*)3));
+    TEST_ASSERT_EQUAL(2, condvarInit_fake.call_count);
+    TEST_ASSERT_EQUAL(3, condvarInit_fake.arg0_val);
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcWaitMessage(NULL, buffer, sizeof(buffer), &msg_len, 10));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcWaitMessage(&d, NULL, sizeof(buffer), &msg_len, 10));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcWaitMessage(&d, buffer, sizeof(buffer), NULL, 10));
+    TEST_ASSERT_EQUAL(0, condvarWait_fake.call_count);
+}
+
+
+void test_WaitMessagePendingMessage() {
+    DeadcomL2 d;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetReceiveCondvar(&d, (void*)3));
+    d.state = DC_CONNECTED;
+
+    // Simulate that we've received a message
+    uint8_t orig_message[] = {0x42, 0x47};
+    d.rxQueueLen[0] = 2;
+    d.rxQueueCount = 1;
+    memcpy(d.rxQueue, orig_message, 2);
+    d.recv_number = 1;
+
+    // The message does not fit, it stays pending
+    uint8_t buffer[2];
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcWaitMessage(&d, buffer, 1, &msg_len, 10));
+    TEST_ASSERT_EQUAL(2, msg_len);
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+
+    // Pending message is picked up (and acknowledged) without waiting
+    TEST_ASSERT_EQUAL(DC_OK, dcWaitMessage(&d, buffer, sizeof(buffer), &msg_len, 10));
+    TEST_ASSERT_EQUAL(2, msg_len);
+    TEST_ASSERT_EQUAL_MEMORY(orig_message, buffer, 2);
+    TEST_ASSERT_EQUAL(0, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(0, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_WaitMessageWokenUpByMessage() {
+    DeadcomL2 d;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t_clock, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetReceiveCondvar(&d, (void*)3));
+    d.state = DC_CONNECTED;
+
+    uint32_t now = 1000;
+    uint32_t getTimeMs_fake_impl(void) {
+        return now;
+    }
+    getTimeMs_fake.custom_fake = &getTimeMs_fake_impl;
+
+    // First wake-up is spurious, the message arrives while waiting the second time
+    bool condvarWait_fake_impl(void *condvar_p, uint32_t milliseconds, bool *timed_out) {
+        TEST_ASSERT_EQUAL(3, condvar_p);
+        *timed_out = false;
+        if (condvarWait_fake.call_count == 1) {
+            TEST_ASSERT_EQUAL(100, milliseconds);
+            now += 30;
+        } else {
+            TEST_ASSERT_EQUAL(70, milliseconds);
+            d.rxQueue[0] = 0x42;
+            d.rxQueueLen[0] = 1;
+            d.rxQueueCount = 1;
+            d.recv_number = 1;
+        }
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fake_impl;
+
+    uint8_t buffer[8];
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcWaitMessage(&d, buffer, sizeof(buffer), &msg_len, 100));
+    TEST_ASSERT_EQUAL(2, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(1, msg_len);
+    TEST_ASSERT_EQUAL(0x42, buffer[0]);
+    TEST_ASSERT_EQUAL(0, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+}
+
+
+void test_WaitMessageTimeout() {
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetReceiveCondvar(&d, (void*)3));
+    d.state = DC_CONNECTED;
+
+    bool condvarWait_fake_impl(void *condvar_p, uint32_t milliseconds, bool *timed_out) {
+        UNUSED_PARAM(condvar_p);
+        UNUSED_PARAM(milliseconds);
+        *timed_out = true;
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fake_impl;
+
+    uint8_t buffer[8];
+    size_t msg_len = 47;
+    TEST_ASSERT_EQUAL(DC_OK, dcWaitMessage(&d, buffer, sizeof(buffer), &msg_len, 100));
+    TEST_ASSERT_EQUAL(1, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(0, msg_len);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+
+    // Zero timeout just checks for a pending message
+    TEST_ASSERT_EQUAL(DC_OK, dcWaitMessage(&d, buffer, sizeof(buffer), &msg_len, 0));
+    TEST_ASSERT_EQUAL(1, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(0, msg_len);
+}
+
+
+void test_WaitMessageLinkReset() {
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetReceiveCondvar(&d, (void*)3));
+    d.state = DC_CONNECTED;
+
+    // The other station drops the link while we wait
+    bool condvarWait_fake_impl(void *condvar_p, uint32_t milliseconds, bool *timed_out) {
+        UNUSED_PARAM(condvar_p);
+        UNUSED_PARAM(milliseconds);
+        *timed_out = false;
+        TEST_ASSERT_EQUAL(DC_OK, dcDisconnect(&d));
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fake_impl;
+
+    uint8_t buffer[8];
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_NOT_CONNECTED, dcWaitMessage(&d, buffer, sizeof(buffer), &msg_len, 100));
+    TEST_ASSERT_EQUAL(1, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(0, msg_len);
+    // The reset signals the receive condvar
+    TEST_ASSERT_EQUAL(1, condvarSignal_fake.call_count);
+    TEST_ASSERT_EQUAL(3, condvarSignal_fake.arg0_val);
+
+    // Link is not connected, so there is nothing to wait for
+    TEST_ASSERT_EQUAL(DC_NOT_CONNECTED, dcWaitMessage(&d, buffer, sizeof(buffer), &msg_len, 100));
+    TEST_ASSERT_EQUAL(1, condvarWait_fake.call_count);
+}
+
+
+/* == Asynchronous transmission ==================================================================*/
+
+unsigned int async_completed;
+DeadcomL2Result async_results[8];
+void* async_contexts[8];
+
+void async_complete(DeadcomL2Result result, void *context) {
+    async_results[async_completed] = result;
+    async_contexts[async_completed] = context;
+    async_completed++;
+}
+
+
+void test_SendMessageAsyncInvalidParams() {
+    DeadcomL2 d;
+    const uint8_t message[] = {0x42, 0x47};
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSendMessageAsync(NULL, message, 2, &async_complete, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSendMessageAsync(&d, NULL, 2, &async_complete, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSendMessageAsync(&d, message, 0, &async_complete, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSendMessageAsync(&d, message, DEADCOM_PAYLOAD_MAX_LEN+1,
+                                                     &async_complete, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSendMessageAsync(&d, message, 2, NULL, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcTick(NULL, 0));
+
+    TEST_ASSERT_EQUAL(DC_NOT_CONNECTED, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_SendMessageAsyncCompletesOnAck() {
+    DeadcomL2 d;
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    async_completed = 0;
+
+    uint8_t ack_seq;
+    int get_data_fake_ack_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = YAHDLC_FRAME_ACK;
+        control->recv_seq_no = ack_seq;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 2));
+    d.state = DC_CONNECTED;
+
+    // Two messages fit into the window, the third one does not
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, (void*)1));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, (void*)2));
+    TEST_ASSERT_EQUAL(DC_BUSY, dcSendMessageAsync(&d, message, 2, &async_complete, (void*)3));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(0, condvarWait_fake.call_count);
+    TEST_ASSERT_EQUAL(0, async_completed);
+
+    // Acknowledgment of the first message completes it
+    ack_seq = 0;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, async_completed);
+    TEST_ASSERT_EQUAL(DC_OK, async_results[0]);
+    TEST_ASSERT_EQUAL_PTR((void*)1, async_contexts[0]);
+
+    // Now there is room for the third one
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, (void*)3));
+    TEST_ASSERT_EQUAL(3, transmitBytes_fake.call_count);
+
+    // Cumulative acknowledgment completes both of them, in order
+    ack_seq = 2;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(3, async_completed);
+    TEST_ASSERT_EQUAL(DC_OK, async_results[1]);
+    TEST_ASSERT_EQUAL_PTR((void*)2, async_contexts[1]);
+    TEST_ASSERT_EQUAL(DC_OK, async_results[2]);
+    TEST_ASSERT_EQUAL_PTR((void*)3, async_contexts[2]);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_TickRetransmitsAndResetsLink() {
+    DeadcomL2 d;
+    const uint8_t message[] = {0x42, 0x47};
+    async_completed = 0;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    bool transmit_bytes_fake_impl(const uint8_t *data, size_t data_len, void *context) {
+        UNUSED_PARAM(data_len);
+        UNUSED_PARAM(context);
+        // Only the single data frame is ever (re)transmitted
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)data)->send_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmit_bytes_fake_impl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    d.state = DC_CONNECTED;
+
+    uint32_t now = 0xFFFFFFF0;  // Time wraps around during the test
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, now));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+
+    // No retransmission before the acknowledgment timeout, the timeout doubles after each one
+    uint32_t rto = DEADCOM_ACK_TIMEOUT_MS;
+    for (unsigned int i = 1; i < DEADCOM_MAX_FAILURE_COUNT; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, now + rto - 1));
+        TEST_ASSERT_EQUAL(i, transmitBytes_fake.call_count);
+        now += rto;
+        TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, now));
+        TEST_ASSERT_EQUAL(i + 1, transmitBytes_fake.call_count);
+        TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+        TEST_ASSERT_EQUAL(0, async_completed);
+        rto *= 2;
+    }
+
+    // The other station is unresponsive, the link is reset
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, now + rto));
+    TEST_ASSERT_EQUAL(DEADCOM_MAX_FAILURE_COUNT, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_DISCONNECTED, d.state);
+    TEST_ASSERT_EQUAL(1, async_completed);
+    TEST_ASSERT_EQUAL(DC_LINK_RESET, async_results[0]);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_TickTransmitsPendingAck() {
+    DeadcomL2 d;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    bool transmit_bytes_fake_impl(const uint8_t *data, size_t data_len, void *context) {
+        UNUSED_PARAM(data_len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(2, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmit_bytes_fake_impl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    d.state = DC_CONNECTED;
+    d.recv_number = 3;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, 0));
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+
+    d.ackPending = true;
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_FALSE(d.ackPending);
+}
+
+
+void test_DisconnectCompletesAsyncMessages() {
+    DeadcomL2 d;
+    const uint8_t message[] = {0x42, 0x47};
+    async_completed = 0;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 2));
+    d.state = DC_CONNECTED;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, (void*)1));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, (void*)2));
+    TEST_ASSERT_EQUAL(DC_OK, dcDisconnect(&d));
+    TEST_ASSERT_EQUAL(DC_DISCONNECTED, d.state);
+    TEST_ASSERT_EQUAL(2, async_completed);
+    TEST_ASSERT_EQUAL(DC_LINK_RESET, async_results[0]);
+    TEST_ASSERT_EQUAL(DC_LINK_RESET, async_results[1]);
+    TEST_ASSERT_EQUAL_PTR((void*)1, async_contexts[0]);
+    TEST_ASSERT_EQUAL_PTR((void*)2, async_contexts[1]);
+}
+
+
+/* == Round-trip time estimation =================================================================*/
+
+void test_RttEstimateInvalidParams() {
+    DeadcomL2 d;
+    uint32_t srtt, rttvar, rto;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t_clock, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcGetRttEstimate(NULL, &srtt, &rttvar, &rto));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetRetransmitTimeoutBounds(NULL, 10, 20));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetRetransmitTimeoutBounds(&d, 0, 20));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetRetransmitTimeoutBounds(&d, 30, 20));
+
+    // Nothing was measured yet
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, &srtt, &rttvar, &rto));
+    TEST_ASSERT_EQUAL(0, srtt);
+    TEST_ASSERT_EQUAL(0, rttvar);
+    TEST_ASSERT_EQUAL(DEADCOM_ACK_TIMEOUT_MS, rto);
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, NULL, NULL, NULL));
+
+    // Initial timeout is subject to the bounds as well
+    TEST_ASSERT_EQUAL(DC_OK, dcSetRetransmitTimeoutBounds(&d, 10, 20));
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, NULL, NULL, &rto));
+    TEST_ASSERT_EQUAL(20, rto);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_RttMeasuredFromSendToAck() {
+    DeadcomL2 d;
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    uint32_t srtt, rttvar, rto;
+
+    uint8_t ack_seq;
+    int get_data_fake_ack_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = YAHDLC_FRAME_ACK;
+        control->recv_seq_no = ack_seq;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t_clock, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 2));
+    d.state = DC_CONNECTED;
+
+    // Frame 0 is timed, frame 1 is not since frame 0 is still being timed
+    getTimeMs_fake.return_val = 1000;
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+    getTimeMs_fake.return_val = 1010;
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+
+    // First measurement: RTT 40, variance RTT/2, timeout RTT + 4*variance
+    getTimeMs_fake.return_val = 1040;
+    ack_seq = 1;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, &srtt, &rttvar, &rto));
+    TEST_ASSERT_EQUAL(40, srtt);
+    TEST_ASSERT_EQUAL(20, rttvar);
+    TEST_ASSERT_EQUAL(120, rto);
+
+    // Same RTT again, variance decreases by a quarter
+    getTimeMs_fake.return_val = 2000;
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+    getTimeMs_fake.return_val = 2040;
+    ack_seq = 2;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, &srtt, &rttvar, &rto));
+    TEST_ASSERT_EQUAL(40, srtt);
+    TEST_ASSERT_EQUAL(15, rttvar);
+    TEST_ASSERT_EQUAL(100, rto);
+
+    // The timeout is kept within bounds
+    TEST_ASSERT_EQUAL(DC_OK, dcSetRetransmitTimeoutBounds(&d, 10, 80));
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, NULL, NULL, &rto));
+    TEST_ASSERT_EQUAL(80, rto);
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+    getTimeMs_fake.return_val = 2048;
+    ack_seq = 3;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, &srtt, NULL, &rto));
+    TEST_ASSERT_EQUAL(36, srtt);
+    TEST_ASSERT_EQUAL(80, rto);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_RttNotMeasuredForRetransmittedFrames() {
+    DeadcomL2 d;
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    uint32_t srtt, rto;
+
+    uint8_t ack_seq;
+    int get_data_fake_ack_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = YAHDLC_FRAME_ACK;
+        control->recv_seq_no = ack_seq;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    // No getTimeMs, time passed to dcTick is the clock
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    d.state = DC_CONNECTED;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, 0));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+
+    // Timeout, the frame is retransmitted and the timeout backs off
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, DEADCOM_ACK_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, NULL, NULL, &rto));
+    TEST_ASSERT_EQUAL(2*DEADCOM_ACK_TIMEOUT_MS, rto);
+
+    // Acknowledgment of the retransmitted frame is ambiguous, nothing is measured
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, DEADCOM_ACK_TIMEOUT_MS + 5));
+    ack_seq = 0;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, &srtt, NULL, &rto));
+    TEST_ASSERT_EQUAL(0, srtt);
+    TEST_ASSERT_EQUAL(2*DEADCOM_ACK_TIMEOUT_MS, rto);
+
+    // A frame transmitted just once is measured, which ends the back-off
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, 2, &async_complete, NULL));
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, DEADCOM_ACK_TIMEOUT_MS + 25));
+    ack_seq = 1;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, &srtt, NULL, &rto));
+    TEST_ASSERT_EQUAL(20, srtt);
+    TEST_ASSERT_EQUAL(60, rto);
+}
+
+
+void test_SendMessageBacksOffRetransmitTimeout() {
+    DeadcomL2 d;
+    const uint8_t message[] = {0x42, 0x47};
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    uint32_t expected_timeout = DEADCOM_ACK_TIMEOUT_MS;
+    bool condvarWait_fakeimpl(void* condvar, uint32_t timeout, bool *timed_out) {
+        UNUSED_PARAM(condvar);
+        TEST_ASSERT_EQUAL(expected_timeout, timeout);
+        expected_timeout *= 2;
+        *timed_out = true;
+        return true;
+    }
+    condvarWait_fake.custom_fake = &condvarWait_fakeimpl;
+
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t_clock, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    d.state = DC_CONNECTED;
+
+    TEST_ASSERT_EQUAL(DC_LINK_RESET, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(DEADCOM_MAX_FAILURE_COUNT, condvarWait_fake.call_count);
+
+    // The back-off is forgotten with the link
+    uint32_t rto;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetRttEstimate(&d, NULL, NULL, &rto));
+    TEST_ASSERT_EQUAL(DEADCOM_ACK_TIMEOUT_MS, rto);
+}
@@ -41,6 +41,7 @@ int get_data_fake_nack_frame(yahdlc_state_t *state, yahdlc_control_t *control, c
     UNUSED_PARAM(src);
     UNUSED_PARAM(dest);
     control->frame = YAHDLC_FRAME_NACK;
+    control->recv_seq_no = 7;
     *dest_len = 0;
     return src_len;
 }
@@ -77,6 +78,8 @@ void setUp(void) {
     condvarInit_fake.return_val =  true;
     condvarWait_fake.return_val =  true;
     condvarSignal_fake.return_val =  true;
+    // Frame all control frames with the inspectable fake framing implementation
+    yahdlc_frame_lookup_fake.return_val = -ENOENT;
 }
 
 /* == Generic processData tests ==================================================================*/
@@ -88,7 +91,7 @@ void test_PDInvalidParams() {
     uint8_t data[47] = {0};
 
     // Initialize the lib
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     TEST_ASSERT_EQUAL(DC_FAILURE, dcProcessData(NULL, data, 47));
@@ -113,7 +116,7 @@ void test_PDFailsOnYahdlcFailure() {
     }
     yahdlc_get_data_fake.custom_fake = &get_data_fake;
 
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     TEST_ASSERT_EQUAL(DC_FAILURE, dcProcessData(&d, data, sizeof(data)));
@@ -141,7 +144,7 @@ void test_PDProcessesWholeBuffer() {
     }
     yahdlc_get_data_fake.custom_fake = &get_data_fake;
 
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, data, sizeof(data)));
@@ -155,7 +158,7 @@ void test_PDProcessesWholeBuffer() {
 void test_PDProcessDataWhenDisconnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
@@ -172,7 +175,7 @@ void test_PDProcessDataWhenDisconnected() {
 void test_PDProcessAckWhenDisconnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
@@ -189,7 +192,7 @@ void test_PDProcessAckWhenDisconnected() {
 void test_PDProcessNackWhenDisconnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_nack_frame;
@@ -206,7 +209,7 @@ void test_PDProcessNackWhenDisconnected() {
 void test_PDProcessConnWhenDisconnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
@@ -229,10 +232,39 @@ void test_PDProcessConnWhenDisconnected() {
 }
 
 
+void test_PDConnAckTransmittedFromLookupTable() {
+    uint8_t dummy[] = {0};
+    static const uint8_t encoded_frame[] = {0x7E, 0x42, 0x7E};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    int frame_lookup_fake_impl(const yahdlc_control_t *control, const uint8_t **frame,
+                               size_t *frame_len) {
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_CONN_ACK, control->frame);
+        *frame = encoded_frame;
+        *frame_len = sizeof(encoded_frame);
+        return 0;
+    }
+    yahdlc_frame_lookup_fake.custom_fake = &frame_lookup_fake_impl;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    // The frame is transmitted straight from the table, without framing it
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL_PTR(encoded_frame, transmitBytes_fake.arg0_val);
+    TEST_ASSERT_EQUAL(sizeof(encoded_frame), transmitBytes_fake.arg1_val);
+    TEST_ASSERT_EQUAL(0, yahdlc_frame_data_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+}
+
+
 void test_PDProcessConnAckWhenDisconnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_connack_frame;
@@ -251,7 +283,7 @@ void test_PDProcessConnAckWhenDisconnected() {
 void test_PDProcessDataWhenConnecting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
@@ -273,7 +305,7 @@ void test_PDProcessDataWhenConnecting() {
 void test_PDProcessAckWhenConnecting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
@@ -295,7 +327,7 @@ void test_PDProcessAckWhenConnecting() {
 void test_PDProcessNackWhenConnecting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_nack_frame;
@@ -317,7 +349,7 @@ void test_PDProcessNackWhenConnecting() {
 void test_PDProcessConnWhenConnecting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
@@ -348,7 +380,7 @@ void test_PDProcessConnWhenConnecting() {
 void test_PDProcessConnAckWhenConnecting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_connack_frame;
@@ -371,7 +403,7 @@ void test_PDProcessConnAckWhenConnecting() {
 void test_PDProcessAckWhenConnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
@@ -393,7 +425,7 @@ void test_PDProcessAckWhenConnected() {
 void test_PDProcessNackWhenConnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_nack_frame;
@@ -415,7 +447,7 @@ void test_PDProcessNackWhenConnected() {
 void test_PDProcessConnWhenConnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
@@ -447,7 +479,7 @@ void test_PDProcessConnWhenConnected() {
 void test_PDProcessConnAckWhenConnected() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_connack_frame;
@@ -468,13 +500,15 @@ void test_PDProcessConnAckWhenConnected() {
 void test_PDProcessAckWhenTransmitting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
     yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
 
     d.state = DC_TRANSMITTING;
+    // One frame awaiting acknowledgment
+    d.send_number = 1;
 
     TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
     TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
@@ -489,7 +523,7 @@ void test_PDProcessAckWhenTransmitting() {
 void test_PDProcessNackWhenTransmitting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_nack_frame;
@@ -510,7 +544,7 @@ void test_PDProcessNackWhenTransmitting() {
 void test_PDProcessConnWhenTransmitting() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
@@ -543,7 +577,7 @@ void test_PDProcessConnWhenTransmitting() {
 void test_PDProcessConnAckWhenTransmitting(){
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_connack_frame;
@@ -565,7 +599,7 @@ void test_PDProcessConnAckWhenTransmitting(){
 void test_PDDataCorrectSeq() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
@@ -602,7 +636,7 @@ void test_PDDataCorrectSeq() {
 void test_PDDataAlreadySeenNotAcked() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
@@ -619,16 +653,20 @@ void test_PDDataAlreadySeenNotAcked() {
     }
 
     yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
 
     d.state = DC_CONNECTED;
     d.recv_number = 1;
-    d.extractionComplete = true;
-    d.extractionBufferSize = 6;
+    d.rxQueueCount = 1;
+    d.rxQueueLen[0] = 6;
 
     TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
-    // We've received a retransmission of a frame we've already seen and not yet acked
-    // We should've ignored this frame
-    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    // We've received a retransmission of a frame we've already seen and not yet acked. The frame
+    // is ignored, the other station is told that we are not ready (nothing picked up yet).
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_RNR, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(7, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+    TEST_ASSERT_TRUE(d.rxNotReady);
     TEST_ASSERT_EQUAL(1, mutexLock_fake.call_count);
     TEST_ASSERT_EQUAL(1, mutexUnlock_fake.call_count);
     // A message should still be waiting for us
@@ -642,7 +680,7 @@ void test_PDDataAlreadySeenNotAcked() {
 void test_PDDataAlreadySeenAndAcked() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
@@ -672,8 +710,7 @@ void test_PDDataAlreadySeenAndAcked() {
 
     d.state = DC_CONNECTED;
     d.recv_number = 1;
-    d.extractionComplete = false;
-    d.extractionBufferSize = 0;
+    d.rxQueueCount = 0;
 
     TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
     // We've received a retransmission of a frame we've already acked. That ack must've gotten lost.
@@ -694,7 +731,7 @@ void test_PDDataReceiveWithoutAck() {
     uint8_t data1[] = {0, 1, 2, 3, 4, 5};
     uint8_t data2[] = {5, 6, 7};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
@@ -742,23 +779,47 @@ void test_PDDataReceiveWithoutAck() {
     yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame2;
 
     TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
-    // We are ignoring this frame
+    // This frame is queued, still no response
     TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
     TEST_ASSERT_EQUAL(1, mutexLock_fake.call_count);
     TEST_ASSERT_EQUAL(1, mutexUnlock_fake.call_count);
-    // The original message should still be waiting for us
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+    TEST_ASSERT_EQUAL(2, d.recv_number);
+
+    // The original message should be picked up first
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    uint8_t expected_ack = 0;
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(expected_ack, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
     TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &msg_len));
     TEST_ASSERT_EQUAL(6, msg_len);
-    TEST_ASSERT_EQUAL_MEMORY(data1, d.extractionBuffer, sizeof(data1));
-    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
-    TEST_ASSERT_EQUAL(1, d.recv_number);
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(6, msg_len);
+    TEST_ASSERT_EQUAL_MEMORY(data1, buffer, sizeof(data1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+
+    expected_ack = 1;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(3, msg_len);
+    TEST_ASSERT_EQUAL_MEMORY(data2, buffer, sizeof(data2));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &msg_len));
+    TEST_ASSERT_EQUAL(0, msg_len);
 }
 
 
 void test_PDDataIncorrectSeq() {
     uint8_t dummy[] = {0};
     DeadcomL2 d;
-    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
     TEST_ASSERT_EQUAL(DC_OK, res);
 
     int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
@@ -777,19 +838,1639 @@ void test_PDDataIncorrectSeq() {
     yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
     yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
 
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        // We should have rejected frames after the last one received in sequence
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_NACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
     d.state = DC_CONNECTED;
     d.recv_number = 1;
-    d.extractionComplete = false;
-    d.extractionBufferSize = 0;
+    d.rxQueueCount = 0;
 
     TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
-    // We've received an out-of-sequence frame, ignore it.
-    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    // We've received an out-of-sequence frame, ignore it and reject it.
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
     TEST_ASSERT_EQUAL(1, mutexLock_fake.call_count);
     TEST_ASSERT_EQUAL(1, mutexUnlock_fake.call_count);
+
+    // Only one reject may be outstanding
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
     // No message should've appeared in the buffer
     size_t msg_len;
     TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &msg_len));
     TEST_ASSERT_EQUAL(0, msg_len);
     TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
 }
+
+
+void test_PDDataRejectedAgainWhenGoneBack() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    uint8_t seq;
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_NACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    d.state = DC_CONNECTED;
+    d.recv_number = 1;
+
+    // Frame 1 got lost, frames after it are rejected only once
+    for (seq = 2; seq < 5; seq++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    }
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+
+    // The other station went back, but frame 1 got lost again. Reject it once more.
+    for (seq = 2; seq < 5; seq++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    }
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_TRUE(d.rxRejected);
+    TEST_ASSERT_EQUAL(1, d.recv_number);
+}
+
+
+void test_PDCorruptedFrameRejected() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    // Negative sequence number means the frame is corrupted
+    int seq;
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        if (seq < 0) {
+            *dest_len = src_len;
+            return -EIO;
+        }
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    yahdlc_frame_t expected_frame = YAHDLC_FRAME_NACK;
+    uint8_t expected_nr = 0;
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(expected_frame, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(expected_nr, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    d.state = DC_CONNECTED;
+    d.recv_number = 1;
+
+    // Frame 1 is corrupted, reject it right away. Noise corrupting more frames does not lead to
+    // more rejects.
+    seq = -1;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_TRUE(d.rxRejected);
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+
+    // Frames which were already on the way arrive out of sequence, they are not rejected again
+    for (seq = 2; seq < 5; seq++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    }
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+
+    // The other station went back
+    seq = 1;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_FALSE(d.rxRejected);
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+
+    // Frame 2 is corrupted while a message is queued, it is rejected once the message is picked up
+    seq = -1;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    expected_nr = 1;
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(1, msg_len);
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_PDCorruptedFrameIgnoredWhenDisconnected() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_corrupted(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(control);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        *dest_len = src_len;
+        return -EIO;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_corrupted;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    d.state = DC_CONNECTING;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+}
+
+
+/* == Windowed transmission ======================================================================*/
+
+void test_PDProcessCumulativeAck() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_ack2_frame(yahdlc_state_t *state, yahdlc_control_t *control,
+                                 const uint8_t *src, size_t src_len, uint8_t* dest,
+                                 size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = YAHDLC_FRAME_ACK;
+        control->recv_seq_no = 1;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_ack2_frame;
+
+    // Frames 7, 0 and 1 are awaiting acknowledgment
+    d.state = DC_CONNECTED;
+    d.next_expected_ack = 7;
+    d.send_number = 2;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    // All three frames have been acknowledged
+    TEST_ASSERT_EQUAL(2, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    // Nobody is waiting, condvar should not have been signaled
+    TEST_ASSERT_EQUAL(0, condvarSignal_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+
+    // Acknowledgment of an already acknowledged frame should be ignored
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, d.next_expected_ack);
+}
+
+
+void test_PDProcessNackWhenConnectedRetransmits() {
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 3));
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+
+    setUp();
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_nack_frame;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    // Nothing was acknowledged, both frames should have been retransmitted immediately
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(1, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->send_seq_no);
+    TEST_ASSERT_EQUAL(0, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(0, condvarSignal_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+}
+
+
+void test_PDDataDiscardedFrameIsRejected() {
+    uint8_t dummy[] = {0};
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    uint8_t seq = 0;
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq++;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    d.state = DC_CONNECTED;
+    // Sequence numbers must not wrap around while the queue is filled
+    d.extended_mode = true;
+
+    // Frames are queued until the receive queue is full, the next one has to be discarded and the
+    // other station is told that we are not ready
+    for (unsigned int i = 0; i <= DEADCOM_RX_QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    }
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_RNR, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(127, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+    TEST_ASSERT_EQUAL(DEADCOM_RX_QUEUE_SIZE, d.recv_number);
+    TEST_ASSERT_EQUAL(DEADCOM_RX_QUEUE_SIZE, d.rxQueueCount);
+    TEST_ASSERT_TRUE(d.rxDiscarded);
+
+    setUp();
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    uint8_t picked_up = 0;
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        // Picking up the last queued message should reject the discarded frame, the others are
+        // just acknowledged
+        if (picked_up == DEADCOM_RX_QUEUE_SIZE - 1) {
+            TEST_ASSERT_EQUAL(YAHDLC_FRAME_NACK, ((yahdlc_control_t*)data)->frame);
+        } else {
+            TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        }
+        TEST_ASSERT_EQUAL(picked_up, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    size_t msg_len;
+    for (picked_up = 0; picked_up < DEADCOM_RX_QUEUE_SIZE; picked_up++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+        TEST_ASSERT_EQUAL(1, msg_len);
+        TEST_ASSERT_EQUAL(picked_up + 1, transmitBytes_fake.call_count);
+    }
+    TEST_ASSERT_FALSE(d.rxDiscarded);
+    TEST_ASSERT_TRUE(d.rxRejected);
+}
+
+
+/* == Extended (modulo 128) mode =================================================================*/
+
+int get_data_fake_conn_ext_frame(yahdlc_state_t *state, yahdlc_control_t *control,
+                                 const uint8_t *src, size_t src_len, uint8_t* dest,
+                                 size_t *dest_len) {
+    UNUSED_PARAM(state);
+    UNUSED_PARAM(src);
+    UNUSED_PARAM(dest);
+    control->frame = YAHDLC_FRAME_CONN;
+    control->extended = 1;
+    *dest_len = 0;
+    return src_len;
+}
+
+
+void test_PDProcessExtendedConnWhenDisconnected() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_ext_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+    // The connecting station has chosen extended mode, we should follow
+    TEST_ASSERT_TRUE(d.extended_mode);
+    TEST_ASSERT_EQUAL(1, d.yahdlc_state.extended);
+
+    // Basic connection request switches the link back to basic mode
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_FALSE(d.extended_mode);
+    TEST_ASSERT_EQUAL(0, d.yahdlc_state.extended);
+}
+
+
+void test_PDProcessConnAckSetsRequestedMode() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetExtendedMode(&d, true));
+
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_connack_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    d.state = DC_CONNECTING;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_RESP_OK, d.last_response);
+    TEST_ASSERT_TRUE(d.extended_mode);
+    TEST_ASSERT_EQUAL(1, d.yahdlc_state.extended);
+}
+
+
+void test_PDProcessCumulativeAckExtended() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_ack_frame;
+
+    // Frames 126, 127, 0 and 1 are awaiting acknowledgment
+    d.state = DC_CONNECTED;
+    d.extended_mode = true;
+    d.next_expected_ack = 126;
+    d.send_number = 2;
+
+    // Acknowledgment of frame 0 acknowledges frames 126 and 127 as well
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+}
+
+
+void test_PDDataExtendedSeq() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 127;
+        control->recv_seq_no = 0;
+        control->extended = 1;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(127, ((yahdlc_control_t*)data)->recv_seq_no);
+        TEST_ASSERT_EQUAL(1, ((yahdlc_control_t*)data)->extended);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    d.state = DC_CONNECTED;
+    d.extended_mode = true;
+    d.recv_number = 127;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    // Receive counter wraps around modulo 128
+    TEST_ASSERT_EQUAL(0, d.recv_number);
+
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(1, msg_len);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+}
+
+
+/* == Piggybacked acknowledgments ================================================================*/
+
+void test_PDDataPiggybackedAck() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 0;
+        control->recv_seq_no = 2;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+
+    // Frames 0, 1 and 2 are awaiting acknowledgment
+    d.state = DC_TRANSMITTING;
+    d.next_expected_ack = 0;
+    d.send_number = 3;
+    d.last_response = DC_RESP_NOLINK;
+
+    // Response from the other station acknowledges frames 0 and 1
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(DC_RESP_OK, d.last_response);
+    TEST_ASSERT_EQUAL(1, condvarSignal_fake.call_count);
+
+    // and the message itself is received
+    TEST_ASSERT_EQUAL(1, d.recv_number);
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+}
+
+
+void test_PDDataPiggybackedAckNothingNew() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 0;
+        control->recv_seq_no = 5;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+
+    // Frame 5 is awaiting acknowledgment, N(R) = 5 does not acknowledge it
+    d.state = DC_TRANSMITTING;
+    d.next_expected_ack = 5;
+    d.send_number = 6;
+    d.last_response = DC_RESP_NOLINK;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(5, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(DC_RESP_NOLINK, d.last_response);
+    TEST_ASSERT_EQUAL(0, condvarSignal_fake.call_count);
+    TEST_ASSERT_EQUAL(1, d.recv_number);
+}
+
+
+/* == Receive queue ==============================================================================*/
+
+void test_PDDataAlreadyAckedWhileMessageQueued() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 1;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(1, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    // Frame 1 was picked up and acknowledged, frame 2 is waiting in the receive queue
+    d.state = DC_CONNECTED;
+    d.recv_number = 3;
+    d.rxQueueCount = 1;
+    d.rxQueueLen[0] = 1;
+
+    // Retransmission of frame 1 means the acknowledgment got lost
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(3, d.recv_number);
+}
+
+
+void test_PDDataSignalsReceiveCondvar() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetReceiveCondvar(&d, (void*)3));
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 0;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    d.state = DC_CONNECTED;
+    d.recv_number = 0;
+
+    // The stored message wakes up dcWaitMessage
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(1, condvarSignal_fake.call_count);
+    TEST_ASSERT_EQUAL(3, condvarSignal_fake.arg0_val);
+
+    // Retransmission of the same frame stores nothing, so there is nobody to wake up
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(1, condvarSignal_fake.call_count);
+}
+
+
+/* == Message callback ===========================================================================*/
+
+void test_PDDataDeliveredToCallback() {
+    uint8_t dummy[] = {0};
+    uint8_t data[] = {0, 1, 2, 3, 4, 5};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 3;
+        control->recv_seq_no = 0;
+        memcpy(dest, data, sizeof(data));
+        *dest_len = sizeof(data);
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    unsigned int delivered = 0;
+    void on_message(const uint8_t *payload, size_t len, void *context) {
+        TEST_ASSERT_EQUAL_PTR((void*)42, context);
+        // Payload is passed right from the scratchpad, without any copying
+        TEST_ASSERT_EQUAL_PTR(d.scratchpadBuffer, payload);
+        TEST_ASSERT_EQUAL(sizeof(data), len);
+        TEST_ASSERT_EQUAL_MEMORY(data, payload, sizeof(data));
+        // Message is acknowledged only after the callback returns
+        TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+        delivered++;
+    }
+    TEST_ASSERT_EQUAL(DC_OK, dcSetMessageCallback(&d, &on_message, (void*)42));
+
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(3, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    d.state = DC_CONNECTED;
+    d.recv_number = 3;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, delivered);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(4, d.recv_number);
+
+    // Nothing is left for dcGetReceivedMsg
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &msg_len));
+    TEST_ASSERT_EQUAL(0, msg_len);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+}
+
+
+void test_PDDataCallbackKeepsOrderOfQueuedMessages() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 1;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    unsigned int delivered = 0;
+    void on_message(const uint8_t *payload, size_t len, void *context) {
+        UNUSED_PARAM(payload);
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        delivered++;
+    }
+    TEST_ASSERT_EQUAL(DC_OK, dcSetMessageCallback(&d, &on_message, NULL));
+
+    // Message 0 was queued before the callback was set
+    d.state = DC_CONNECTED;
+    d.recv_number = 1;
+    d.rxQueueCount = 1;
+    d.rxQueueLen[0] = 1;
+
+    // Message 1 has to wait behind it
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(0, delivered);
+    TEST_ASSERT_EQUAL(2, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(2, d.recv_number);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+}
+
+
+/* == Fragmented messages ========================================================================*/
+
+void test_PDDataFragmentsReassembled() {
+    uint8_t dummy[] = {0};
+    uint8_t reassembly[10];
+    DeadcomL2 d;
+    DeadcomL2Config *c = defaultConfig();
+    c->reassembly_buffer = reassembly;
+    c->reassembly_buffer_len = sizeof(reassembly);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, c);
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    // Message of 10 bytes in fragments of 4, 4 and 2 bytes, followed by an ordinary message
+    uint8_t seq = 0;
+    int get_data_fake_fragment(yahdlc_state_t *state, yahdlc_control_t *control,
+                               const uint8_t *src, size_t src_len, uint8_t* dest,
+                               size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq;
+        control->recv_seq_no = 0;
+        control->more = seq < 2;
+        *dest_len = seq < 2 ? 4 : 2;
+        for (size_t i = 0; i < *dest_len; i++) {
+            dest[i] = (seq < 3) ? seq*4 + i : 0x42;
+        }
+        seq++;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_fragment;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        // Each fragment but the last one is acknowledged right away, the last one when the whole
+        // message is picked up
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(transmitBytes_fake.call_count - 1,
+                          ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    d.state = DC_CONNECTED;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &msg_len));
+    TEST_ASSERT_EQUAL(0, msg_len);
+
+    // The last fragment completes the message, the next message is queued behind it
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(2, d.rxQueueCount);
+
+    uint8_t buffer[sizeof(reassembly)];
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &msg_len));
+    TEST_ASSERT_EQUAL(10, msg_len);
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(10, msg_len);
+    for (uint8_t i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL(i, buffer[i]);
+    }
+    TEST_ASSERT_EQUAL(3, transmitBytes_fake.call_count);
+
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(2, msg_len);
+    TEST_ASSERT_EQUAL(0x42, buffer[0]);
+    TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+}
+
+
+void test_PDDataFragmentedMessageTooLong() {
+    uint8_t dummy[] = {0};
+    uint8_t reassembly[7];
+    DeadcomL2 d;
+    DeadcomL2Config *c = defaultConfig();
+    c->reassembly_buffer = reassembly;
+    c->reassembly_buffer_len = sizeof(reassembly);
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, c);
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    uint8_t seq = 0;
+    int get_data_fake_fragment(yahdlc_state_t *state, yahdlc_control_t *control,
+                               const uint8_t *src, size_t src_len, uint8_t* dest,
+                               size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq;
+        control->recv_seq_no = 0;
+        control->more = seq < 2;
+        memset(dest, seq, 4);
+        *dest_len = 4;
+        seq++;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_fragment;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    d.state = DC_CONNECTED;
+
+    // Message does not fit into the reassembly buffer. All its fragments are acknowledged, but the
+    // message is discarded.
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    }
+    TEST_ASSERT_EQUAL(3, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(3, d.recv_number);
+    TEST_ASSERT_EQUAL(0, d.rxQueueCount);
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, NULL, &msg_len));
+    TEST_ASSERT_EQUAL(0, msg_len);
+}
+
+
+/* == Selective reject ===========================================================================*/
+
+void test_PDDataSelectiveReject() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetSelectiveReject(&d, true));
+
+    uint8_t seq;
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq;
+        control->recv_seq_no = 0;
+        dest[0] = 0x40 + seq;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    yahdlc_frame_t expected_frame = YAHDLC_FRAME_SREJ;
+    uint8_t expected_nr[] = {0, 2};
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(expected_frame, ((yahdlc_control_t*)data)->frame);
+        if (expected_frame == YAHDLC_FRAME_SREJ) {
+            TEST_ASSERT_EQUAL(expected_nr[transmitBytes_fake.call_count - 1],
+                              ((yahdlc_control_t*)data)->recv_seq_no);
+        }
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    d.state = DC_CONNECTED;
+
+    // Frames 0 and 2 got lost. Frames after them are kept and only the lost ones are rejected.
+    seq = 1;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    seq = 3;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    // Retransmission of the last kept frame does not lead to more rejects
+    seq = 3;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(0, d.rxQueueCount);
+    TEST_ASSERT_FALSE(d.rxRejected);
+
+    // The rejected frames arrive, the kept frames follow them to the receive queue
+    seq = 0;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(2, d.recv_number);
+    seq = 2;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(4, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(4, d.recv_number);
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+
+    expected_frame = YAHDLC_FRAME_ACK;
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+        size_t msg_len;
+        TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+        TEST_ASSERT_EQUAL(1, msg_len);
+        TEST_ASSERT_EQUAL(0x40 + i, buffer[0]);
+    }
+    TEST_ASSERT_EQUAL(6, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+}
+
+
+void test_PDDataSelectiveRejectAgainWhenGoneBack() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetSelectiveReject(&d, true));
+
+    uint8_t seq;
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq;
+        control->recv_seq_no = 0;
+        dest[0] = seq;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_SREJ, ((yahdlc_control_t*)data)->frame);
+        TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)data)->recv_seq_no);
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    d.state = DC_CONNECTED;
+
+    // Frame 0 got lost
+    for (seq = 1; seq < 4; seq++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    }
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+
+    // The other station timed out and went back, but frame 0 got lost again
+    for (seq = 1; seq < 4; seq++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    }
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(0, d.recv_number);
+    TEST_ASSERT_EQUAL(0, d.rxQueueCount);
+}
+
+
+void test_PDDataSelectiveRejectFallsBackToReject() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Config *c = defaultConfig();
+    c->rx_queue_slots = 2;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, c);
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetSelectiveReject(&d, true));
+
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = 2;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    d.state = DC_CONNECTED;
+
+    // There is no free slot for the frame, all frames from the missing one on are rejected
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_NACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(7, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+}
+
+
+void test_PDProcessSrejRetransmitsFrame() {
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 4));
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    }
+
+    setUp();
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    uint8_t nr = 1;
+    int get_data_fake_srej_frame(yahdlc_state_t *state, yahdlc_control_t *control,
+                                 const uint8_t *src, size_t src_len, uint8_t* dest,
+                                 size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = YAHDLC_FRAME_SREJ;
+        control->recv_seq_no = nr;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_srej_frame;
+
+    // Only the rejected frame is retransmitted, nothing is acknowledged
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA,
+                      ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(1, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->send_seq_no);
+    TEST_ASSERT_EQUAL(0, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(0, d.failure_count);
+
+    // Frame which is not awaiting acknowledgment can't be retransmitted
+    nr = 3;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+}
+
+/* == Flow control ===============================================================================*/
+
+void test_PDProcessRnrPausesRetransmissions() {
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 3));
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+    uint32_t now = 0;
+    TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, now));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+
+    setUp();
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    yahdlc_frame_t frame = YAHDLC_FRAME_RNR;
+    int get_data_fake_rnr_frame(yahdlc_state_t *state, yahdlc_control_t *control,
+                                const uint8_t *src, size_t src_len, uint8_t* dest,
+                                size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = frame;
+        control->recv_seq_no = 0;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_rnr_frame;
+
+    // The other station acknowledges frame 0 and is not ready for frame 1
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, d.next_expected_ack);
+    TEST_ASSERT_TRUE(d.peerBusy);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+
+    // No more frames are sent while it is busy
+    void onComplete(DeadcomL2Result result, void *context) {
+        UNUSED_PARAM(result);
+        UNUSED_PARAM(context);
+    }
+    TEST_ASSERT_EQUAL(DC_BUSY, dcSendMessageAsync(&d, message, sizeof(message), &onComplete, NULL));
+
+    // It is polled with the oldest frame, and as long as it answers, the link is not reset
+    for (unsigned int i = 1; i <= 2 * DEADCOM_MAX_FAILURE_COUNT; i++) {
+        now += d.rto;
+        TEST_ASSERT_EQUAL(DC_OK, dcTick(&d, now));
+        TEST_ASSERT_EQUAL(i, transmitBytes_fake.call_count);
+        TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+        TEST_ASSERT_EQUAL(1, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->send_seq_no);
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+        TEST_ASSERT_EQUAL(0, d.failure_count);
+        TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+    }
+
+    // ACK tells that it is ready again
+    frame = YAHDLC_FRAME_ACK;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_FALSE(d.peerBusy);
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessageAsync(&d, message, sizeof(message), &onComplete, NULL));
+}
+
+
+void test_PDProcessNackAfterRnrIsNoFailure() {
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 3));
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+
+    setUp();
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    yahdlc_frame_t frame = YAHDLC_FRAME_RNR;
+    int get_data_fake_rnr_frame(yahdlc_state_t *state, yahdlc_control_t *control,
+                                const uint8_t *src, size_t src_len, uint8_t* dest,
+                                size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = frame;
+        control->recv_seq_no = 0;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_rnr_frame;
+
+    // Some thread waits for acknowledgments while the other station is not ready for frame 1
+    d.state = DC_TRANSMITTING;
+    d.last_response = DC_RESP_OK;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_TRUE(d.peerBusy);
+
+    // Once it has room again, it rejects the discarded frame. It is retransmitted right away, the
+    // waiting thread is not woken up to count it as a failure.
+    frame = YAHDLC_FRAME_NACK;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_FALSE(d.peerBusy);
+    TEST_ASSERT_EQUAL(DC_RESP_OK, d.last_response);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(1, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->send_seq_no);
+
+    // Rejects while it is ready are left to the waiting thread
+    setUp();
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_rnr_frame;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_RESP_REJECT, d.last_response);
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+}
+
+
+void test_PDDataAckedRightAwayAfterRnr() {
+    uint8_t dummy[] = {0};
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetDelayedAck(&d, true));
+
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+
+    // The frame is queued, its retransmission is answered with RNR
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_RNR, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+
+    // The other station waits for us, acknowledgment is not held back
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+    TEST_ASSERT_FALSE(d.rxNotReady);
+}
+
+/* == Early acknowledgments ======================================================================*/
+
+void test_PDDataEarlyAck() {
+    uint8_t dummy[] = {0};
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetEarlyAck(NULL, true));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetEarlyAck(&d, true));
+
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+
+    // The message is acknowledged as soon as it is queued
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+
+    // Its retransmission means the acknowledgment got lost
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+
+    // Picking it up has nothing more to acknowledge
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(6, msg_len);
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+}
+
+
+void test_PDDataEarlyAckRejectsRightAway() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    uint8_t seq = 0;
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+
+    // Frame 0 is queued, not acknowledged yet
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+
+    // Switching early acknowledgments on acknowledges it
+    TEST_ASSERT_EQUAL(DC_OK, dcSetEarlyAck(&d, true));
+    TEST_ASSERT_EQUAL(1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+
+    // Frame 1 got lost. Going back to it does not retransmit the queued message, so it is rejected
+    // right away instead of once the queue is empty.
+    seq = 2;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_NACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(0, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+    TEST_ASSERT_FALSE(d.rxDiscarded);
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+}
+
+
+void test_PDDataEarlyAckFullQueueIsNotReady() {
+    uint8_t dummy[] = {0};
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetEarlyAck(&d, true));
+
+    uint8_t seq = 0;
+    int get_data_fake_data_frame(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                                 size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        control->frame = YAHDLC_FRAME_DATA;
+        control->send_seq_no = seq++;
+        control->recv_seq_no = 0;
+        dest[0] = 0x42;
+        *dest_len = 1;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    d.state = DC_CONNECTED;
+    // Sequence numbers must not wrap around while the queue is filled
+    d.extended_mode = true;
+
+    // Frames are acknowledged as they are queued, the one which fills the queue up tells the other
+    // station to hold back
+    for (unsigned int i = 1; i <= DEADCOM_RX_QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+        TEST_ASSERT_EQUAL(i, transmitBytes_fake.call_count);
+        TEST_ASSERT_EQUAL(i < DEADCOM_RX_QUEUE_SIZE ? YAHDLC_FRAME_ACK : YAHDLC_FRAME_RNR,
+                          ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+        TEST_ASSERT_EQUAL(i - 1, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+    }
+    TEST_ASSERT_EQUAL(DEADCOM_RX_QUEUE_SIZE, d.rxQueueCount);
+
+    // Once there is room again, it learns that right away
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(DEADCOM_RX_QUEUE_SIZE + 1, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->frame);
+    TEST_ASSERT_EQUAL(DEADCOM_RX_QUEUE_SIZE - 1,
+                      ((yahdlc_control_t*)transmitBytes_fake.arg0_val)->recv_seq_no);
+
+    // Picking up the rest has nothing more to acknowledge
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(DEADCOM_RX_QUEUE_SIZE + 1, transmitBytes_fake.call_count);
+}
+
+
+/* == Event notifications ========================================================================*/
+
+void test_PDEventsNotified() {
+    uint8_t dummy[] = {0};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+
+    unsigned int events = 0;
+    void onEvent(void *context) {
+        TEST_ASSERT_EQUAL(3, context);
+        events++;
+    }
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetEventCallback(NULL, &onEvent, (void*)3));
+    TEST_ASSERT_EQUAL(DC_OK, dcSetEventCallback(&d, &onEvent, (void*)3));
+
+    int get_data_fake_ack1_frame(yahdlc_state_t *state, yahdlc_control_t *control,
+                                 const uint8_t *src, size_t src_len, uint8_t* dest,
+                                 size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = YAHDLC_FRAME_ACK;
+        control->recv_seq_no = 1;
+        *dest_len = 0;
+        return src_len;
+    }
+
+    // The other station connects the link
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+    TEST_ASSERT_EQUAL(1, events);
+
+    // A message is received
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(1, d.rxQueueCount);
+    TEST_ASSERT_EQUAL(2, events);
+
+    // Its retransmission is no news
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, events);
+
+    // Frames 0 and 1 are acknowledged
+    d.send_number = 2;
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_ack1_frame;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(2, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(3, events);
+
+    // The link is disconnected, no more notifications once the callback is removed
+    TEST_ASSERT_EQUAL(DC_OK, dcDisconnect(&d));
+    TEST_ASSERT_EQUAL(4, events);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetEventCallback(&d, NULL, NULL));
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_conn_frame;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(4, events);
+}
+
+
+/* == Receive ring ===============================================================================*/
+
+void test_RxRingInvalidParams() {
+    DeadcomL2 d;
+    uint8_t data[4] = {0};
+    uint8_t ring[16];
+    DeadcomL2Config c = *defaultConfig();
+
+    // Ring length must be a power of two
+    c.rx_ring = ring;
+    c.rx_ring_len = 12;
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+    c.rx_ring_len = 0;
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+
+    // A link without ring can't use it
+    TEST_ASSERT_EQUAL(DC_OK, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL,
+                                    defaultConfig()));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcRxPush(&d, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcRxDrain(&d));
+
+    c.rx_ring_len = sizeof(ring);
+    TEST_ASSERT_EQUAL(DC_OK, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcRxPush(NULL, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcRxPush(&d, NULL, sizeof(data)));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcRxDrain(NULL));
+
+    // Nothing pushed, nothing processed
+    TEST_ASSERT_EQUAL(DC_OK, dcRxDrain(&d));
+    TEST_ASSERT_EQUAL(0, yahdlc_get_data_fake.call_count);
+    TEST_ASSERT_EQUAL(0, mutexLock_fake.call_count);
+}
+
+
+void test_RxRingDrainedInPlace() {
+    DeadcomL2 d;
+    uint8_t data[10];
+    uint8_t ring[16];
+    for (unsigned int i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+
+    unsigned int seen_bytes = 0;
+    const uint8_t *chunks[3];
+    size_t chunk_lens[3];
+    int get_data_fake(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                      size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(control);
+        UNUSED_PARAM(dest);
+        chunks[yahdlc_get_data_fake.call_count - 1] = src;
+        chunk_lens[yahdlc_get_data_fake.call_count - 1] = src_len;
+        for (size_t i = 0; i < src_len; i++) {
+            TEST_ASSERT_EQUAL(seen_bytes % sizeof(data), src[i]);
+            seen_bytes++;
+        }
+        *dest_len = src_len;
+        return -ENOMSG;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake;
+
+    DeadcomL2Config c = *defaultConfig();
+    c.rx_ring = ring;
+    c.rx_ring_len = sizeof(ring);
+    TEST_ASSERT_EQUAL(DC_OK, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+
+    // Pushing does not lock the link, draining processes all pushed bytes at once
+    TEST_ASSERT_EQUAL(DC_OK, dcRxPush(&d, data, 4));
+    TEST_ASSERT_EQUAL(DC_OK, dcRxPush(&d, data + 4, 6));
+    TEST_ASSERT_EQUAL(0, mutexLock_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_OK, dcRxDrain(&d));
+    TEST_ASSERT_EQUAL(1, yahdlc_get_data_fake.call_count);
+    TEST_ASSERT_EQUAL_PTR(ring, chunks[0]);
+    TEST_ASSERT_EQUAL(10, chunk_lens[0]);
+    TEST_ASSERT_EQUAL(1, mutexLock_fake.call_count);
+
+    // Bytes wrapping around the end of the ring are processed in two chunks
+    TEST_ASSERT_EQUAL(DC_OK, dcRxPush(&d, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(DC_OK, dcRxDrain(&d));
+    TEST_ASSERT_EQUAL(3, yahdlc_get_data_fake.call_count);
+    TEST_ASSERT_EQUAL_PTR(ring + 10, chunks[1]);
+    TEST_ASSERT_EQUAL(6, chunk_lens[1]);
+    TEST_ASSERT_EQUAL_PTR(ring, chunks[2]);
+    TEST_ASSERT_EQUAL(4, chunk_lens[2]);
+    TEST_ASSERT_EQUAL(20, seen_bytes);
+}
+
+
+void test_RxRingDiscardsBytesWhenFull() {
+    DeadcomL2 d;
+    uint8_t data[10] = {0};
+    uint8_t ring[16];
+
+    int get_data_fake(yahdlc_state_t *state, yahdlc_control_t *control, const uint8_t *src,
+                      size_t src_len, uint8_t* dest, size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(control);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        *dest_len = src_len;
+        return -ENOMSG;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake;
+
+    DeadcomL2Config c = *defaultConfig();
+    c.rx_ring = ring;
+    c.rx_ring_len = sizeof(ring);
+    TEST_ASSERT_EQUAL(DC_OK, dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, &c));
+
+    TEST_ASSERT_EQUAL(DC_OK, dcRxPush(&d, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(DC_BUSY, dcRxPush(&d, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(DC_BUSY, dcRxPush(&d, data, 1));
+    TEST_ASSERT_EQUAL(DC_OK, dcRxDrain(&d));
+    TEST_ASSERT_EQUAL(1, yahdlc_get_data_fake.call_count);
+    TEST_ASSERT_EQUAL(16, yahdlc_get_data_fake.arg3_val);
+
+    // Drained ring has room again, also if processing fails
+    TEST_ASSERT_EQUAL(DC_OK, dcRxPush(&d, data, sizeof(data)));
+    mutexLock_fake.return_val = false;
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcRxDrain(&d));
+    mutexLock_fake.return_val = true;
+    TEST_ASSERT_EQUAL(DC_OK, dcRxPush(&d, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(DC_OK, dcRxPush(&d, data, 6));
+    TEST_ASSERT_EQUAL(DC_BUSY, dcRxPush(&d, data, 1));
+}
+
+/* == Transmit queue =============================================================================*/
+
+void test_TxQueueInvalidParams() {
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+
+    void notify(void *context) {
+        UNUSED_PARAM(context);
+    }
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcSetTransmitQueue(NULL, &notify, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcTransmitPending(NULL));
+    // Transmission is not queued
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcTransmitPending(&d));
+
+    TEST_ASSERT_EQUAL(DC_OK, dcSetTransmitQueue(&d, &notify, NULL));
+    TEST_ASSERT_EQUAL(DC_OK, dcTransmitPending(&d));
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetTransmitQueue(&d, NULL, NULL));
+    TEST_ASSERT_EQUAL(DC_FAILURE, dcTransmitPending(&d));
+}
+
+
+void test_TxQueueAckTransmittedBeforeData() {
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 3));
+
+    unsigned int notified = 0;
+    void notify(void *context) {
+        TEST_ASSERT_EQUAL_PTR(&d, context);
+        notified++;
+    }
+    TEST_ASSERT_EQUAL(DC_OK, dcSetTransmitQueue(&d, &notify, &d));
+
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_data_frame;
+    d.state = DC_CONNECTED;
+
+    // Neither the DATA frame nor acknowledgment of the picked up message is transmitted right away
+    TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    uint8_t buffer[DEADCOM_PAYLOAD_MAX_LEN];
+    size_t msg_len;
+    TEST_ASSERT_EQUAL(DC_OK, dcGetReceivedMsg(&d, buffer, &msg_len));
+    TEST_ASSERT_EQUAL(0, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(2, notified);
+
+    yahdlc_control_t transmitted[2];
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        // The link is not locked during transmission
+        TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+        transmitted[transmitBytes_fake.call_count - 1] = *(yahdlc_control_t*)data;
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+
+    TEST_ASSERT_EQUAL(DC_OK, dcTransmitPending(&d));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_ACK, transmitted[0].frame);
+    TEST_ASSERT_EQUAL(0, transmitted[0].recv_seq_no);
+    // DATA frame acknowledges the message picked up after it was queued
+    TEST_ASSERT_EQUAL(YAHDLC_FRAME_DATA, transmitted[1].frame);
+    TEST_ASSERT_EQUAL(0, transmitted[1].send_seq_no);
+    TEST_ASSERT_EQUAL(1, transmitted[1].recv_seq_no);
+    TEST_ASSERT_EQUAL(mutexLock_fake.call_count, mutexUnlock_fake.call_count);
+
+    // Nothing is left
+    TEST_ASSERT_EQUAL(DC_OK, dcTransmitPending(&d));
+    TEST_ASSERT_EQUAL(2, transmitBytes_fake.call_count);
+}
+
+
+void test_TxQueueRetransmissions() {
+    uint8_t dummy[] = {0};
+    const uint8_t message[] = {0x42, 0x47};
+    DeadcomL2 d;
+    DeadcomL2Result res = dcInit(&d, (void*)1, (void*)2, &t, &transmitBytes, NULL, defaultConfig());
+    TEST_ASSERT_EQUAL(DC_OK, res);
+    TEST_ASSERT_EQUAL(DC_OK, dcSetWindowSize(&d, 4));
+
+    void notify(void *context) {
+        UNUSED_PARAM(context);
+    }
+    TEST_ASSERT_EQUAL(DC_OK, dcSetTransmitQueue(&d, &notify, NULL));
+
+    uint8_t transmitted[8];
+    bool transmitBytes_fake_impl(const uint8_t *data, size_t len, void *context) {
+        UNUSED_PARAM(len);
+        UNUSED_PARAM(context);
+        transmitted[transmitBytes_fake.call_count - 1] = ((yahdlc_control_t*)data)->send_seq_no;
+        return true;
+    }
+    transmitBytes_fake.custom_fake = &transmitBytes_fake_impl;
+    yahdlc_frame_data_fake.custom_fake = &frame_data_fake_impl;
+    d.state = DC_CONNECTED;
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(DC_OK, dcSendMessage(&d, message, sizeof(message)));
+    }
+    TEST_ASSERT_EQUAL(DC_OK, dcTransmitPending(&d));
+    TEST_ASSERT_EQUAL(3, transmitBytes_fake.call_count);
+
+    int get_data_fake_srej_frame(yahdlc_state_t *state, yahdlc_control_t *control,
+                                 const uint8_t *src, size_t src_len, uint8_t* dest,
+                                 size_t *dest_len) {
+        UNUSED_PARAM(state);
+        UNUSED_PARAM(src);
+        UNUSED_PARAM(dest);
+        control->frame = YAHDLC_FRAME_SREJ;
+        control->recv_seq_no = 1;
+        *dest_len = 0;
+        return src_len;
+    }
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_srej_frame;
+
+    // Selectively rejected frame is retransmitted alone
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(3, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_OK, dcTransmitPending(&d));
+    TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(1, transmitted[3]);
+
+    // Reject makes the whole window go again. The selective retransmission queued before is
+    // dropped, the frame goes out in sequence with the others.
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    yahdlc_get_data_fake.custom_fake = &get_data_fake_nack_frame;
+    TEST_ASSERT_EQUAL(DC_OK, dcProcessData(&d, dummy, 1));
+    TEST_ASSERT_EQUAL(4, transmitBytes_fake.call_count);
+    TEST_ASSERT_EQUAL(DC_OK, dcTransmitPending(&d));
+    TEST_ASSERT_EQUAL(7, transmitBytes_fake.call_count);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(i, transmitted[4 + i]);
+    }
+    TEST_ASSERT_EQUAL(0, d.next_expected_ack);
+    TEST_ASSERT_EQUAL(DC_CONNECTED, d.state);
+}
@@ -52,7 +52,7 @@ void test_DataFrameControlField() {
     int ret;
     uint8_t frame_data[8], recv_data[8];
     size_t i, j, frame_length = 0, recv_length = 0;
-    yahdlc_control_t control_send, control_recv;
+    yahdlc_control_t control_send = {}, control_recv = {};
     yahdlc_state_t state;
 
     yahdlc_reset_state(&state, 1024);
@@ -90,7 +90,7 @@ void test_AckFrameControlField() {
     int ret;
     uint8_t frame_data[8], recv_data[8];
     size_t i, frame_length = 0, recv_length = 0;
-    yahdlc_control_t control_send, control_recv;
+    yahdlc_control_t control_send = {}, control_recv = {};
     yahdlc_state_t state;
 
     yahdlc_reset_state(&state, 1024);
@@ -123,7 +123,7 @@ void test_NackFrameControlField() {
     int ret;
     uint8_t frame_data[8], recv_data[8];
     size_t i, frame_length = 0, recv_length = 0;
-    yahdlc_control_t control_send, control_recv;
+    yahdlc_control_t control_send = {}, control_recv = {};
     yahdlc_state_t state;
 
     yahdlc_reset_state(&state, 1024);
@@ -152,6 +152,215 @@ void test_NackFrameControlField() {
 }
 
 
+
+void test_SrejFrameControlField() {
+    int ret;
+    uint8_t frame_data[8], recv_data[8];
+    size_t i, frame_length = 0, recv_length = 0;
+    yahdlc_control_t control_send = {}, control_recv = {};
+    yahdlc_state_t state;
+
+    yahdlc_reset_state(&state, 1024);
+    for (i = 0; i <= 7; i++) {
+        control_send.frame = YAHDLC_FRAME_SREJ;
+        control_send.recv_seq_no = i;
+
+        ret = yahdlc_frame_data(&control_send, NULL, 0, frame_data, &frame_length);
+        TEST_ASSERT_EQUAL_INT(0, ret);
+        // HDLC Selective Reject S-frame
+        TEST_ASSERT_EQUAL_HEX8(0x0D | (i << 5), frame_data[2]);
+
+        ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                              &recv_length);
+        TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+        TEST_ASSERT_EQUAL_INT(0, recv_length);
+        TEST_ASSERT_EQUAL_INT(control_send.frame, control_recv.frame);
+        TEST_ASSERT_EQUAL_INT(control_send.recv_seq_no, control_recv.recv_seq_no);
+    }
+}
+
+void test_RnrFrameControlField() {
+    int ret;
+    uint8_t frame_data[8], recv_data[8];
+    size_t i, frame_length = 0, recv_length = 0;
+    yahdlc_control_t control_send = {}, control_recv = {};
+    yahdlc_state_t state;
+
+    yahdlc_reset_state(&state, 1024);
+    for (i = 0; i <= 7; i++) {
+        control_send.frame = YAHDLC_FRAME_RNR;
+        control_send.recv_seq_no = i;
+
+        ret = yahdlc_frame_data(&control_send, NULL, 0, frame_data, &frame_length);
+        TEST_ASSERT_EQUAL_INT(0, ret);
+        // HDLC Receive Not Ready S-frame
+        TEST_ASSERT_EQUAL_HEX8(0x05 | (i << 5), frame_data[2]);
+
+        ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                              &recv_length);
+        TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+        TEST_ASSERT_EQUAL_INT(0, recv_length);
+        TEST_ASSERT_EQUAL_INT(control_send.frame, control_recv.frame);
+        TEST_ASSERT_EQUAL_INT(control_send.recv_seq_no, control_recv.recv_seq_no);
+    }
+}
+
+void test_ExtendedDataFrameControlField() {
+    int ret;
+    uint8_t frame_data[16], recv_data[16];
+    size_t i, j, frame_length = 0, recv_length = 0;
+    yahdlc_control_t control_send = {}, control_recv = {};
+    yahdlc_state_t state;
+
+    yahdlc_reset_state(&state, 1024);
+    state.extended = 1;
+    // Run through the supported sequence numbers (7-bit)
+    for (i = 0; i <= 127; i++) {
+        for (j = 0; j <= 127; j += 7) {
+            control_send.frame = YAHDLC_FRAME_DATA;
+            control_send.send_seq_no = i;
+            control_send.recv_seq_no = 127 - j;
+            control_send.extended = 1;
+
+            // Data frame with a single byte of payload
+            uint8_t payload = 0x42;
+            ret = yahdlc_frame_data(&control_send, &payload, 1, frame_data, &frame_length);
+            TEST_ASSERT_EQUAL_INT(0, ret);
+
+            recv_length = 0;
+            ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                                  &recv_length);
+
+            // The second control byte must not end up in the payload
+            TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+            TEST_ASSERT_EQUAL_INT(1, recv_length);
+            TEST_ASSERT_EQUAL_HEX8(payload, recv_data[0]);
+
+            TEST_ASSERT_EQUAL_INT(YAHDLC_FRAME_DATA, control_recv.frame);
+            TEST_ASSERT_EQUAL_INT(1, control_recv.extended);
+            TEST_ASSERT_EQUAL_INT(control_send.send_seq_no, control_recv.send_seq_no);
+            TEST_ASSERT_EQUAL_INT(control_send.recv_seq_no, control_recv.recv_seq_no);
+        }
+    }
+}
+
+
+void test_DataFrameMoreFragments() {
+    int ret;
+    uint8_t frame_data[16], recv_data[16];
+    size_t frame_length = 0, recv_length = 0;
+    yahdlc_control_t control_send = {}, control_recv = {};
+    yahdlc_state_t state;
+
+    yahdlc_reset_state(&state, 1024);
+    for (int extended = 0; extended <= 1; extended++) {
+        state.extended = extended;
+        for (int more = 0; more <= 1; more++) {
+            control_send.frame = YAHDLC_FRAME_DATA;
+            control_send.send_seq_no = 5;
+            control_send.recv_seq_no = 3;
+            control_send.extended = extended;
+            control_send.more = more;
+
+            uint8_t payload = 0x42;
+            ret = yahdlc_frame_data(&control_send, &payload, 1, frame_data, &frame_length);
+            TEST_ASSERT_EQUAL_INT(0, ret);
+
+            // Only complete messages have the P/F bit set
+            uint8_t pf = extended ? (frame_data[3] & 0x01) : (frame_data[2] & 0x10);
+            TEST_ASSERT_EQUAL(!more, pf != 0);
+
+            ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                                  &recv_length);
+            TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+            TEST_ASSERT_EQUAL_INT(1, recv_length);
+            TEST_ASSERT_EQUAL_INT(YAHDLC_FRAME_DATA, control_recv.frame);
+            TEST_ASSERT_EQUAL_INT(more, control_recv.more);
+            TEST_ASSERT_EQUAL_INT(5, control_recv.send_seq_no);
+            TEST_ASSERT_EQUAL_INT(3, control_recv.recv_seq_no);
+        }
+    }
+}
+
+
+void test_ExtendedSupervisoryFrameControlField() {
+    int ret;
+    uint8_t frame_data[16], recv_data[16];
+    size_t i, frame_length = 0, recv_length = 0;
+    yahdlc_control_t control_send = {}, control_recv = {};
+    yahdlc_state_t state;
+    yahdlc_frame_t types[] = {YAHDLC_FRAME_ACK, YAHDLC_FRAME_NACK, YAHDLC_FRAME_SREJ,
+                              YAHDLC_FRAME_RNR};
+
+    yahdlc_reset_state(&state, 1024);
+    state.extended = 1;
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++) {
+        for (i = 0; i <= 127; i++) {
+            control_send.frame = types[t];
+            control_send.recv_seq_no = i;
+            control_send.extended = 1;
+
+            ret = yahdlc_frame_data(&control_send, NULL, 0, frame_data, &frame_length);
+            TEST_ASSERT_EQUAL_INT(0, ret);
+
+            ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                                  &recv_length);
+            TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+            TEST_ASSERT_EQUAL_INT(0, recv_length);
+            TEST_ASSERT_EQUAL_INT(control_send.frame, control_recv.frame);
+            TEST_ASSERT_EQUAL_INT(control_send.recv_seq_no, control_recv.recv_seq_no);
+        }
+    }
+}
+
+
+void test_ConnFrameModes() {
+    int ret;
+    uint8_t frame_data[16], recv_data[16];
+    size_t frame_length = 0, recv_length = 0;
+    yahdlc_control_t control_send = {}, control_recv = {};
+    yahdlc_state_t state;
+
+    // U frames have single-byte control field in both modes
+    for (uint8_t decoder_extended = 0; decoder_extended <= 1; decoder_extended++) {
+        yahdlc_reset_state(&state, 1024);
+        state.extended = decoder_extended;
+
+        // SABM
+        control_send.frame = YAHDLC_FRAME_CONN;
+        control_send.extended = 0;
+        ret = yahdlc_frame_data(&control_send, NULL, 0, frame_data, &frame_length);
+        TEST_ASSERT_EQUAL_INT(0, ret);
+        TEST_ASSERT_EQUAL_HEX8(0x3F, frame_data[2]);
+        ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                              &recv_length);
+        TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+        TEST_ASSERT_EQUAL_INT(YAHDLC_FRAME_CONN, control_recv.frame);
+        TEST_ASSERT_EQUAL_INT(0, control_recv.extended);
+
+        // SABME
+        control_send.extended = 1;
+        ret = yahdlc_frame_data(&control_send, NULL, 0, frame_data, &frame_length);
+        TEST_ASSERT_EQUAL_INT(0, ret);
+        TEST_ASSERT_EQUAL_HEX8(0x7F, frame_data[2]);
+        ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                              &recv_length);
+        TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+        TEST_ASSERT_EQUAL_INT(YAHDLC_FRAME_CONN, control_recv.frame);
+        TEST_ASSERT_EQUAL_INT(1, control_recv.extended);
+
+        // UA
+        control_send.frame = YAHDLC_FRAME_CONN_ACK;
+        ret = yahdlc_frame_data(&control_send, NULL, 0, frame_data, &frame_length);
+        TEST_ASSERT_EQUAL_INT(0, ret);
+        ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                              &recv_length);
+        TEST_ASSERT_EQUAL_INT(ret, ((int )frame_length - 1));
+        TEST_ASSERT_EQUAL_INT(YAHDLC_FRAME_CONN_ACK, control_recv.frame);
+    }
+}
+
+
 void test_0To512BytesData() {
     int ret;
     size_t i, frame_length = 0, estimated_frame_length = 0, recv_length = 0;
@@ -478,3 +687,266 @@ void test_FramesWithBitErrors() {
         }
     }
 }
+
+
+void test_ControlBytesAroundBlockBoundaries() {
+    int ret;
+    yahdlc_control_t control = {.frame = YAHDLC_FRAME_DATA};
+    uint8_t send_data[100], frame_data[220], recv_data[220];
+    size_t frame_length, expected_length, recv_length;
+    const size_t chunks[] = {1, 7, 16, 33, sizeof(frame_data)};
+    yahdlc_state_t state;
+
+    yahdlc_reset_state(&state, sizeof(recv_data));
+    // Put flag sequence or control escape at every offset, also next to each other, so that they
+    // fall on both sides of every 16 and 32 byte block
+    for (size_t pos = 0; pos < sizeof(send_data); pos++) {
+        for (uint8_t special = 0; special < 3; special++) {
+            memset(send_data, 0x11, sizeof(send_data));
+            send_data[pos] = special ? YAHDLC_FLAG_SEQUENCE : YAHDLC_CONTROL_ESCAPE;
+            if (special == 2 && pos + 1 < sizeof(send_data)) {
+                send_data[pos + 1] = YAHDLC_CONTROL_ESCAPE;
+            }
+            ret = yahdlc_frame_data(&control, send_data, sizeof(send_data), NULL,
+                                    &expected_length);
+            TEST_ASSERT_EQUAL_INT(0, ret);
+            ret = yahdlc_frame_data(&control, send_data, sizeof(send_data), frame_data,
+                                    &frame_length);
+            TEST_ASSERT_EQUAL_INT(0, ret);
+            TEST_ASSERT_EQUAL(expected_length, frame_length);
+
+            for (size_t c = 0; c < sizeof(chunks)/sizeof(chunks[0]); c++) {
+                int decoded = 0;
+                memset(recv_data, 0, sizeof(recv_data));
+                for (size_t i = 0; i < frame_length; i += chunks[c]) {
+                    size_t len = (frame_length - i < chunks[c]) ? frame_length - i : chunks[c];
+                    ret = yahdlc_get_data(&state, &control, &frame_data[i], len, recv_data,
+                                          &recv_length);
+                    if (ret != -ENOMSG) {
+                        TEST_ASSERT_TRUE(ret >= 0);
+                        TEST_ASSERT_EQUAL_INT(sizeof(send_data), recv_length);
+                        decoded++;
+                    }
+                }
+                TEST_ASSERT_EQUAL_INT(1, decoded);
+                TEST_ASSERT_EQUAL_MEMORY(send_data, recv_data, sizeof(send_data));
+            }
+        }
+    }
+}
+
+
+void test_FcsBufSameAsFcs() {
+    uint8_t data[300];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) rand();
+    }
+
+    // All lengths up to and past the block sizes, also at unaligned start
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; offset + len <= sizeof(data); len++) {
+            uint16_t initial = (uint16_t) rand(), expected = initial;
+            for (size_t i = 0; i < len; i++) {
+                expected = fcs16(expected, data[offset + i]);
+            }
+            TEST_ASSERT_EQUAL_HEX16(expected, fcs16_buf(initial, data + offset, len));
+        }
+    }
+}
+
+
+void test_Fcs32() {
+    const uint8_t check[] = "123456789";
+    // Check value of CRC-32C
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, ~fcs32_buf(FCS32_INIT_VALUE, check, 9));
+    // Split computation gives the same result
+    for (size_t split = 0; split <= 9; split++) {
+        uint32_t fcs = fcs32_buf(FCS32_INIT_VALUE, check, split);
+        TEST_ASSERT_EQUAL_HEX32(0xE3069283, ~fcs32_buf(fcs, check + split, 9 - split));
+    }
+}
+
+
+void test_Fcs32Frames() {
+    int ret;
+    yahdlc_control_t control = {.frame = YAHDLC_FRAME_DATA, .send_seq_no = 5, .fcs32 = 1};
+    yahdlc_control_t control_recv;
+    static uint8_t send_data[4096], frame_data[8224], recv_data[4101];
+    size_t frame_length, expected_length, recv_length;
+    const uint8_t *frame;
+    yahdlc_state_t state;
+
+    for (size_t i = 0; i < sizeof(send_data); i++) {
+        send_data[i] = (uint8_t) rand();
+    }
+    yahdlc_reset_state(&state, sizeof(recv_data));
+    state.fcs32 = 1;
+
+    const size_t lengths[] = {0, 1, 5, 31, 249, 1000, sizeof(send_data)};
+    for (size_t l = 0; l < sizeof(lengths)/sizeof(lengths[0]); l++) {
+        ret = yahdlc_frame_data(&control, send_data, lengths[l], NULL, &expected_length);
+        TEST_ASSERT_EQUAL_INT(0, ret);
+        ret = yahdlc_frame_data(&control, send_data, lengths[l], frame_data, &frame_length);
+        TEST_ASSERT_EQUAL_INT(0, ret);
+        TEST_ASSERT_EQUAL(expected_length, frame_length);
+
+        ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                              &recv_length);
+        TEST_ASSERT_EQUAL_INT(frame_length - 1, ret);
+        TEST_ASSERT_EQUAL(lengths[l], recv_length);
+        TEST_ASSERT_EQUAL_MEMORY(send_data, recv_data, lengths[l]);
+        TEST_ASSERT_EQUAL(5, control_recv.send_seq_no);
+
+        // Any flipped bit is detected
+        frame_data[frame_length / 2] ^= 0x01;
+        ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data,
+                              &recv_length);
+        TEST_ASSERT_EQUAL_INT(-EIO, ret);
+    }
+
+    // Frames with CRC-32C are not accepted by decoder expecting CRC-16 and vice versa
+    ret = yahdlc_frame_data(&control, send_data, 10, frame_data, &frame_length);
+    state.fcs32 = 0;
+    ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data, &recv_length);
+    TEST_ASSERT_EQUAL_INT(-EIO, ret);
+    control.fcs32 = 0;
+    state.fcs32 = 1;
+    ret = yahdlc_frame_data(&control, send_data, 10, frame_data, &frame_length);
+    ret = yahdlc_get_data(&state, &control_recv, frame_data, frame_length, recv_data, &recv_length);
+    TEST_ASSERT_EQUAL_INT(-EIO, ret);
+
+    // Control frames with CRC-32C are not encoded in advance
+    yahdlc_control_t ack = {.frame = YAHDLC_FRAME_ACK, .fcs32 = 1};
+    TEST_ASSERT_EQUAL_INT(-ENOENT, yahdlc_frame_lookup(&ack, &frame, &frame_length));
+}
+
+
+void test_FrameLookupSameAsFrameData() {
+    const uint8_t *frame;
+    size_t frame_length, lookup_length;
+    uint8_t frame_data[16];
+    yahdlc_frame_t types[] = {YAHDLC_FRAME_ACK, YAHDLC_FRAME_NACK, YAHDLC_FRAME_SREJ,
+                              YAHDLC_FRAME_CONN, YAHDLC_FRAME_CONN_ACK, YAHDLC_FRAME_RNR};
+
+    for (uint8_t extended = 0; extended <= 1; extended++) {
+        for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++) {
+            for (unsigned int nr = 0; nr < (extended ? 128 : 8); nr++) {
+                yahdlc_control_t control = {
+                    .frame = types[t], .recv_seq_no = nr, .extended = extended
+                };
+                int ret = yahdlc_frame_lookup(&control, &frame, &lookup_length);
+                if ((extended && (types[t] == YAHDLC_FRAME_NACK ||
+                                  types[t] == YAHDLC_FRAME_SREJ)) ||
+                    types[t] == YAHDLC_FRAME_RNR) {
+                    // Rare frames are not in the table
+                    TEST_ASSERT_EQUAL_INT(-ENOENT, ret);
+                    continue;
+                }
+                TEST_ASSERT_EQUAL_INT(0, ret);
+                yahdlc_frame_data(&control, NULL, 0, frame_data, &frame_length);
+                TEST_ASSERT_EQUAL(frame_length, lookup_length);
+                TEST_ASSERT_EQUAL_MEMORY(frame_data, frame, frame_length);
+            }
+        }
+    }
+
+    yahdlc_control_t control = {.frame = YAHDLC_FRAME_DATA};
+    TEST_ASSERT_EQUAL_INT(-ENOENT, yahdlc_frame_lookup(&control, &frame, &lookup_length));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, yahdlc_frame_lookup(NULL, &frame, &lookup_length));
+}
+
+
+/* Collects segments passed by yahdlc_frame_data_vec into one buffer */
+static uint8_t vec_frame[1024];
+static size_t vec_frame_len, vec_calls, vec_from_src;
+static const uint8_t *vec_src;
+static size_t vec_src_len;
+
+static bool collect_segments(const yahdlc_iovec_t *iov, size_t iov_count, void *context) {
+    TEST_ASSERT_EQUAL_PTR(vec_frame, context);
+    TEST_ASSERT_TRUE(iov_count > 0 && iov_count <= YAHDLC_IOV_MAX);
+    for (size_t i = 0; i < iov_count; i++) {
+        memcpy(vec_frame + vec_frame_len, iov[i].base, iov[i].len);
+        vec_frame_len += iov[i].len;
+        if (iov[i].base >= vec_src && iov[i].base + iov[i].len <= vec_src + vec_src_len) {
+            vec_from_src += iov[i].len;
+        }
+    }
+    vec_calls++;
+    return true;
+}
+
+static bool fail_segments(const yahdlc_iovec_t *iov, size_t iov_count, void *context) {
+    (void)iov;
+    (void)iov_count;
+    (void)context;
+    return false;
+}
+
+
+void test_FrameDataVecInvalidInputs() {
+    yahdlc_control_t control = {};
+    uint8_t send_data[8] = {0};
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, yahdlc_frame_data_vec(NULL, send_data, sizeof(send_data),
+                                                         &collect_segments, vec_frame));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, yahdlc_frame_data_vec(&control, NULL, 1, &collect_segments,
+                                                         vec_frame));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, yahdlc_frame_data_vec(&control, send_data, sizeof(send_data),
+                                                         NULL, vec_frame));
+    // Failure of the transmit function is reported
+    TEST_ASSERT_EQUAL_INT(-EIO, yahdlc_frame_data_vec(&control, send_data, sizeof(send_data),
+                                                      &fail_segments, NULL));
+}
+
+
+void test_FrameDataVecSameAsFrameData() {
+    uint8_t send_data[249], frame_data[sizeof(send_data)*2 + 16];
+    size_t frame_length;
+    yahdlc_control_t controls[] = {
+        {.frame = YAHDLC_FRAME_DATA, .send_seq_no = 3, .recv_seq_no = 5},
+        {.frame = YAHDLC_FRAME_DATA, .send_seq_no = 126, .recv_seq_no = 62, .extended = 1},
+        {.frame = YAHDLC_FRAME_DATA, .send_seq_no = 1, .recv_seq_no = 2, .fcs32 = 1},
+        {.frame = YAHDLC_FRAME_ACK, .recv_seq_no = 3},
+        {.frame = YAHDLC_FRAME_CONN_ACK},
+    };
+
+    // Payloads without bytes to escape, with some, and consisting of them only
+    for (unsigned int pattern = 0; pattern < 3; pattern++) {
+        unsigned int seed = pattern;
+        size_t escaped = 0;
+        for (size_t i = 0; i < sizeof(send_data); i++) {
+            switch (pattern) {
+                case 0: send_data[i] = i % 0x70; break;
+                case 1: send_data[i] = rand_r(&seed) % 256; break;
+                default: send_data[i] = (i % 2) ? YAHDLC_FLAG_SEQUENCE : YAHDLC_CONTROL_ESCAPE;
+            }
+            if (send_data[i] == YAHDLC_FLAG_SEQUENCE || send_data[i] == YAHDLC_CONTROL_ESCAPE) {
+                escaped++;
+            }
+        }
+
+        for (size_t c = 0; c < sizeof(controls)/sizeof(controls[0]); c++) {
+            TEST_ASSERT_EQUAL_INT(0, yahdlc_frame_data(&controls[c], send_data, sizeof(send_data),
+                                                       frame_data, &frame_length));
+            vec_frame_len = vec_calls = vec_from_src = 0;
+            vec_src = send_data;
+            vec_src_len = sizeof(send_data);
+            TEST_ASSERT_EQUAL_INT(0, yahdlc_frame_data_vec(&controls[c], send_data,
+                                                           sizeof(send_data), &collect_segments,
+                                                           vec_frame));
+            TEST_ASSERT_EQUAL(frame_length, vec_frame_len);
+            TEST_ASSERT_EQUAL_MEMORY(frame_data, vec_frame, frame_length);
+
+            if (controls[c].frame == YAHDLC_FRAME_DATA) {
+                // Bytes which need no escaping are passed directly from the source buffer
+                TEST_ASSERT_EQUAL(sizeof(send_data) - escaped, vec_from_src);
+                // Frames are passed at once, unless escaped bytes (one segment each) don't fit
+                size_t segments = (pattern == 2) ? escaped + 2 : 1;
+                TEST_ASSERT_EQUAL((segments + YAHDLC_IOV_MAX - 1) / YAHDLC_IOV_MAX, vec_calls);
+            } else {
+                TEST_ASSERT_EQUAL(1, vec_calls);
+            }
+        }
+    }
+}
@@ -12,7 +12,7 @@ void test_ConnFrameControlField() {
     int ret;
     uint8_t frame_data[8], recv_data[8];
     size_t frame_length = 0, recv_length = 0;
-    yahdlc_control_t control_send, control_recv;
+    yahdlc_control_t control_send = {}, control_recv = {};
     yahdlc_state_t state;
 
     yahdlc_reset_state(&state, 1024);
@@ -40,7 +40,7 @@ void test_ConnAckFrameControlField() {
     int ret;
     uint8_t frame_data[8], recv_data[8];
     size_t frame_length = 0, recv_length = 0;
-    yahdlc_control_t control_send, control_recv;
+    yahdlc_control_t control_send = {}, control_recv = {};
     yahdlc_state_t state;
 
     yahdlc_reset_state(&state, 1024);